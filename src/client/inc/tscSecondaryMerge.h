@@ -27,6 +27,7 @@ extern "C" {
 #include "tsclient.h"
 
 #define MAX_NUM_OF_SUBQUERY_RETRY 3
+#define TSC_SUBQUERY_BUFFER_SIZE  (1 << 16)  // 64KB, buffer to sort the results of each sub query
 
 /*
  * @version 0.1
@@ -85,8 +86,10 @@ typedef struct SSubqueryState {
    */
   int32_t  numOfCompleted;
   int32_t  numOfTotal;          // number of total sub-queries
+  int32_t  numOfLaunched;       // number of sub-queries that are launched or skipped
   int32_t  code;                // code from subqueries
   uint64_t numOfRetrievedRows;  // total number of points in this query
+  int64_t  rowLimitOfVnode;     // the retrieval from a vnode stops once so many rows are received, -1 if no limit
 } SSubqueryState;
 
 typedef struct SRetrieveSupport {
@@ -25,6 +25,7 @@
 #include "tscJoinProcess.h"
 #include "tscSyntaxtreefunction.h"
 #include "tscompression.h"
+#include "tsimd.h"
 #include "tsqlfunction.h"
 #include "ttime.h"
 #include "ttypes.h"
@@ -375,13 +376,19 @@ static void count_function(SQLFunctionCtx *pCtx) {
      * 3. A cache block
      */
     if (pCtx->hasNull) {
-      for (int32_t i = 0; i < pCtx->size; ++i) {
-        char *val = GET_INPUT_CHAR_INDEX(pCtx, i);
-        if (isNull(val, pCtx->inputType)) {
-          continue;
-        }
+      numOfElem = taosCountNotNullBlock(GET_INPUT_CHAR(pCtx), pCtx->size, pCtx->inputType);
+
+      // binary/nchar columns are not supported by the block kernel
+      if (numOfElem < 0) {
+        numOfElem = 0;
+        for (int32_t i = 0; i < pCtx->size; ++i) {
+          char *val = GET_INPUT_CHAR_INDEX(pCtx, i);
+          if (isNull(val, pCtx->inputType)) {
+            continue;
+          }
 
-        numOfElem += 1;
+          numOfElem += 1;
+        }
       }
     } else {
       numOfElem = pCtx->size;
@@ -484,20 +491,31 @@ do {                                              \
   } while (0);
 
 
-#define LOOPCHECK_N(val, list, ctx, tsdbType, sign, num)          \
-  for (int32_t i = 0; i < ((ctx)->size); ++i) {                   \
-    if ((ctx)->hasNull && isNull((char *)&(list)[i], tsdbType)) { \
-      continue;                                                   \
-    }                                                             \
-    TSKEY key = (ctx)->ptsList[i];                                \
-    UPDATE_DATA(ctx, val, (list)[i], num, sign, key);             \
-  }
-
-#define TYPED_LOOPCHECK_N(type, data, list, ctx, tsdbType, sign, notNullElems) \
-  do {                                                                         \
-    type *_data = (type *)data;                                                \
-    type *_list = (type *)list;                                                \
-    LOOPCHECK_N(*_data, _list, ctx, tsdbType, sign, notNullElems);             \
+/*
+ * The min/max value of the block is found by the block kernel first. If the output is updated, the row
+ * that the row-wise comparison would stop at, i.e., the last one for min and the first one for max, is
+ * located to update the tags.
+ */
+#define TYPED_BLOCK_MINMAX(type, data, list, ctx, sign, notNullElems)                                \
+  do {                                                                                               \
+    type *_data = (type *)(data);                                                                    \
+    type *_list = (type *)(list);                                                                    \
+    type  _v = 0;                                                                                    \
+    if (sign) {                                                                                      \
+      (notNullElems) = taosMinBlock((char *)_list, (ctx)->size, (ctx)->inputType, &_v);              \
+    } else {                                                                                         \
+      (notNullElems) = taosMaxBlock((char *)_list, (ctx)->size, (ctx)->inputType, &_v);              \
+    }                                                                                                \
+    if ((notNullElems) > 0 && ((*_data < _v) ^ (sign))) {                                            \
+      *_data = _v;                                                                                   \
+      if ((ctx)->tagInfo.numOfTagCols > 0) {                                                         \
+        int32_t _i = (sign) ? (ctx)->size - 1 : 0;                                                   \
+        while (_list[_i] != _v) {                                                                    \
+          _i += (sign) ? -1 : 1;                                                                     \
+        }                                                                                            \
+        DO_UPDATE_TAG_COLUMNS(ctx, (ctx)->ptsList[_i]);                                              \
+      }                                                                                              \
+    }                                                                                                \
   } while (0)
 
 static void do_sum(SQLFunctionCtx *pCtx) {
@@ -516,27 +534,17 @@ static void do_sum(SQLFunctionCtx *pCtx) {
       *retVal += GET_DOUBLE_VAL(&(pCtx->preAggVals.sum));
     }
   } else {  // computing based on the true data block
-    void *pData = GET_INPUT_CHAR(pCtx);
+    char *pData = GET_INPUT_CHAR(pCtx);
     notNullElems = 0;
 
     if (pCtx->inputType >= TSDB_DATA_TYPE_TINYINT && pCtx->inputType <= TSDB_DATA_TYPE_BIGINT) {
-      int64_t *retVal = pCtx->aOutputBuf;
-
-      if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
-      }
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-      double *retVal = pCtx->aOutputBuf;
-      LIST_ADD_N(*retVal, pCtx, pData, double, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-      double *retVal = pCtx->aOutputBuf;
-      LIST_ADD_N(*retVal, pCtx, pData, float, notNullElems, pCtx->inputType);
+      int64_t sum = 0;
+      notNullElems = taosSumBlock(pData, pCtx->size, pCtx->inputType, &sum);
+      *(int64_t *)pCtx->aOutputBuf += sum;
+    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE || pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
+      double sum = 0;
+      notNullElems = taosSumBlock(pData, pCtx->size, pCtx->inputType, &sum);
+      *(double *)pCtx->aOutputBuf += sum;
     }
   }
 
@@ -744,20 +752,19 @@ static void avg_function(SQLFunctionCtx *pCtx) {
       *pVal += GET_DOUBLE_VAL(&(pCtx->preAggVals.sum));
     }
   } else {
-    void *pData = GET_INPUT_CHAR(pCtx);
+    char *pData = GET_INPUT_CHAR(pCtx);
 
-    if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+    if (pCtx->inputType >= TSDB_DATA_TYPE_TINYINT && pCtx->inputType <= TSDB_DATA_TYPE_INT) {
+      int64_t sum = 0;
+      notNullElems = taosSumBlock(pData, pCtx->size, pCtx->inputType, &sum);
+      *pVal += sum;
     } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
+      // bigint values are accumulated in double directly to avoid the overflow of int64_t
       LIST_ADD_N(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-      LIST_ADD_N(*pVal, pCtx, pData, double, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-      LIST_ADD_N(*pVal, pCtx, pData, float, notNullElems, pCtx->inputType);
+    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE || pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
+      double sum = 0;
+      notNullElems = taosSumBlock(pData, pCtx->size, pCtx->inputType, &sum);
+      *pVal += sum;
     }
   }
 
@@ -962,39 +969,21 @@ static void minMax_function(SQLFunctionCtx *pCtx, char *pOutput, int32_t isMin,
   void *p = GET_INPUT_CHAR(pCtx);
   *notNullElems = 0;
 
-  if (pCtx->inputType >= TSDB_DATA_TYPE_TINYINT && pCtx->inputType <= TSDB_DATA_TYPE_BIGINT) {
-    if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      TYPED_LOOPCHECK_N(int8_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      TYPED_LOOPCHECK_N(int16_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      int32_t *pData = p;
-      int32_t *retVal = pOutput;
-
-      for (int32_t i = 0; i < pCtx->size; ++i) {
-        if (pCtx->hasNull && isNull(&pData[i], pCtx->inputType)) {
-          continue;
-        }
-
-        if ((*retVal < pData[i]) ^ isMin) {
-          *retVal = pData[i];
-          TSKEY k = pCtx->ptsList[i];
-
-          DO_UPDATE_TAG_COLUMNS(pCtx, k);
-        }
-
-        *notNullElems += 1;
-      }
+  if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
+    TYPED_BLOCK_MINMAX(int8_t, pOutput, p, pCtx, isMin, *notNullElems);
+  } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
+    TYPED_BLOCK_MINMAX(int16_t, pOutput, p, pCtx, isMin, *notNullElems);
+  } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
+    TYPED_BLOCK_MINMAX(int32_t, pOutput, p, pCtx, isMin, *notNullElems);
 #if defined(_DEBUG_VIEW)
-      pTrace("max value updated:%d", *retVal);
+    pTrace("max value updated:%d", *(int32_t *)pOutput);
 #endif
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      TYPED_LOOPCHECK_N(int64_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    }
+  } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
+    TYPED_BLOCK_MINMAX(int64_t, pOutput, p, pCtx, isMin, *notNullElems);
   } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-    TYPED_LOOPCHECK_N(double, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+    TYPED_BLOCK_MINMAX(double, pOutput, p, pCtx, isMin, *notNullElems);
   } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-    TYPED_LOOPCHECK_N(float, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+    TYPED_BLOCK_MINMAX(float, pOutput, p, pCtx, isMin, *notNullElems);
   }
 }
 
@@ -1043,10 +1032,10 @@ static bool max_func_setup(SQLFunctionCtx *pCtx) {
       *((int32_t *)pCtx->aOutputBuf) = INT32_MIN;
       break;
     case TSDB_DATA_TYPE_FLOAT:
-      *((float *)pCtx->aOutputBuf) = -FLT_MIN;
+      *((float *)pCtx->aOutputBuf) = -FLT_MAX;
       break;
     case TSDB_DATA_TYPE_DOUBLE:
-      *((double *)pCtx->aOutputBuf) = -DBL_MIN;
+      *((double *)pCtx->aOutputBuf) = -DBL_MAX;
       break;
     case TSDB_DATA_TYPE_BIGINT:
       *((int64_t *)pCtx->aOutputBuf) = INT64_MIN;
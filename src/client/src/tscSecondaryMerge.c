@@ -210,7 +210,8 @@ void tscCreateLocalReducer(tExtMemBuffer **pMemBuffer, int32_t numOfBuffer, tOrd
       pDS->pageId = 0;
       pDS->rowIdx = 0;
 
-      tscTrace("%p load data from disk into memory, orderOfVnode:%d, total:%d", pSqlObjAddr, i + 1, idx + 1);
+      tscTrace("%p load data into merge source, orderOfVnode:%d, total:%d, in memory:%d", pSqlObjAddr, i + 1, idx + 1,
+               tExtMemBufferIsAllDataInMem(pMemBuffer[i]));
       tExtMemBufferLoadData(pMemBuffer[i], &(pDS->filePage), j, 0);
 #ifdef _DEBUG_VIEW
       printf("load data page into mem for build loser tree: %ld rows\n", pDS->filePage.numOfElems);
@@ -363,7 +364,8 @@ int32_t tscFlushTmpBuffer(tExtMemBuffer *pMemoryBuf, tOrderDescriptor *pDesc, tF
     return -1;
   }
 
-  if (!tExtMemBufferFlush(pMemoryBuf)) {
+  // the sorted data is closed as one source of the local merge, and flushed to disk only if the buffer is full
+  if (!tExtMemBufferSeal(pMemoryBuf)) {
     return -1;
   }
 
@@ -602,12 +604,21 @@ int32_t tscLocalReducerEnvCreate(SSqlObj *pSql, tExtMemBuffer ***pMemBuffer, tOr
   int32_t capacity = nBufferSizes / rlen;
   pModel = tColModelCreate(pSchema, pCmd->fieldsInfo.numOfOutputCols, capacity);
 
+  /*
+   * the sorted results of each vnode are kept in memory until the merge buffer is used up, and the tmp file is
+   * created only when the in-memory pages are spilled to disk
+   */
+  int64_t nMergeBufferSize = ((int64_t)tsMergeBufferSize << 20) / pMeterMetaInfo->pMetricMeta->numOfVnodes;
+  if (nMergeBufferSize < nBufferSizes) {
+    nMergeBufferSize = nBufferSizes;
+  }
+
   for (int32_t i = 0; i < pMeterMetaInfo->pMetricMeta->numOfVnodes; ++i) {
     char tmpPath[512] = {0};
     getTmpfilePath("tv_bf_db", tmpPath);
     tscTrace("%p create [%d](%d) tmp file for subquery:%s", pSql, pMeterMetaInfo->pMetricMeta->numOfVnodes, i, tmpPath);
 
-    tExtMemBufferCreate(&(*pMemBuffer)[i], nBufferSizes, rlen, tmpPath, pModel);
+    tExtMemBufferCreate(&(*pMemBuffer)[i], (int32_t)nMergeBufferSize, rlen, tmpPath, pModel);
     (*pMemBuffer)[i]->flushModel = MULTIPLE_APPEND_MODEL;
   }
 
@@ -873,6 +873,47 @@ static void doCleanupSubqueries(SSqlObj *pSql, int32_t vnodeIndex, int32_t numOf
   }
 }
 
+static SRetrieveSupport *tscCreateRetrieveSupport(SSqlObj *pSql, int32_t vnodeIdx, SSubqueryState *pState,
+                                                  tExtMemBuffer **pMemoryBuf, tOrderDescriptor *pDesc,
+                                                  tColModel *pModel) {
+  SRetrieveSupport *trs = (SRetrieveSupport *)calloc(1, sizeof(SRetrieveSupport));
+  trs->pExtMemBuffer = pMemoryBuf;
+  trs->pOrderDescriptor = pDesc;
+  trs->pState = pState;
+  trs->localBuffer = (tFilePage *)calloc(1, TSC_SUBQUERY_BUFFER_SIZE + sizeof(tFilePage));
+  trs->vnodeIdx = vnodeIdx;
+  trs->pParentSqlObj = pSql;
+  trs->pFinalColModel = pModel;
+
+  pthread_mutexattr_t mutexattr = {0};
+  pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE_NP);
+  pthread_mutex_init(&trs->queryMutex, &mutexattr);
+  pthread_mutexattr_destroy(&mutexattr);
+
+  return trs;
+}
+
+/*
+ * In the interval query on super table without group by and fill, each row from a vnode is a distinct time window
+ * in the order of the final results, so no more than (offset + limit) rows of each vnode can reach the final results.
+ */
+static int64_t tscGetRowLimitOfVnode(SSqlCmd *pCmd) {
+  if (pCmd->limit.limit <= 0 || pCmd->nAggTimeInterval == 0 || pCmd->groupbyExpr.numOfGroupCols > 0 ||
+      pCmd->interpoType != TSDB_INTERPO_NONE || pCmd->tsBuf != NULL) {
+    return -1;
+  }
+
+  // functions, like top/bottom, generate more than one row for a time window
+  for (int32_t i = 0; i < pCmd->exprsInfo.numOfExprs; ++i) {
+    SSqlExpr *pExpr = tscSqlExprGet(pCmd, i);
+    if ((aAggs[pExpr->functionId].nStatus & TSDB_FUNCSTATE_SO) == 0) {
+      return -1;
+    }
+  }
+
+  return pCmd->limit.limit + pCmd->limit.offset;
+}
+
 int tscLaunchMetricSubQueries(SSqlObj *pSql) {
   SSqlRes *pRes = &pSql->res;
 
@@ -888,12 +929,11 @@ int tscLaunchMetricSubQueries(SSqlObj *pSql) {
 
   pRes->qhandle = 1;  // hack the qhandle check
 
-  const uint32_t  nBufferSize = (1 << 16);  // 64KB
   SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(&pSql->cmd, 0);
   int32_t         numOfVnodes = pMeterMetaInfo->pMetricMeta->numOfVnodes;
   assert(numOfVnodes > 0);
 
-  int32_t ret = tscLocalReducerEnvCreate(pSql, &pMemoryBuf, &pDesc, &pModel, nBufferSize);
+  int32_t ret = tscLocalReducerEnvCreate(pSql, &pMemoryBuf, &pDesc, &pModel, TSC_SUBQUERY_BUFFER_SIZE);
   if (ret != 0) {
     pRes->code = TSDB_CODE_CLI_OUT_OF_MEMORY;
     if (pSql->fp) {
@@ -902,22 +942,30 @@ int tscLaunchMetricSubQueries(SSqlObj *pSql) {
     return pRes->code;
   }
 
-  pSql->pSubs = malloc(POINTER_BYTES * numOfVnodes);
+  pSql->pSubs = calloc(numOfVnodes, POINTER_BYTES);
   pSql->numOfSubs = numOfVnodes;
 
-  tscTrace("%p retrieved query data from %d vnode(s)", pSql, numOfVnodes);
+  /*
+   * at most tsMaxConcurrentSubqueries sub-queries are launched here, and the sub-query on the next vnode is launched
+   * once a sub-query is completed
+   */
+  int32_t numOfConcurrent = (numOfVnodes < tsMaxConcurrentSubqueries) ? numOfVnodes : tsMaxConcurrentSubqueries;
+
+  tscTrace("%p retrieved query data from %d vnode(s), concurrent:%d", pSql, numOfVnodes, numOfConcurrent);
   SSubqueryState *pState = calloc(1, sizeof(SSubqueryState));
   pState->numOfTotal = numOfVnodes;
+  pState->numOfLaunched = numOfConcurrent;
+  pState->rowLimitOfVnode = tscGetRowLimitOfVnode(&pSql->cmd);
   pRes->code = TSDB_CODE_SUCCESS;
 
-  for (int32_t i = 0; i < numOfVnodes; ++i) {
+  for (int32_t i = 0; i < numOfConcurrent; ++i) {
     if (pRes->code == TSDB_CODE_QUERY_CANCELLED || pRes->code == TSDB_CODE_CLI_OUT_OF_MEMORY) {
       /*
        * during launch sub queries, if the master query is cancelled. the remain is ignored and set the retrieveDoneRec
        * to the value of remaining not built sub-queries. So, the already issued sub queries can successfully free
-       * allocated resources.
+       * allocated resources. The vnodes beyond the concurrent ones are skipped by the completed sub queries.
        */
-      pState->numOfCompleted = (numOfVnodes - i);
+      pState->numOfCompleted = (numOfConcurrent - i);
       doCleanupSubqueries(pSql, i, numOfVnodes, NULL, pDesc, pModel, pMemoryBuf, pState);
 
       if (i == 0) {
@@ -927,24 +975,11 @@ int tscLaunchMetricSubQueries(SSqlObj *pSql) {
       break;
     }
 
-    SRetrieveSupport *trs = (SRetrieveSupport *)calloc(1, sizeof(SRetrieveSupport));
-    trs->pExtMemBuffer = pMemoryBuf;
-    trs->pOrderDescriptor = pDesc;
-    trs->pState = pState;
-    trs->localBuffer = (tFilePage *)calloc(1, nBufferSize + sizeof(tFilePage));
-    trs->vnodeIdx = i;
-    trs->pParentSqlObj = pSql;
-    trs->pFinalColModel = pModel;
-
-    pthread_mutexattr_t mutexattr = {0};
-    pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE_NP);
-    pthread_mutex_init(&trs->queryMutex, &mutexattr);
-    pthread_mutexattr_destroy(&mutexattr);
-
-    SSqlObj *pNew = tscCreateSqlObjForSubquery(pSql, trs, NULL);
+    SRetrieveSupport *trs = tscCreateRetrieveSupport(pSql, i, pState, pMemoryBuf, pDesc, pModel);
+    SSqlObj *         pNew = tscCreateSqlObjForSubquery(pSql, trs, NULL);
 
     if (pNew == NULL) {
-      pState->numOfCompleted = (numOfVnodes - i);
+      pState->numOfCompleted = (numOfConcurrent - i);
       doCleanupSubqueries(pSql, i, numOfVnodes, trs, pDesc, pModel, pMemoryBuf, pState);
 
       if (i == 0) {
@@ -981,6 +1016,51 @@ static void tscFreeSubSqlObj(SRetrieveSupport *trsupport, SSqlObj *pSql) {
   tfree(trsupport);
 }
 
+/*
+ * launch the sub-query on the next vnode when current sub-query is completed. If the super table query is cancelled
+ * or failed, the vnodes that are not launched yet are skipped, and the number of skipped vnodes is returned.
+ */
+static int32_t tscLaunchNextSubquery(SRetrieveSupport *trsupport) {
+  SSubqueryState *pState = trsupport->pState;
+  SSqlObj *       pPObj = trsupport->pParentSqlObj;
+
+  int32_t numOfSkipped = 0;
+  int32_t idx = 0;
+
+  while ((idx = atomic_fetch_add_32(&pState->numOfLaunched, 1)) < pState->numOfTotal) {
+    if (pState->code == TSDB_CODE_SUCCESS && pPObj->res.code == TSDB_CODE_SUCCESS) {
+      SRetrieveSupport *trs = tscCreateRetrieveSupport(pPObj, idx, pState, trsupport->pExtMemBuffer,
+                                                       trsupport->pOrderDescriptor, trsupport->pFinalColModel);
+
+      SSqlObj *pNew = tscCreateSqlObjForSubquery(pPObj, trs, NULL);
+      if (pNew != NULL) {
+        if (pPObj->cmd.tsBuf) {
+          pNew->cmd.tsBuf = tsBufClone(pPObj->cmd.tsBuf);
+        }
+
+        tscTrace("%p sub:%p launch subquery.orderOfSub:%d", pPObj, pNew, idx);
+        tscProcessSql(pNew);
+        return numOfSkipped;
+      }
+
+      tscError("%p failed to create subquery due to out of memory, orderOfSub:%d", pPObj, idx);
+      atomic_val_compare_exchange_32(&pState->code, TSDB_CODE_SUCCESS, -TSDB_CODE_CLI_OUT_OF_MEMORY);
+
+      tfree(trs->localBuffer);
+      pthread_mutex_destroy(&trs->queryMutex);
+      tfree(trs);
+    }
+
+    numOfSkipped += 1;
+  }
+
+  if (numOfSkipped > 0) {
+    tscTrace("%p %d subqueries are skipped, code:%d", pPObj, numOfSkipped, pState->code);
+  }
+
+  return numOfSkipped;
+}
+
 static void tscRetrieveFromVnodeCallBack(void *param, TAOS_RES *tres, int numOfRows);
 
 static void tscAbortFurtherRetryRetrieval(SRetrieveSupport *trsupport, TAOS_RES *tres, int32_t errCode) {
@@ -1064,7 +1144,8 @@ static void tscHandleSubRetrievalError(SRetrieveSupport *trsupport, SSqlObj *pSq
     }
   }
 
-  if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, 1) < trsupport->pState->numOfTotal) {
+  int32_t numOfCompleted = tscLaunchNextSubquery(trsupport) + 1;
+  if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, numOfCompleted) < trsupport->pState->numOfTotal) {
     return tscFreeSubSqlObj(trsupport, pSql);
   }
 
@@ -1151,80 +1232,96 @@ void tscRetrieveFromVnodeCallBack(void *param, TAOS_RES *tres, int numOfRows) {
                                pRes->numOfRows, pCmd->groupbyExpr.orderType);
     if (ret < 0) {
       // set no disk space error info, and abort retry
-      tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
-    } else {
+      return tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
+    }
+
+    /*
+     * the remaining rows of current vnode can not reach the final results, the retrieval is stopped, and the query in
+     * vnode is released when the sub query is freed
+     */
+    int32_t numOfRowsFromVnode = trsupport->pExtMemBuffer[idx]->numOfAllElems + trsupport->localBuffer->numOfElems;
+    if (trsupport->pState->rowLimitOfVnode < 0 || numOfRowsFromVnode < trsupport->pState->rowLimitOfVnode) {
       pthread_mutex_unlock(&trsupport->queryMutex);
       taos_fetch_rows_a(tres, tscRetrieveFromVnodeCallBack, param);
+      return;
     }
 
-  } else {  // all data has been retrieved to client
-    /* data in from current vnode is stored in cache and disk */
-    uint32_t numOfRowsFromVnode =
-        trsupport->pExtMemBuffer[pCmd->vnodeIdx]->numOfAllElems + trsupport->localBuffer->numOfElems;
-    tscTrace("%p sub:%p all data retrieved from ip:%u,vid:%d, numOfRows:%d, orderOfSub:%d", pPObj, pSql, pSvd->ip,
-             pSvd->vnode, numOfRowsFromVnode, idx);
+    tscTrace("%p sub:%p retrieved rows:%d reach the limit, abort further retrieval from vid:%d, orderOfSub:%d", pPObj,
+             pSql, numOfRowsFromVnode, pSvd->vnode, idx);
+  }
+
+  // all data has been retrieved to client, or no more data is required from current vnode
+  /* data in from current vnode is stored in cache and disk */
+  uint32_t numOfRowsFromVnode =
+      trsupport->pExtMemBuffer[pCmd->vnodeIdx]->numOfAllElems + trsupport->localBuffer->numOfElems;
+  tscTrace("%p sub:%p all data retrieved from ip:%u,vid:%d, numOfRows:%d, orderOfSub:%d", pPObj, pSql, pSvd->ip,
+           pSvd->vnode, numOfRowsFromVnode, idx);
 
-    tColModelCompact(pDesc->pSchema, trsupport->localBuffer, pDesc->pSchema->maxCapacity);
+  tColModelCompact(pDesc->pSchema, trsupport->localBuffer, pDesc->pSchema->maxCapacity);
 
 #ifdef _DEBUG_VIEW
-    printf("%ld rows data flushed to disk:\n", trsupport->localBuffer->numOfElems);
-    SSrcColumnInfo colInfo[256] = {0};
-    tscGetSrcColumnInfo(colInfo, &pPObj->cmd);
-    tColModelDisplayEx(pDesc->pSchema, trsupport->localBuffer->data, trsupport->localBuffer->numOfElems,
-                       trsupport->localBuffer->numOfElems, colInfo);
+  printf("%ld rows data flushed to disk:\n", trsupport->localBuffer->numOfElems);
+  SSrcColumnInfo colInfo[256] = {0};
+  tscGetSrcColumnInfo(colInfo, &pPObj->cmd);
+  tColModelDisplayEx(pDesc->pSchema, trsupport->localBuffer->data, trsupport->localBuffer->numOfElems,
+                     trsupport->localBuffer->numOfElems, colInfo);
 #endif
-    if (tsTotalTmpDirGB != 0 && tsAvailTmpDirGB < tsMinimalTmpDirGB) {
-      tscError("%p sub:%p client disk space remain %.3f GB, need at least %.3f GB, stop query", pPObj, pSql,
-               tsAvailTmpDirGB, tsMinimalTmpDirGB);
-      tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
-      return;
-    }
+  if (tsTotalTmpDirGB != 0 && tsAvailTmpDirGB < tsMinimalTmpDirGB) {
+    tscError("%p sub:%p client disk space remain %.3f GB, need at least %.3f GB, stop query", pPObj, pSql,
+             tsAvailTmpDirGB, tsMinimalTmpDirGB);
+    tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
+    return;
+  }
 
-    // each result for a vnode is ordered as an independant list,
-    // then used as an input of loser tree for disk-based merge routine
-    int32_t ret =
-        tscFlushTmpBuffer(trsupport->pExtMemBuffer[idx], pDesc, trsupport->localBuffer, pCmd->groupbyExpr.orderType);
-    if (ret != 0) {
-      /* set no disk space error info, and abort retry */
-      return tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
-    }
+  // each result for a vnode is ordered as an independant list,
+  // then used as an input of loser tree for merge routine, which is kept in memory unless the buffer is full
+  int32_t ret =
+      tscFlushTmpBuffer(trsupport->pExtMemBuffer[idx], pDesc, trsupport->localBuffer, pCmd->groupbyExpr.orderType);
+  if (ret != 0) {
+    /* set no disk space error info, and abort retry */
+    return tscAbortFurtherRetryRetrieval(trsupport, tres, TSDB_CODE_CLI_NO_DISKSPACE);
+  }
 
-    if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, 1) < trsupport->pState->numOfTotal) {
-      return tscFreeSubSqlObj(trsupport, pSql);
-    }
+  int32_t numOfCompleted = tscLaunchNextSubquery(trsupport) + 1;
+  if (atomic_add_fetch_32(&trsupport->pState->numOfCompleted, numOfCompleted) < trsupport->pState->numOfTotal) {
+    return tscFreeSubSqlObj(trsupport, pSql);
+  }
 
-    // all sub-queries are returned, start to local merge process
-    pDesc->pSchema->maxCapacity = trsupport->pExtMemBuffer[idx]->numOfElemsPerPage;
+  /*
+   * all sub-queries are returned, start to local merge process. The merge does not start before, since the order of
+   * rows returned by a vnode is not relied on: each page is sorted as a separate source, and a page that arrives
+   * later may hold rows preceding those of all pages merged so far.
+   */
+  pDesc->pSchema->maxCapacity = trsupport->pExtMemBuffer[idx]->numOfElemsPerPage;
 
-    tscTrace("%p retrieve from %d vnodes completed.final NumOfRows:%d,start to build loser tree", pPObj,
-             trsupport->pState->numOfTotal, trsupport->pState->numOfCompleted);
+  tscTrace("%p retrieve from %d vnodes completed.final NumOfRows:%d,start to build loser tree", pPObj,
+           trsupport->pState->numOfTotal, trsupport->pState->numOfCompleted);
 
-    tscClearInterpInfo(&pPObj->cmd);
-    tscCreateLocalReducer(trsupport->pExtMemBuffer, trsupport->pState->numOfTotal, pDesc, trsupport->pFinalColModel,
-                          &pPObj->cmd, &pPObj->res);
-    tscTrace("%p build loser tree completed", pPObj);
+  tscClearInterpInfo(&pPObj->cmd);
+  tscCreateLocalReducer(trsupport->pExtMemBuffer, trsupport->pState->numOfTotal, pDesc, trsupport->pFinalColModel,
+                        &pPObj->cmd, &pPObj->res);
+  tscTrace("%p build loser tree completed", pPObj);
 
-    pPObj->res.precision = pSql->res.precision;
-    pPObj->res.numOfRows = 0;
-    pPObj->res.row = 0;
+  pPObj->res.precision = pSql->res.precision;
+  pPObj->res.numOfRows = 0;
+  pPObj->res.row = 0;
 
-    // only free once
-    free(trsupport->pState);
-    tscFreeSubSqlObj(trsupport, pSql);
+  // only free once
+  free(trsupport->pState);
+  tscFreeSubSqlObj(trsupport, pSql);
 
-    if (pPObj->fp == NULL) {
-      tsem_wait(&pPObj->emptyRspSem);
-      tsem_wait(&pPObj->emptyRspSem);
+  if (pPObj->fp == NULL) {
+    tsem_wait(&pPObj->emptyRspSem);
+    tsem_wait(&pPObj->emptyRspSem);
 
-      tsem_post(&pPObj->rspSem);
+    tsem_post(&pPObj->rspSem);
+  } else {
+    // set the command flag must be after the semaphore been correctly set.
+    pPObj->cmd.command = TSDB_SQL_RETRIEVE_METRIC;
+    if (pPObj->res.code == TSDB_CODE_SUCCESS) {
+      (*pPObj->fp)(pPObj->param, pPObj, 0);
     } else {
-      // set the command flag must be after the semaphore been correctly set.
-      pPObj->cmd.command = TSDB_SQL_RETRIEVE_METRIC;
-      if (pPObj->res.code == TSDB_CODE_SUCCESS) {
-        (*pPObj->fp)(pPObj->param, pPObj, 0);
-      } else {
-        tscQueueAsyncRes(pPObj);
-      }
+      tscQueueAsyncRes(pPObj);
     }
   }
 }
@@ -1367,7 +1464,8 @@ int tscBuildRetrieveMsg(SSqlObj *pSql) {
   *((uint64_t *)pMsg) = pSql->res.qhandle;
   pMsg += sizeof(pSql->res.qhandle);
 
-  *((uint16_t*)pMsg) = htons(pSql->cmd.type);
+  // the old vnode ignores the flag, and compresses the results by LZ4
+  *((uint16_t*)pMsg) = htons(pSql->cmd.type | TSDB_QUERY_TYPE_COMP_COLUMN);
   pMsg += sizeof(pSql->cmd.type);
 
   msgLen = pMsg - pStart;
@@ -3441,8 +3539,105 @@ int tscProcessQueryRsp(SSqlObj *pSql) {
   return 0;
 }
 
+static int (*tscDecompFunc[])(const char *const input, int compressedSize, const int elements, char *const output,
+                              int outputSize, char algorithm, char *const buffer, int bufferSize) = {
+    NULL,
+    tsDecompressBool,
+    tsDecompressTinyint,
+    tsDecompressSmallint,
+    tsDecompressInt,
+    tsDecompressBigint,
+    tsDecompressFloat,
+    tsDecompressDouble,
+    tsDecompressString,
+    tsDecompressTimestamp,
+    tsDecompressString};
+
+/*
+ * decompress the columns which are compressed separately by vnode, the size of decompressed data is returned,
+ * or -1 if the payload is broken. The headers are all checked against the payload size before anything is
+ * decompressed.
+ */
+static int32_t doDecompressColumns(char *payload, int32_t payloadSize, int32_t numOfRows, char **output) {
+  int64_t rawSize = 0;
+  int32_t maxBytes = 0;
+
+  for (int32_t offset = 0; offset < payloadSize;) {
+    if (payloadSize - offset < (int32_t)sizeof(SRetrieveColHeader)) return -1;
+
+    SRetrieveColHeader *pHeader = (SRetrieveColHeader *)(payload + offset);
+    int32_t             bytes = (int16_t)htons(pHeader->bytes);
+    int32_t             compLen = (int32_t)htonl(pHeader->compLen);
+
+    offset += sizeof(SRetrieveColHeader);
+    if (bytes <= 0 || compLen <= 0 || compLen > payloadSize - offset) return -1;
+
+    rawSize += (int64_t)bytes * numOfRows;
+    if (rawSize > INT32_MAX - 2) return -1;
+
+    maxBytes = MAX(maxBytes, bytes);
+    offset += compLen;
+  }
+
+  int32_t bufferSize = maxBytes * numOfRows + 2;
+  char *  buffer = malloc((size_t)bufferSize);
+  char *  data = malloc((size_t)rawSize);
+  if (buffer == NULL || data == NULL) {
+    tfree(buffer);
+    tfree(data);
+    return -1;
+  }
+
+  char *d = data;
+  for (char *p = payload; p < payload + payloadSize;) {
+    SRetrieveColHeader *pHeader = (SRetrieveColHeader *)p;
+    int32_t             bytes = (int16_t)htons(pHeader->bytes);
+    int32_t             compLen = (int32_t)htonl(pHeader->compLen);
+
+    p += sizeof(SRetrieveColHeader);
+
+    int32_t len = 0;
+    if (pHeader->type >= TSDB_DATA_TYPE_BOOL && pHeader->type <= TSDB_DATA_TYPE_NCHAR) {
+      len = (*tscDecompFunc[pHeader->type])(p, compLen, numOfRows, d, bytes * numOfRows, TWO_STAGE_COMP, buffer,
+                                            bufferSize);
+    } else {
+      len = tsDecompressString(p, compLen, numOfRows, d, bytes * numOfRows, TWO_STAGE_COMP, buffer, bufferSize);
+    }
+
+    if (len != bytes * numOfRows) {
+      free(buffer);
+      free(data);
+      return -1;
+    }
+
+    p += compLen;
+    d += len;
+  }
+
+  free(buffer);
+  *output = data;
+  return (int32_t)rawSize;
+}
+
 static void doDecompressPayload(SSqlCmd *pCmd, SSqlRes *pRes, int16_t compressed) {
-  if (compressed && pRes->numOfRows > 0) {
+  if (compressed == TSDB_RSP_COMPRESS_COLUMN && pRes->numOfRows > 0) {
+    int32_t payloadSize = pRes->rspLen - 1 - sizeof(SRetrieveMeterRsp);
+    char *  buf = NULL;
+
+    int32_t decompressedSize =
+        doDecompressColumns(((SRetrieveMeterRsp *)pRes->pRsp)->data, payloadSize, pRes->numOfRows, &buf);
+    if (decompressedSize < 0) {
+      tscError("failed to decompress retrieve rsp, payload size:%d rows:%d", payloadSize, pRes->numOfRows);
+      pRes->code = TSDB_CODE_APP_ERROR;
+      pRes->numOfRows = 0;
+    } else {
+      tscTrace("decompress retrieve rsp, payload size:%d, after:%d", payloadSize, decompressedSize);
+
+      pRes->pRsp = realloc(pRes->pRsp, pRes->rspLen - payloadSize + decompressedSize);
+      memcpy(pRes->pRsp + sizeof(SRetrieveMeterRsp), buf, decompressedSize);
+      free(buf);
+    }
+  } else if (compressed && pRes->numOfRows > 0) {
     SRetrieveMeterRsp *pRetrieve = (SRetrieveMeterRsp *)pRes->pRsp;
 
     int32_t numOfTotalCols = pCmd->fieldsInfo.numOfOutputCols + pCmd->fieldsInfo.numOfHiddenCols;
@@ -19,11 +19,18 @@
 #include "taos.h"
 #include "tlog.h"
 #include "trpc.h"
+#include "tscUtil.h"
 #include "tsclient.h"
 #include "tsocket.h"
+#include "tsql.h"
 #include "ttime.h"
 #include "tutil.h"
 
+/*
+ * the subscription query is parsed only once, and each poll launches it again with the start time set to
+ * the last key consumed, as the stream computing does, so no sql parsing is required for each poll.
+ * Delivery is poll based, the vnode does not push rows: new rows reach the subscriber within mseconds.
+ */
 typedef struct {
   void *     signature;
   char       name[TSDB_METER_ID_LEN];
@@ -33,9 +40,83 @@ typedef struct {
   TAOS_FIELD fields[TSDB_MAX_COLUMNS];
   int        numOfFields;
   TAOS *     taos;
-  TAOS_RES * result;
+  SSqlObj *  pSql;
+  bool       launched;  // the query is launched, and results are not all consumed yet
 } SSub;
 
+static SSqlObj *tscCreateSubscribeSqlObj(STscObj *pObj, const char *sqlstr) {
+  SSqlObj *pSql = (SSqlObj *)calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) return NULL;
+
+  pSql->signature = pSql;
+  pSql->pTscObj = pObj;
+  tsem_init(&pSql->rspSem, 0, 0);
+  tsem_init(&pSql->emptyRspSem, 0, 1);
+
+  pSql->sqlstr = strdup(sqlstr);
+  if (pSql->sqlstr == NULL || tscAllocPayload(&pSql->cmd, TSDB_DEFAULT_PAYLOAD_SIZE) != TSDB_CODE_SUCCESS) {
+    tscFreeSqlObj(pSql);
+    return NULL;
+  }
+
+  SSqlInfo SQLInfo = {0};
+  tSQLParse(&SQLInfo, pSql->sqlstr);
+
+  pSql->res.code = tscToSQLCmd(pSql, &SQLInfo);
+  SQLInfoDestroy(&SQLInfo);
+
+  if (pSql->res.code != TSDB_CODE_SUCCESS) {
+    tscError("%p failed to parse subscribe sql:%s, reason:%s", pSql, sqlstr, pSql->cmd.payload);
+    tscFreeSqlObj(pSql);
+    return NULL;
+  }
+
+  return pSql;
+}
+
+static int32_t tscLaunchSubscribeQuery(SSub *pSub) {
+  SSqlObj *       pSql = pSub->pSql;
+  SSqlCmd *       pCmd = &pSql->cmd;
+  SSqlRes *       pRes = &pSql->res;
+  SMeterMetaInfo *pMeterMetaInfo = tscGetMeterMetaInfo(pCmd, 0);
+
+  // the meta is retrieved from local cache in most cases
+  pRes->code = tscGetMeterMeta(pSql, pMeterMetaInfo->name, 0);
+  if (pRes->code == TSDB_CODE_SUCCESS && UTIL_METER_IS_METRIC(pMeterMetaInfo)) {
+    pRes->code = tscGetMetricMeta(pSql);
+  }
+
+  if (pRes->code != TSDB_CODE_SUCCESS) {
+    return pRes->code;
+  }
+
+  tscTansformSQLFunctionForMetricQuery(pCmd);
+
+  pCmd->stime = pSub->lastKey + 1;
+  pCmd->command = TSDB_SQL_SELECT;
+  pCmd->vnodeIdx = 0;
+
+  if (UTIL_METER_IS_METRIC(pMeterMetaInfo)) {
+    pCmd->limit.limit = pCmd->globalLimit;
+    pCmd->limit.offset = 0;
+
+    if (pMeterMetaInfo->pMetricMeta->numOfMeters == 0) {
+      pCmd->command = TSDB_SQL_RETRIEVE_EMPTY_RESULT;
+    }
+  }
+
+  pRes->qhandle = 0;
+  pRes->numOfTotal = 0;
+  pSql->thandle = NULL;
+  tscResetForNextRetrieve(pRes);
+
+  if (pCmd->command == TSDB_SQL_SELECT) {
+    tscProcessSql(pSql);
+  }
+
+  return pRes->code;
+}
+
 TAOS_SUB *taos_subscribe(const char *host, const char *user, const char *pass, const char *db, const char *name, int64_t time, int mseconds) {
   SSub *pSub;
 
@@ -56,7 +137,7 @@ TAOS_SUB *taos_subscribe(const char *host, const char *user, const char *pass, c
   if (pSub->taos == NULL) {
     tfree(pSub);
   } else {
-    char qstr[128];
+    char qstr[256];
     sprintf(qstr, "use %s", db);
     int res = taos_query(pSub->taos, qstr);
     if (res != 0) {
@@ -64,16 +145,17 @@ TAOS_SUB *taos_subscribe(const char *host, const char *user, const char *pass, c
       taos_close(pSub->taos);
       tfree(pSub);
     } else {
-      sprintf(qstr, "select * from %s where _c0 > now+1000d", pSub->name);
-      if (taos_query(pSub->taos, qstr)) {
-        tscTrace("failed to select, reason:%s", taos_errstr(pSub->taos));
+      sprintf(qstr, "select * from %s order by _c0 asc", pSub->name);
+      pSub->pSql = tscCreateSubscribeSqlObj((STscObj *)pSub->taos, qstr);
+      if (pSub->pSql == NULL) {
+        tscError("failed to subscribe:%s", pSub->name);
         taos_close(pSub->taos);
         tfree(pSub);
         return NULL;
       }
-      pSub->result = taos_use_result(pSub->taos);
-      pSub->numOfFields = taos_num_fields(pSub->result);
-      memcpy(pSub->fields, taos_fetch_fields(pSub->result), sizeof(TAOS_FIELD) * pSub->numOfFields);
+
+      pSub->numOfFields = taos_num_fields(pSub->pSql);
+      memcpy(pSub->fields, taos_fetch_fields(pSub->pSql), sizeof(TAOS_FIELD) * pSub->numOfFields);
     }
   }
 
@@ -83,21 +165,22 @@ TAOS_SUB *taos_subscribe(const char *host, const char *user, const char *pass, c
 TAOS_ROW taos_consume(TAOS_SUB *tsub) {
   SSub *   pSub = (SSub *)tsub;
   TAOS_ROW row;
-  char     qstr[256];
 
   if (pSub == NULL) return NULL;
   if (pSub->signature != pSub) return NULL;
 
   while (1) {
-    if (pSub->result != NULL) {
-      row = taos_fetch_row(pSub->result);
+    if (pSub->launched) {
+      row = taos_fetch_row(pSub->pSql);
       if (row != NULL) {
         pSub->lastKey = *((uint64_t *)row[0]);
         return row;
       }
 
-      taos_free_result(pSub->result);
-      pSub->result = NULL;
+      // release the meta reference, so the meta in cache can be updated
+      tscClearMeterMetaInfo(tscGetMeterMetaInfo(&pSub->pSql->cmd, 0), false);
+      pSub->launched = false;
+
       uint64_t etime = taosGetTimestampMs();
       int64_t  mseconds = pSub->mseconds - etime + pSub->stime;
       if (mseconds < 0) mseconds = 0;
@@ -106,18 +189,12 @@ TAOS_ROW taos_consume(TAOS_SUB *tsub) {
 
     pSub->stime = taosGetTimestampMs();
 
-    sprintf(qstr, "select * from %s where _c0 > %lld order by _c0 asc", pSub->name, pSub->lastKey);
-    if (taos_query(pSub->taos, qstr)) {
-      tscTrace("failed to select, reason:%s", taos_errstr(pSub->taos));
+    if (tscLaunchSubscribeQuery(pSub) != TSDB_CODE_SUCCESS) {
+      tscTrace("%p failed to select, reason:%s", pSub->pSql, tsError[pSub->pSql->res.code]);
       return NULL;
     }
 
-    pSub->result = taos_use_result(pSub->taos);
-
-    if (pSub->result == NULL) {
-      tscTrace("failed to get result, reason:%s", taos_errstr(pSub->taos));
-      return NULL;
-    }
+    pSub->launched = true;
   }
 
   return NULL;
@@ -129,6 +206,10 @@ void taos_unsubscribe(TAOS_SUB *tsub) {
   if (pSub == NULL) return;
   if (pSub->signature != pSub) return;
 
+  // notify the vnode to release the query if the results are not all retrieved
+  taos_free_result(pSub->pSql);
+  tscFreeSqlObj(pSub->pSql);
+
   taos_close(pSub->taos);
   free(pSub);
 }
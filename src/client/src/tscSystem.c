@@ -19,6 +19,7 @@
 #include "tlog.h"
 #include "trpc.h"
 #include "tsdb.h"
+#include "tsimd.h"
 #include "tsocket.h"
 #include "tsystem.h"
 #include "ttime.h"
@@ -60,6 +61,7 @@ void taos_init_imp() {
   SRpcInit    rpcInit;
 
   srand(taosGetTimestampSec());
+  taosResolveSIMD();
 
   if (tscEmbedded == 0) {
     /*
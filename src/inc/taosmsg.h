@@ -573,6 +573,17 @@ typedef struct {
   char    data[];
 } SRetrieveMeterRsp;
 
+// value of compress in SRetrieveMeterRsp
+#define TSDB_RSP_COMPRESS_NONE   0
+#define TSDB_RSP_COMPRESS_LZ4    1  // the whole payload is compressed by LZ4
+#define TSDB_RSP_COMPRESS_COLUMN 2  // each column is compressed by the codec of its type, following SRetrieveColHeader
+
+typedef struct {
+  int8_t  type;
+  int16_t bytes;
+  int32_t compLen;  // length of the compressed column data following the header
+} SRetrieveColHeader;
+
 typedef struct {
   uint32_t vnode;
   uint32_t vgId;
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TCLOCKCACHE_H
+#define TDENGINE_TCLOCKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * cache of variable sized payloads with fixed sized keys, bounded by the total size of the entries. The cache is
+ * split into stripes, each of which is protected by its own lock, and the entries of a stripe are evicted with the
+ * CLOCK algorithm: an entry is inserted without the referenced bit, which is set when it is hit again, so entries
+ * only read once are evicted before those read repeatedly.
+ * A key identifies the position of an entry, e.g., a block in file, and the caller checks if the cached payload
+ * is still valid for its key when the entry is looked up.
+ */
+
+// the results of the callback of taosGetFromClockCache
+#define TAOS_CLOCK_CACHE_HIT  0  // the payload is used, and the entry is referenced
+#define TAOS_CLOCK_CACHE_MISS 1  // the payload is not used, the entry is kept
+#define TAOS_CLOCK_CACHE_DROP 2  // the payload is out of date, the entry is dropped
+
+/**
+ * @param size          the total size of the entries, including the keys and the overhead of each entry
+ * @param numOfBuckets  hash buckets of each stripe
+ * @param keySize       size of the key, the key is copied into the entry
+ * @param hashFp        hash of the key
+ * @param equalFp       true if the two keys identify the same entry
+ * @return              the cache object, or NULL if out of memory
+ */
+void *taosInitClockCache(int64_t size, int32_t numOfBuckets, int32_t keySize, uint32_t (*hashFp)(const void *key),
+                         bool (*equalFp)(const void *key1, const void *key2));
+
+void taosCleanUpClockCache(void *handle);
+
+/**
+ * look up the entry of the key, fp is called with the stripe locked to check the cached key and copy out the payload
+ * @return  the result of fp, or TAOS_CLOCK_CACHE_MISS if the entry is not in cache
+ */
+int32_t taosGetFromClockCache(void *handle, const void *key,
+                              int32_t (*fp)(const void *cachedKey, const char *data, int32_t size, void *param),
+                              void *param);
+
+/**
+ * copy the payload into cache, the cached entry of the same key is replaced if replaceFp is NULL or returns true.
+ * A payload larger than 1/8 of a stripe is not cached.
+ */
+void taosPutIntoClockCache(void *handle, const void *key, const char *data, int32_t size,
+                           bool (*replaceFp)(const void *cachedKey, const void *key));
+
+/**
+ * drop the entries whose keys make fp return true
+ */
+void taosRemoveFromClockCache(void *handle, bool (*fp)(const void *cachedKey, void *param), void *param);
+
+/**
+ * get the number of hit, miss and evicted entries since the last call
+ */
+void taosGetClockCacheStatis(void *handle, int32_t *hits, int32_t *misses, int32_t *evictions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TCLOCKCACHE_H
@@ -109,9 +109,11 @@ typedef struct tExtMemBuffer {
   int32_t numOfElemsInBuffer;
   int32_t numOfElemsPerPage;
 
-  int16_t         numOfPagesInMem;
-  tFilePagesItem *pHead;
-  tFilePagesItem *pTail;
+  int32_t          numOfPagesInMem;
+  tFilePagesItem * pHead;
+  tFilePagesItem * pTail;
+  tFilePagesItem **pPagesInMem;  // index of the in-memory pages, in the same order of the page list
+  int32_t          nAllocPagesInMem;
 
   tFileMeta fileMeta;
 
@@ -143,13 +145,19 @@ void tExtMemBufferDestroy(tExtMemBuffer **pMemBuffer);
  * @param pModel     column format model
  * @return           number of pages in memory
  */
-int16_t tExtMemBufferPut(tExtMemBuffer *pMemBuffer, void *data, int32_t numOfRows);
+int32_t tExtMemBufferPut(tExtMemBuffer *pMemBuffer, void *data, int32_t numOfRows);
 
 /*
  * flush all data into disk and release all in-memory buffer
  */
 bool tExtMemBufferFlush(tExtMemBuffer *pMemBuffer);
 
+/*
+ * close the data put since the last flush or seal as one flush out record in MULTIPLE_APPEND_MODEL, without
+ * writing it to disk. The data is kept in memory until the in-memory buffer is full.
+ */
+bool tExtMemBufferSeal(tExtMemBuffer *pMemBuffer);
+
 /*
  * remove all data that has been put into buffer, including in buffer or
  * ext-buffer(disk)
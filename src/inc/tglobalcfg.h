@@ -73,6 +73,13 @@ extern int tsMetricMetaKeepTimer;
 
 extern float tsNumOfThreadsPerCore;
 extern float tsRatioOfQueryThreads;
+extern int   tsQueryParallelism;
+extern int   tsMergeBufferSize;
+extern int   tsMaxConcurrentSubqueries;
+extern int   tsBlockCacheSize;
+extern int   tsCompBlockCacheSize;
+extern int   tsNumOfPrefetchBlocks;
+extern int   tsNumOfStartupThreads;
 extern char  tsPublicIp[];
 extern char  tsInternalIp[];
 extern char  tsPrivateIp[];
@@ -92,6 +99,9 @@ extern float tsFileBlockMinPercent;
 extern short tsNumOfBlocksPerMeter;
 extern short tsCommitTime;  // seconds
 extern short tsCommitLog;
+extern int   tsCommitLogSyncTime;   // ms
+extern int   tsCommitLogSyncBytes;
+extern int   tsNumOfCommitThreads;
 extern short tsAsyncLog;
 extern short tsCompression;
 extern short tsDaysPerFile;
@@ -251,7 +261,7 @@ extern int            tsGlobalConfigNum;
 extern char *         tsCfgStatusStr[];
 SGlobalConfig *tsGetConfigOption(const char *option);
 
-#define TSDB_CFG_MAX_NUM    110
+#define TSDB_CFG_MAX_NUM    128
 #define TSDB_CFG_PRINT_LEN  23
 #define TSDB_CFG_OPTION_LEN 24
 #define TSDB_CFG_VALUE_LEN  41
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TRCU_H
+#define TDENGINE_TRCU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Read-copy-update for lock free readers of linked structures. Readers enter a read section without blocking,
+ * writers unlink the nodes under their own locks and retire them, and a retired node is freed only after all
+ * read sections that may still see it are over.
+ */
+#define TAOS_RCU_RETIRE_BATCH 64  // retired nodes are freed in batches, so readers are waited for once per batch
+
+void *taosInitRcu(void (*freeFp)(void *param, void *p), void *param);
+
+int32_t taosRcuReadLock(void *handle);
+
+void taosRcuReadUnlock(void *handle, int32_t token);
+
+void taosRcuRetire(void *handle, void *p);
+
+void taosRcuSynchronize(void *handle);
+
+void taosCleanUpRcu(void *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TRCU_H
@@ -97,6 +97,12 @@ void taosStopRpcConn(void *thandle);
 
 int taosSendMsgToPeerH(void *thandle, char *pCont, int contLen, void *ahandle);
 
+/*
+ * send a response of which the body is kept in separate buffers, the body is written to TCP socket directly,
+ * and copied into the message in other cases. pCont is built by taosBuildRspMsgWithSize, and is freed.
+ */
+int taosSendMsgToPeerV(void *thandle, char *pCont, int contLen, struct iovec *pBody, int numOfBody);
+
 char *taosBuildReqHeader(void *param, char type, char *msg);
 
 char *taosBuildReqMsgWithSize(void *, char type, int size);
@@ -30,8 +30,13 @@ typedef struct _sched_msg {
   void *thandle;
 } SSchedMsg;
 
+#define TAOS_SCHED_TYPE_MUTEX     0  // ring protected by mutex and semaphores
+#define TAOS_SCHED_TYPE_LOCK_FREE 1  // lock free MPMC ring, idle threads are parked on futex
+
 void *taosInitScheduler(int queueSize, int numOfThreads, const char *label);
 
+void *taosInitSchedulerWithType(int queueSize, int numOfThreads, const char *label, int type);
+
 int taosScheduleTask(void *qhandle, SSchedMsg *pMsg);
 
 void taosCleanUpScheduler(void *param);
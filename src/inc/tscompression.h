@@ -31,6 +31,7 @@ extern "C" {
 #define NO_COMPRESSION 0
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
+#define BIT_LEVEL_COMP 3  // bit-level codecs for timestamp and numeric types, one stage compression for bool
 
 int tsCompressTinyint(const char* const input, int inputSize, const int nelements, char* const output, int outputSize, char algorithm,
                       char* const buffer, int bufferSize);
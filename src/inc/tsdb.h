@@ -168,6 +168,7 @@ enum _vgroup_status {
 #define TSDB_PAYLOAD_SIZE         (TSDB_DEFAULT_PKT_SIZE - 100)
 #define TSDB_DEFAULT_PAYLOAD_SIZE 1024   // default payload size
 #define TSDB_EXTRA_PAYLOAD_SIZE   128    // extra bytes for auth
+#define TSDB_MAX_RPC_MSG_LEN      (16 * 1024 * 1024)  // a longer message from a peer is rejected
 #define TSDB_SQLCMD_SIZE          1024
 #define TSDB_MAX_VNODES           256
 #define TSDB_MIN_VNODES           50
@@ -194,7 +195,7 @@ enum _vgroup_status {
 #define TSDB_DATA_DEFAULT_RESERVE_DAY   3650     // ten years
 
 #define TSDB_MIN_COMPRESSION_LEVEL      0
-#define TSDB_MAX_COMPRESSION_LEVEL      2
+#define TSDB_MAX_COMPRESSION_LEVEL      3
 
 #define TSDB_MIN_CACHE_BLOCKS_PER_METER 32
 #define TSDB_MAX_CACHE_BLOCKS_PER_METER 40960
@@ -254,6 +255,9 @@ enum _vgroup_status {
 #define TSDB_QUERY_TYPE_PROJECTION_QUERY               0x40U    // select *,columns... query
 #define TSDB_QUERY_TYPE_JOIN_SEC_STAGE                 0x80U    // join sub query at the second stage
 
+// set in the retrieve msg only, the client accepts the results compressed column by column
+#define TSDB_QUERY_TYPE_COMP_COLUMN                    0x8000U
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TSIMD_H
+#define TDENGINE_TSIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Aggregate kernels on a block of column data of numeric types, from tinyint to double.
+ * The null value of each type is skipped, and the number of not null elements is returned.
+ */
+
+/**
+ * @param sum  int64_t for tinyint/smallint/int/bigint, double for float/double
+ */
+int32_t taosSumBlock(const char *data, int32_t numOfElems, int32_t type, void *sum);
+
+/**
+ * @param min  the minimum value in the type of input data, not set if all data are null
+ */
+int32_t taosMinBlock(const char *data, int32_t numOfElems, int32_t type, void *min);
+
+int32_t taosMaxBlock(const char *data, int32_t numOfElems, int32_t type, void *max);
+
+/**
+ * bool and timestamp columns are supported as well, -1 is returned for other types
+ */
+int32_t taosCountNotNullBlock(const char *data, int32_t numOfElems, int32_t type);
+
+/**
+ * unpack numOfElems values of width bits, which are packed one after another from the least significant
+ * bit of each byte. Only the (numOfElems * width + 7) / 8 bytes of packed data are read.
+ */
+void taosBitUnpack64(const char *input, int32_t width, int32_t numOfElems, uint64_t *output);
+
+/**
+ * choose the AVX2 kernels if supported by current CPU, otherwise the scalar version is used
+ */
+void taosResolveSIMD();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TSIMD_H
@@ -24,6 +24,7 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
+#include "os.h"
 
 int taosNonblockwrite(int fd, char *ptr, int nbytes);
 
@@ -31,6 +32,11 @@ int taosReadn(int sock, char *buffer, int len);
 
 int taosWriteMsg(int fd, void *ptr, int nbytes);
 
+/*
+ * write the buffers described by iov in one call, the array of iov is modified in case of partial write
+ */
+int taosWriteMsgV(int fd, struct iovec *iov, int iovcnt);
+
 int taosReadMsg(int fd, void *ptr, int nbytes);
 
 int taosOpenUdpSocket(char *ip, uint16_t port);
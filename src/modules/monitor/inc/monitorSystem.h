@@ -27,8 +27,14 @@ typedef struct {
   int selectReqNum;
   int insertReqNum;
   int httpReqNum;
+  int blockCacheHits;
+  int blockCacheMisses;
+  int blockCacheEvictions;
 } SCountInfo;
 
 extern void (*monitorCountReqFp)(SCountInfo *info);
 
+// describe the time spent on startup of the dnode, it is saved into the log table once
+extern void (*monitorStartupInfoFp)(char *content, int len);
+
 #endif
\ No newline at end of file
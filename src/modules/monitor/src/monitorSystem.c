@@ -35,7 +35,9 @@ typedef enum {
   MONITOR_CMD_CREATE_TB_LOG,
   MONITOR_CMD_CREATE_MT_DN,
   MONITOR_CMD_CREATE_MT_ACCT,
+  MONITOR_CMD_CREATE_MT_BCACHE,
   MONITOR_CMD_CREATE_TB_DN,
+  MONITOR_CMD_CREATE_TB_BCACHE,
   MONITOR_CMD_CREATE_TB_ACCT_ROOT,
   MONITOR_CMD_CREATE_TB_SLOWQUERY,
   MONITOR_CMD_MAX
@@ -77,6 +79,7 @@ void monitorSaveAcctLog(char *acctId, int64_t currentPointsPerSecond, int64_t ma
                         int64_t totalUsers, int64_t maxUsers, int64_t totalStreams, int64_t maxStreams,
                         int64_t totalConns, int64_t maxConns, int8_t accessState);
 void (*monitorCountReqFp)(SCountInfo *info) = NULL;
+void (*monitorStartupInfoFp)(char *content, int len) = NULL;
 void monitorExecuteSQL(char *sql);
 
 void monitorCheckDiskUsage(void *para, void *unused) {
@@ -171,6 +174,19 @@ void dnodeBuildMonitorSql(char *sql, int cmd) {
              monitor->privateIpStr, tsMonitorDbName, tsPrivateIp);
 #else
              monitor->privateIpStr, tsMonitorDbName, tsInternalIp);
+#endif
+  } else if (cmd == MONITOR_CMD_CREATE_MT_BCACHE) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.bcache(ts timestamp"
+             ", hit int, miss int, evict int"
+             ") tags (ipaddr binary(%d))",
+             tsMonitorDbName, IP_LEN_STR + 1);
+  } else if (cmd == MONITOR_CMD_CREATE_TB_BCACHE) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.bcache_%s using %s.bcache tags('%s')", tsMonitorDbName,
+#ifdef CLUSTER
+             monitor->privateIpStr, tsMonitorDbName, tsPrivateIp);
+#else
+             monitor->privateIpStr, tsMonitorDbName, tsInternalIp);
 #endif
   } else if (cmd == MONITOR_CMD_CREATE_MT_ACCT) {
     snprintf(sql, SQL_LENGTH,
@@ -214,6 +230,13 @@ void monitorInitDatabase() {
     monitor->state = MONITOR_STATE_INITIALIZED;
     monitorPrint("monitor service init success");
 
+    if (monitorStartupInfoFp != NULL) {
+      char content[LOG_LEN_STR + 1] = {0};
+      (*monitorStartupInfoFp)(content, LOG_LEN_STR);
+      monitorLPrint("%s", content);
+      monitorStartupInfoFp = NULL;
+    }
+
     monitorStartTimer();
   }
 }
@@ -347,12 +370,13 @@ int monitorBuildBandSql(char *sql) {
   return sprintf(sql, ", %f", bandSpeedKb);
 }
 
-int monitorBuildReqSql(char *sql) {
-  SCountInfo info;
-  info.httpReqNum = info.insertReqNum = info.selectReqNum = 0;
-  (*monitorCountReqFp)(&info);
+int monitorBuildReqSql(char *sql, SCountInfo *info) {
+  return sprintf(sql, ", %d, %d, %d)", info->httpReqNum, info->selectReqNum, info->insertReqNum);
+}
 
-  return sprintf(sql, ", %d, %d, %d)", info.httpReqNum, info.selectReqNum, info.insertReqNum);
+int monitorBuildBlockCacheSql(char *sql, int64_t ts, SCountInfo *info) {
+  return sprintf(sql, " %s.bcache_%s values(%ld, %d, %d, %d)", tsMonitorDbName, monitor->privateIpStr, ts,
+                 info->blockCacheHits, info->blockCacheMisses, info->blockCacheEvictions);
 }
 
 int monitorBuildIoSql(char *sql) {
@@ -374,6 +398,11 @@ void monitorSaveSystemInfo() {
     return;
   }
 
+  SCountInfo info;
+  info.httpReqNum = info.insertReqNum = info.selectReqNum = 0;
+  info.blockCacheHits = info.blockCacheMisses = info.blockCacheEvictions = 0;
+  (*monitorCountReqFp)(&info);
+
   int64_t ts = taosGetTimestampUs();
   char *  sql = monitor->sql;
   int pos = snprintf(sql, SQL_LENGTH, "insert into %s.dn_%s values(%ld", tsMonitorDbName, monitor->privateIpStr, ts);
@@ -383,7 +412,8 @@ void monitorSaveSystemInfo() {
   pos += monitorBuildDiskSql(sql + pos);
   pos += monitorBuildBandSql(sql + pos);
   pos += monitorBuildIoSql(sql + pos);
-  pos += monitorBuildReqSql(sql + pos);
+  pos += monitorBuildReqSql(sql + pos, &info);
+  pos += monitorBuildBlockCacheSql(sql + pos, ts, &info);
 
   monitorTrace("monitor:%p, save system info, sql:%s", monitor->conn, sql);
   taos_query_a(monitor->conn, sql, dnodeMontiorInsertSysCallback, "log");
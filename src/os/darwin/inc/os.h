@@ -36,6 +36,7 @@
 #include <sys/time.h>
 #include <sys/uio.h>
 #include <sys/un.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <pthread.h>
 #include <stdbool.h>
@@ -54,6 +55,7 @@
   }
 #define taosWriteSocket(fd, buf, len) write(fd, buf, len)
 #define taosReadSocket(fd, buf, len) read(fd, buf, len)
+#define taosWriteSocketV(fd, iov, iovcnt) writev(fd, iov, iovcnt)
 
 #define atomic_load_8(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
 #define atomic_load_16(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
@@ -179,6 +181,10 @@ void taosResetPthread(pthread_t *thread);
 
 int64_t taosGetPthreadId();
 
+void taosFutexWait(int32_t *addr, int32_t val);
+
+void taosFutexWake(int32_t *addr, int32_t num);
+
 int taosSetNonblocking(int sock, int on);
 
 int taosSetSockOpt(int socketfd, int level, int optname, void *optval, int optlen);
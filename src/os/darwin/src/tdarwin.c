@@ -78,6 +78,15 @@ void taosResetPthread(pthread_t *thread) { *thread = 0; }
 
 int64_t taosGetPthreadId() { return (int64_t)pthread_self(); }
 
+/*
+ * there is no futex on darwin, the waiting thread sleeps a while and checks again
+ */
+void taosFutexWait(int32_t *addr, int32_t val) {
+  if (atomic_load_32(addr) == val) usleep(100);
+}
+
+void taosFutexWake(int32_t *addr, int32_t num) {}
+
 /*
 * Function to get the private ip address of current machine. If get IP
 * successfully, return 0, else, return -1. The return values is ip.
@@ -315,6 +324,11 @@ int taosSendTcpClientData(unsigned int ip, uint16_t port, char *data, int len, v
   exit(0);
 }
 
+int taosSendTcpClientDataV(unsigned int ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  tError("function taosSendTcpClientDataV is not implemented in darwin system, exit!");
+  exit(0);
+}
+
 void taosCleanUpTcpClient(void *chandle) {
   tError("function taosCleanUpTcpClient is not implemented in darwin system, exit!");
   exit(0);
@@ -340,6 +354,11 @@ int taosSendTcpServerData(unsigned int ip, uint16_t port, char *data, int len, v
   exit(0);
 }
 
+int taosSendTcpServerDataV(unsigned int ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  tError("function taosSendTcpServerDataV is not implemented in darwin system, exit!");
+  exit(0);
+}
+
 void taosFreeMsgHdr(void *hdr) {
   tError("function taosFreeMsgHdr is not implemented in darwin system, exit!");
   exit(0);
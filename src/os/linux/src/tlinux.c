@@ -27,6 +27,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 #include <sys/utsname.h>
+#include <linux/futex.h>
 
 #include "tglobalcfg.h"
 #include "tlog.h"
@@ -79,6 +80,17 @@ void taosResetPthread(pthread_t *thread) { *thread = 0; }
 
 int64_t taosGetPthreadId() { return (int64_t)pthread_self(); }
 
+/*
+ * block the calling thread if *addr is still equal to val, until taosFutexWake is called on the same address
+ */
+void taosFutexWait(int32_t *addr, int32_t val) {
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+void taosFutexWake(int32_t *addr, int32_t num) {
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, num, NULL, NULL, 0);
+}
+
 /*
 * Function to get the private ip address of current machine. If get IP
 * successfully, return 0, else, return -1. The return values is ip.
@@ -19,6 +19,7 @@
 #include <io.h>
 #include <stdio.h>
 #include <signal.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <pthread.h>
@@ -79,6 +80,13 @@ extern "C" {
 #define taosWriteSocket(fd, buf, len) send(fd, buf, len, 0)
 #define taosReadSocket(fd, buf, len) recv(fd, buf, len, 0)
 
+struct iovec {
+  void  *iov_base;
+  size_t iov_len;
+};
+
+int taosWriteSocketV(int fd, struct iovec *iov, int iovcnt);
+
 #if defined(_M_ARM) || defined(_M_ARM64)
 
 /* the '__iso_volatile' functions does not use a memory fence, so these
@@ -306,6 +314,10 @@ void taosResetPthread(pthread_t *thread);
 
 int64_t taosGetPthreadId();
 
+void taosFutexWait(int32_t *addr, int32_t val);
+
+void taosFutexWake(int32_t *addr, int32_t num);
+
 int taosSetNonblocking(int sock, int on);
 
 int taosSetSockOpt(int socketfd, int level, int optname, void *optval, int optlen);
@@ -50,6 +50,15 @@ int64_t taosGetPthreadId() {
 #endif
 }
 
+/*
+ * there is no futex on windows, the waiting thread sleeps a while and checks again
+ */
+void taosFutexWait(int32_t *addr, int32_t val) {
+  if (atomic_load_32(addr) == val) Sleep(1);
+}
+
+void taosFutexWake(int32_t *addr, int32_t num) {}
+
 int taosSetSockOpt(int socketfd, int level, int optname, void *optval, int optlen) {
   if (level == SOL_SOCKET && optname == TCP_KEEPCNT) {
     return 0;
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <ws2def.h>
 #include <tchar.h>
+#include "os.h"
 
 void taosWinSocketInit() {
     static char flag = 0;
@@ -115,3 +116,17 @@ int taosGetPrivateIp(char *const ip) {
     free(pAddresses);
     return flag;
 }
+
+int taosWriteSocketV(int fd, struct iovec *iov, int iovcnt) {
+    DWORD len = 0;
+    WSABUF *buffers = (WSABUF *)malloc(sizeof(WSABUF) * iovcnt);
+    for (int i = 0; i < iovcnt; ++i) {
+        buffers[i].buf = iov[i].iov_base;
+        buffers[i].len = (ULONG)iov[i].iov_len;
+    }
+
+    int ret = WSASend(fd, buffers, iovcnt, &len, 0, NULL, NULL);
+    free(buffers);
+
+    return (ret == 0) ? (int)len : -1;
+}
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "os.h"
 #include "tlog.h"
 
 void *taosInitTcpClient(char *ip, uint16_t port, char *label, int num, void *fp, void *shandle) {
@@ -34,6 +35,11 @@ int taosSendTcpClientData(unsigned int ip, uint16_t port, char *data, int len, v
   return 0;
 }
 
+int taosSendTcpClientDataV(unsigned int ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  tError("SendTcpClientDataV not support in windows");
+  return 0;
+}
+
 void taosCleanUpTcpClient(void *chandle) {
   tError("SendTcpClientData not support in windows");
 }
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "os.h"
 #include "tlog.h"
 
 void taosCloseTcpServerConnection(void *chandle) {
@@ -32,3 +33,8 @@ int taosSendTcpServerData(unsigned int ip, uint16_t port, char *data, int len, v
   tError("SendTcpServerData not support in windows");
   return 0;
 }
+
+int taosSendTcpServerDataV(unsigned int ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  tError("SendTcpServerDataV not support in windows");
+  return 0;
+}
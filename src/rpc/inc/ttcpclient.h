@@ -23,5 +23,6 @@ void taosCleanUpTcpClient(void *chandle);
 void *taosOpenTcpClientConnection(void *shandle, void *thandle, char *ip, uint16_t port);
 void taosCloseTcpClientConnection(void *chandle);
 int taosSendTcpClientData(uint32_t ip, uint16_t port, char *data, int len, void *chandle);
+int taosSendTcpClientDataV(uint32_t ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle);
 
 #endif
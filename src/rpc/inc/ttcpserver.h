@@ -22,5 +22,6 @@ void *taosInitTcpServer(char *ip, uint16_t port, char *label, int numOfThreads,
 void taosCleanUpTcpServer(void *param);
 void taosCloseTcpServerConnection(void *param);
 int taosSendTcpServerData(uint32_t ip, uint16_t port, char *data, int len, void *chandle);
+int taosSendTcpServerDataV(uint32_t ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle);
 
 #endif
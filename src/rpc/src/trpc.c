@@ -63,6 +63,7 @@ typedef struct {
   char               inType;
   char               closing;
   char               rspReceived;
+  char               rspInPlace;  // rsp is sent in place over TCP by taosSendMsgToPeerV, and not kept for re-send
   void *             chandle;  // handle passed by TCP/UDP connection layer
   void *             ahandle;  // handle returned by upper app layter
   int                retry;
@@ -123,6 +124,10 @@ void (*taosCleanUpConn[])(void *thandle) = {taosCleanUpUdpConnection, taosCleanU
 int (*taosSendData[])(uint32_t ip, uint16_t port, char *data, int len, void *chandle) = {
     taosSendUdpData, taosSendUdpData, taosSendTcpServerData, taosSendTcpClientData};
 
+// UDP messages have to be contiguous, since they are retained for re-send and large ones are fetched by TCP
+int (*taosSendDataV[])(uint32_t ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) = {
+    NULL, NULL, taosSendTcpServerDataV, taosSendTcpClientDataV};
+
 void *(*taosOpenConn[])(void *shandle, void *thandle, char *ip, uint16_t port) = {
     taosOpenUdpConnection,
     taosOpenUdpConnection,
@@ -1157,6 +1162,7 @@ int taosSendMsgToPeerH(void *thandle, char *pCont, int contLen, void *ahandle) {
     tfree(pConn->pRspMsg);
     pConn->pRspMsg = msg;
     pConn->rspMsgLen = msgLen;
+    pConn->rspInPlace = 0;
 
     if (pHeader->content[0] == TSDB_CODE_ACTION_IN_PROGRESS) pConn->inTranId--;
 
@@ -1207,11 +1213,96 @@ int taosSendMsgToPeerH(void *thandle, char *pCont, int contLen, void *ahandle) {
   return contLen;
 }
 
+int taosSendMsgToPeerV(void *thandle, char *pCont, int contLen, struct iovec *pBody, int numOfBody) {
+  STaosHeader *pHeader;
+  SRpcConn *   pConn = (SRpcConn *)thandle;
+  STaosRpc *   pServer;
+  SRpcChann *  pChann;
+  int          bodyLen = 0;
+
+  if (pConn == NULL) return -1;
+  if (pConn->signature != pConn) return -1;
+
+  pServer = pConn->pServer;
+  pChann = pServer->channList + pConn->chann;
+  pHeader = (STaosHeader *)(pCont - sizeof(STaosHeader));
+
+  assert((pHeader->msgType & 1) == 0);
+  for (int i = 0; i < numOfBody; ++i) bodyLen += (int)pBody[i].iov_len;
+
+  struct iovec *iov = NULL;
+  if (pConn->spi == 0 && taosSendDataV[pServer->type] != NULL) {
+    iov = (struct iovec *)malloc(sizeof(struct iovec) * (numOfBody + 1));
+  }
+
+  // the body is gathered into the msg as usual, if the response is signed or sent by UDP
+  if (iov == NULL) {
+    char *msg = realloc(pHeader, sizeof(STaosHeader) + contLen + bodyLen + sizeof(STaosDigest));
+    if (msg == NULL) {
+      tError("%s cid:%d sid:%d id:%s, failed to alloc rsp msg, size:%d", pServer->label, pConn->chann, pConn->sid,
+             pConn->meterId, contLen + bodyLen);
+      free(pHeader);
+      return -1;
+    }
+
+    pCont = msg + sizeof(STaosHeader);
+    for (int i = 0; i < numOfBody; ++i) {
+      memcpy(pCont + contLen, pBody[i].iov_base, pBody[i].iov_len);
+      contLen += (int)pBody[i].iov_len;
+    }
+
+    return taosSendMsgToPeer(thandle, pCont, contLen);
+  }
+
+  int msgLen = (int)sizeof(STaosHeader) + contLen + bodyLen;
+  if (pConn->localPort) pHeader->port = pConn->localPort;
+  pHeader->msgLen = (int32_t)htonl((uint32_t)msgLen);
+
+  iov[0].iov_base = pHeader;
+  iov[0].iov_len = sizeof(STaosHeader) + contLen;
+  memcpy(iov + 1, pBody, sizeof(struct iovec) * numOfBody);
+
+  pthread_mutex_lock(&pChann->mutex);
+
+  // TCP is reliable, so the response is not kept for re-send, the peer receives it unless the connection is broken
+  pConn->inType = 0;
+  tfree(pConn->pRspMsg);
+  pConn->rspMsgLen = 0;
+  pConn->rspInPlace = 1;
+  if (pHeader->content[0] == TSDB_CODE_ACTION_IN_PROGRESS) pConn->inTranId--;
+
+  if (pHeader->msgType < TSDB_MSG_TYPE_HEARTBEAT || (rpcDebugFlag & 16))
+    tTrace(
+        "%s cid:%d sid:%d id:%s, %s is sent to %s:%hu, code:%u len:%d iov:%d source:0x%08x dest:0x%08x tranId:%d "
+        "pConn:%p",
+        pServer->label, pConn->chann, pConn->sid, pConn->meterId, taosMsg[pHeader->msgType], pConn->peerIpstr,
+        pConn->peerPort, (uint8_t)pHeader->content[0], msgLen, numOfBody + 1, pHeader->sourceId, pHeader->destId,
+        pHeader->tranId, pConn);
+
+  int writtenLen =
+      (*taosSendDataV[pServer->type])(pConn->peerIp, pConn->peerPort, iov, numOfBody + 1, pConn->chandle);
+  if (writtenLen != msgLen)
+    tError("%s cid:%d sid:%d id:%s, dataLen:%d writtenLen:%d, not good, reason:%s", pServer->label, pConn->chann,
+           pConn->sid, pConn->meterId, msgLen, writtenLen, strerror(errno));
+
+  pthread_mutex_unlock(&pChann->mutex);
+
+  free(iov);
+  free(pHeader);
+  return contLen + bodyLen;
+}
+
 int taosReSendRspToPeer(SRpcConn *pConn) {
   STaosHeader *pHeader;
   int          writtenLen;
   STaosRpc *   pServer = pConn->pServer;
 
+  if (pConn->rspInPlace) {
+    tTrace("%s cid:%d sid:%d id:%s, rsp was sent in place over TCP, not re-sent pConn:%p", pServer->label, pConn->chann,
+           pConn->sid, pConn->meterId, pConn);
+    return 0;
+  }
+
   if (pConn->pRspMsg == NULL || pConn->rspMsgLen <= 0) {
     tError("%s cid:%d sid:%d id:%s, rsp is null", pServer->label, pConn->chann, pConn->sid, pConn->meterId);
     return -1;
@@ -313,3 +313,11 @@ int taosSendTcpClientData(uint32_t ip, uint16_t port, char *data, int len, void
 
   return (int)send(pFdObj->fd, data, (size_t)len, 0);
 }
+
+int taosSendTcpClientDataV(uint32_t ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  STcpFd *pFdObj = (STcpFd *)chandle;
+
+  if (chandle == NULL) return -1;
+
+  return taosWriteMsgV(pFdObj->fd, iov, iovcnt);
+}
@@ -22,6 +22,10 @@
 #include "tutil.h"
 
 #define TAOS_IPv4ADDR_LEN 16
+
+// bytes and messages read from one FD per wakeup, the FD is re-armed if there is more, so it can not starve others
+#define TAOS_TCP_MAX_BYTES_PER_READ (256 * 1024)
+#define TAOS_TCP_MAX_MSGS_PER_READ  16
 #ifndef EPOLLWAKEUP
   #define EPOLLWAKEUP (1u << 29)
 #endif
@@ -35,6 +39,13 @@ typedef struct _fd_obj {
   uint16_t            port;
   struct _thread_obj *pThreadObj;
   struct _fd_obj *    prev, *next;
+
+  // receive state of the incoming message, the header is received at first, then the body into msg
+  char  head[sizeof(STaosHeader)];
+  int   headLen;  // received bytes of header
+  char *msg;      // buffer of the whole message, allocated after the header is received
+  int   msgLen;
+  int   recvLen;  // received bytes of msg
 } SFdObj;
 
 typedef struct _thread_obj {
@@ -104,6 +115,7 @@ static void taosCleanUpFdObj(SFdObj *pFdObj) {
   tTrace("%s TCP thread:%d, FD is cleaned up, numOfFds:%d", pThreadObj->label, pThreadObj->threadId,
          pThreadObj->numOfFds);
 
+  tfree(pFdObj->msg);
   memset(pFdObj, 0, sizeof(SFdObj));
 
   tfree(pFdObj);
@@ -150,6 +162,91 @@ void taosCleanUpTcpServer(void *handle) {
 
 #define maxEvents 10
 
+static int taosRecvTcpData(SFdObj *pFdObj, char *buf, int len) {
+  int ret;
+
+  // the FD is kept blocking for sending, only the receive does not wait
+  do {
+    ret = (int)recv(pFdObj->fd, buf, (size_t)len, MSG_DONTWAIT);
+  } while (ret < 0 && errno == EINTR);
+
+  return ret;
+}
+
+/*
+ * Receive the messages available on the FD, till no more data can be read without waiting, or the limits per
+ * wakeup are reached. A message may be received in several rounds, so the receive state is kept in FdObj. The
+ * message buffer is allocated once its length is known from the header, and is handed over to the upper layer,
+ * which frees it.
+ * Return -1 if the connection shall be cleaned up, 1 if the limits are reached and the FD shall be re-armed.
+ */
+static int taosReadTcpData(SThreadObj *pThreadObj, SFdObj *pFdObj) {
+  int bytes = 0;
+  int msgs = 0;
+
+  while (1) {
+    int retLen;
+
+    if (bytes >= TAOS_TCP_MAX_BYTES_PER_READ || msgs >= TAOS_TCP_MAX_MSGS_PER_READ) return 1;
+
+    if (pFdObj->msg == NULL) {
+      retLen = taosRecvTcpData(pFdObj, pFdObj->head + pFdObj->headLen, sizeof(STaosHeader) - pFdObj->headLen);
+    } else {
+      retLen = taosRecvTcpData(pFdObj, pFdObj->msg + pFdObj->recvLen, pFdObj->msgLen - pFdObj->recvLen);
+    }
+
+    if (retLen < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+
+      tError("%s read error, ip:%s port:%hu, errno:%d", pThreadObj->label, pFdObj->ipstr, pFdObj->port, errno);
+      return -1;
+    }
+
+    if (retLen == 0) {
+      tTrace("%s TCP connection is closed by peer, ip:%s port:%hu, headLen:%d recvLen:%d", pThreadObj->label,
+             pFdObj->ipstr, pFdObj->port, pFdObj->headLen, pFdObj->recvLen);
+      return -1;
+    }
+
+    bytes += retLen;
+
+    if (pFdObj->msg == NULL) {
+      pFdObj->headLen += retLen;
+      if (pFdObj->headLen < sizeof(STaosHeader)) continue;
+
+      int msgLen = (int32_t)htonl((uint32_t)((STaosHeader *)pFdObj->head)->msgLen);
+      if (msgLen < (int)sizeof(STaosHeader) || msgLen > TSDB_MAX_RPC_MSG_LEN) {
+        tError("%s invalid msgLen:%d, ip:%s port:%hu", pThreadObj->label, msgLen, pFdObj->ipstr, pFdObj->port);
+        return -1;
+      }
+
+      pFdObj->msg = malloc((size_t)msgLen);
+      if (pFdObj->msg == NULL) {
+        tError("%s failed to allocate message buffer, msgLen:%d", pThreadObj->label, msgLen);
+        return -1;
+      }
+
+      memcpy(pFdObj->msg, pFdObj->head, sizeof(STaosHeader));
+      pFdObj->msgLen = msgLen;
+      pFdObj->recvLen = sizeof(STaosHeader);
+    } else {
+      pFdObj->recvLen += retLen;
+    }
+
+    if (pFdObj->recvLen < pFdObj->msgLen) continue;
+
+    char *msg = pFdObj->msg;
+    pFdObj->msg = NULL;
+    pFdObj->headLen = 0;
+    pFdObj->recvLen = 0;
+    msgs++;
+
+    pFdObj->thandle = (*(pThreadObj->processData))(msg, pFdObj->msgLen, pFdObj->ip, pFdObj->port, pThreadObj->shandle,
+                                                   pFdObj->thandle, pFdObj);
+    if (pFdObj->thandle == NULL) return -1;
+  }
+}
+
 static void taosProcessTcpData(void *param) {
   SThreadObj *       pThreadObj;
   int                i, fdNum;
@@ -183,36 +280,20 @@ static void taosProcessTcpData(void *param) {
         continue;
       }
 
-      void *buffer = malloc(1024);
-      int   headLen = taosReadMsg(pFdObj->fd, buffer, sizeof(STaosHeader));
-
-      if (headLen != sizeof(STaosHeader)) {
-        tError("%s read error, headLen:%d, errno:%d", pThreadObj->label, headLen, errno);
-        taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
-        continue;
-      }
-
-      int dataLen = (int32_t)htonl((uint32_t)((STaosHeader *)buffer)->msgLen);
-      if (dataLen > 1024) buffer = realloc(buffer, (size_t)dataLen);
-
-      int leftLen = dataLen - headLen;
-      int retLen = taosReadMsg(pFdObj->fd, buffer + headLen, leftLen);
-
-      // tTrace("%s TCP data is received, ip:%s port:%u len:%d",
-      // pThreadObj->label, pFdObj->ipstr, pFdObj->port, dataLen);
-
-      if (leftLen != retLen) {
-        tError("%s read error, leftLen:%d retLen:%d", pThreadObj->label, leftLen, retLen);
-        taosCleanUpFdObj(pFdObj);
-        tfree(buffer);
-        continue;
+      int code = taosReadTcpData(pThreadObj, pFdObj);
+      if (code > 0) {
+        // edge triggered, modifying the FD reports it again at the tail of the ready list if data is left
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP | EPOLLET;
+        event.data.ptr = pFdObj;
+        if (epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_MOD, pFdObj->fd, &event) < 0) {
+          tError("%s TCP thread:%d, failed to re-arm FD, reason:%s", pThreadObj->label, pThreadObj->threadId,
+                 strerror(errno));
+          code = -1;
+        }
       }
 
-      pFdObj->thandle = (*(pThreadObj->processData))(buffer, dataLen, pFdObj->ip, pFdObj->port,
-                                                     pThreadObj->shandle, pFdObj->thandle, pFdObj);
-
-      if (pFdObj->thandle == NULL) taosCleanUpFdObj(pFdObj);
+      if (code < 0) taosCleanUpFdObj(pFdObj);
     }
   }
 }
@@ -269,7 +350,7 @@ void taosAcceptTcpConnection(void *arg) {
     pFdObj->pThreadObj = pThreadObj;
     pFdObj->signature = pFdObj;
 
-    event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP;
+    event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP | EPOLLET;
     event.data.ptr = pFdObj;
     if (epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_ADD, connFd, &event) < 0) {
       tError("%s failed to add TCP FD for epoll, error:%s", pServerObj->label, strerror(errno));
@@ -342,7 +423,7 @@ void taosAcceptUDConnection(void *arg) {
     pFdObj->fd = connFd;
     pFdObj->pThreadObj = pThreadObj;
 
-    event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP;
+    event.events = EPOLLIN | EPOLLPRI | EPOLLWAKEUP | EPOLLET;
     event.data.ptr = pFdObj;
     if (epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_ADD, connFd, &event) < 0) {
       tError("%s failed to add UD FD for epoll, error:%s", pServerObj->label, strerror(errno));
@@ -494,3 +575,11 @@ int taosSendTcpServerData(uint32_t ip, uint16_t port, char *data, int len, void
 
   return (int)send(pFdObj->fd, data, (size_t)len, 0);
 }
+
+int taosSendTcpServerDataV(uint32_t ip, uint16_t port, struct iovec *iov, int iovcnt, void *chandle) {
+  SFdObj *pFdObj = (SFdObj *)chandle;
+
+  if (chandle == NULL) return -1;
+
+  return taosWriteMsgV(pFdObj->fd, iov, iovcnt);
+}
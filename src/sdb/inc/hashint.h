@@ -21,6 +21,7 @@ void sdbCloseIntHash(void *handle);
 void *sdbAddIntHash(void *handle, void *key, void *pData);
 void sdbDeleteIntHash(void *handle, void *key);
 void *sdbGetIntHashData(void *handle, void *key);
+int sdbReadIntHashData(void *handle, void *key, void *data);
 void *sdbFetchIntHashData(void *handle, void *ptr, void **ppMeta);
 
 #endif
@@ -21,6 +21,7 @@ void sdbCloseStrHash(void *handle);
 void *sdbAddStrHash(void *handle, void *key, void *pData);
 void sdbDeleteStrHash(void *handle, void *key);
 void *sdbGetStrHashData(void *handle, void *key);
+int sdbReadStrHashData(void *handle, void *key, void *data);
 void *sdbFetchStrHashData(void *handle, void *ptr, void **ppMeta);
 
 #endif
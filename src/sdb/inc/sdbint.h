@@ -55,6 +55,13 @@
 #define SDB_MAX_PEERS 4
 #define SDB_DELIMITER 0xFFF00F00
 #define SDB_ENDCOMMIT 0xAFFFAAAF
+#define SDB_CHECKPOINT 0xCFFFCCCF
+
+// a checkpoint is saved once the rows appended after it are more than both of the following
+#define SDB_MIN_DELTA_ROWS   1000
+#define SDB_DELTA_ROWS_RATIO 0.5
+
+#define SDB_SNAPSHOT_BUFFER_SIZE (1024 * 1024)
 
 typedef struct {
   uint64_t swVersion;
@@ -63,6 +70,27 @@ typedef struct {
   TSCKSUM  checkSum;
 } SSdbHeader;
 
+/*
+ * the checkpoint record follows the file header of a snapshot, and the rows of the checkpoint are in range
+ * [offset of this record, size) of the file. Each key appears only once in these rows, so they are loaded
+ * without checking the index. Rows after them are the delta log replayed on top of the checkpoint.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t autoIndex;
+  int64_t  numOfRows;
+  int64_t  id;
+  int64_t  size;
+  int32_t  reserved;
+  TSCKSUM  checkSum;
+} SSdbCheckpoint;
+
+// a row in the snapshot of the index, from which the checkpoint is saved
+typedef struct {
+  int64_t id;
+  void *  row;
+} SSdbCheckpointRow;
+
 typedef struct {
   char type;
   // short  rowSize;
@@ -86,6 +114,8 @@ typedef struct {
   int64_t    numOfRows;
   int64_t    id;
   int64_t    size;
+  int64_t    numOfDeltaRows;  // rows appended after the last checkpoint
+  int        checkpointInProcess;
   void *     iHandle;
   int        fd;
   void *(*appTool)(char, void *, char *, int, int *);
@@ -142,6 +172,7 @@ extern int64_t    sdbVersion;
 int sdbForwardDbReqToPeer(SSdbTable *pTable, char type, char *data, int dataLen);
 int sdbRetrieveRows(int fd, SSdbTable *pTable, uint64_t version);
 void sdbResetTable(SSdbTable *pTable);
+void sdbCheckpointIfNeeded(SSdbTable *pTable);
 extern const int16_t sdbFileVersion;
 
 #endif
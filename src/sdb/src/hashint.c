@@ -21,7 +21,9 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "os.h"
 #include "tmempool.h"
+#include "trcu.h"
 #include "tsdb.h"
 
 typedef struct _long_hash_t {
@@ -37,6 +39,7 @@ typedef struct {
   mpool_h     longHashMemPool;
   int         maxSessions;
   int         dataSize;
+  void *      rcu;  // writers are serialized by the sdb table, readers only enter a read section
 } SHashObj;
 
 int sdbHashLong(void *handle, uint32_t ip) {
@@ -62,6 +65,8 @@ void *sdbAddIntHash(void *handle, void *pKey, void *data) {
 
   hash = sdbHashLong(pObj, key);
   pNode = (SLongHash *)taosMemPoolMalloc(pObj->longHashMemPool);
+  if (pNode == NULL) return NULL;
+
   pNode->key = key;
   memcpy(pNode->data, data, pObj->dataSize);
   pNode->prev = 0;
@@ -69,7 +74,7 @@ void *sdbAddIntHash(void *handle, void *pKey, void *data) {
   pNode->hash = hash;
 
   if (pObj->longHashList[hash] != 0) (pObj->longHashList[hash])->prev = pNode;
-  pObj->longHashList[hash] = pNode;
+  atomic_store_ptr(&pObj->longHashList[hash], pNode);
 
   return pObj;
 }
@@ -94,16 +99,16 @@ void sdbDeleteIntHash(void *handle, void *pKey) {
 
   if (pNode) {
     if (pNode->prev) {
-      pNode->prev->next = pNode->next;
+      atomic_store_ptr(&pNode->prev->next, pNode->next);
     } else {
-      pObj->longHashList[hash] = pNode->next;
+      atomic_store_ptr(&pObj->longHashList[hash], pNode->next);
     }
 
     if (pNode->next) {
       pNode->next->prev = pNode->prev;
     }
 
-    taosMemPoolFree(pObj->longHashMemPool, (char *)pNode);
+    taosRcuRetire(pObj->rcu, pNode);
   }
 }
 
@@ -131,12 +136,45 @@ void *sdbGetIntHashData(void *handle, void *pKey) {
   return NULL;
 }
 
+/*
+ * copy the data out inside a read section, so it can be called without the lock of the writers
+ */
+int sdbReadIntHashData(void *handle, void *pKey, void *data) {
+  int        hash;
+  SLongHash *pNode;
+  SHashObj * pObj;
+  uint32_t   key = *((uint32_t *)pKey);
+
+  pObj = (SHashObj *)handle;
+  if (pObj == NULL || pObj->maxSessions == 0) return -1;
+
+  hash = sdbHashLong(pObj, key);
+
+  int32_t token = taosRcuReadLock(pObj->rcu);
+
+  pNode = atomic_load_ptr(&pObj->longHashList[hash]);
+  while (pNode) {
+    if (pNode->key == key) {
+      memcpy(data, pNode->data, pObj->dataSize);
+      break;
+    }
+    pNode = atomic_load_ptr(&pNode->next);
+  }
+
+  taosRcuReadUnlock(pObj->rcu, token);
+
+  return pNode ? 0 : -1;
+}
+
+static void sdbFreeIntHashNode(void *param, void *p) { taosMemPoolFree((mpool_h)param, (char *)p); }
+
 void *sdbOpenIntHash(int maxSessions, int dataSize) {
   SLongHash **longHashList;
   mpool_h     longHashMemPool;
   SHashObj *  pObj;
 
-  longHashMemPool = taosMemPoolInit(maxSessions, sizeof(SLongHash) + dataSize);
+  // retired nodes hold their slots until they are freed in a batch, the slots cached by threads are extra in the pool
+  longHashMemPool = taosMemPoolInit(maxSessions + TAOS_RCU_RETIRE_BATCH, sizeof(SLongHash) + dataSize);
   if (longHashMemPool == 0) return NULL;
 
   longHashList = calloc(sizeof(SLongHash *), maxSessions);
@@ -157,6 +195,14 @@ void *sdbOpenIntHash(int maxSessions, int dataSize) {
   pObj->longHashList = longHashList;
   pObj->dataSize = dataSize;
 
+  pObj->rcu = taosInitRcu(sdbFreeIntHashNode, longHashMemPool);
+  if (pObj->rcu == NULL) {
+    taosMemPoolCleanUp(longHashMemPool);
+    free(longHashList);
+    free(pObj);
+    return NULL;
+  }
+
   return pObj;
 }
 
@@ -166,6 +212,8 @@ void sdbCloseIntHash(void *handle) {
   pObj = (SHashObj *)handle;
   if (pObj == NULL || pObj->maxSessions == 0) return;
 
+  taosCleanUpRcu(pObj->rcu);
+
   if (pObj->longHashMemPool) taosMemPoolCleanUp(pObj->longHashMemPool);
 
   if (pObj->longHashList) free(pObj->longHashList);
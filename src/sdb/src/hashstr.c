@@ -14,6 +14,7 @@
  */
 
 #include "os.h"
+#include "trcu.h"
 #include "tsdb.h"
 
 #define MAX_STR_LEN 40
@@ -30,6 +31,7 @@ typedef struct {
   SHashNode **hashList;
   int         maxSessions;
   int         dataSize;
+  void *      rcu;  // writers are serialized by the sdb table, readers only enter a read section
 } SHashObj;
 
 int sdbHashString(void *handle, char *string) {
@@ -71,6 +73,8 @@ void *sdbAddStrHash(void *handle, void *key, void *pData) {
 
   int size = sizeof(SHashNode) + pObj->dataSize;
   pNode = (SHashNode *)malloc(size);
+  if (pNode == NULL) return NULL;
+
   memset(pNode, 0, size);
   strcpy(pNode->string, string);
   memcpy(pNode->data, pData, pObj->dataSize);
@@ -79,7 +83,7 @@ void *sdbAddStrHash(void *handle, void *key, void *pData) {
   pNode->hash = hash;
 
   if (pObj->hashList[hash] != 0) (pObj->hashList[hash])->prev = pNode;
-  pObj->hashList[hash] = pNode;
+  atomic_store_ptr(&pObj->hashList[hash], pNode);
 
   return pNode->data;
 }
@@ -103,17 +107,16 @@ void sdbDeleteStrHash(void *handle, void *key) {
 
   if (pNode) {
     if (pNode->prev) {
-      pNode->prev->next = pNode->next;
+      atomic_store_ptr(&pNode->prev->next, pNode->next);
     } else {
-      pObj->hashList[hash] = pNode->next;
+      atomic_store_ptr(&pObj->hashList[hash], pNode->next);
     }
 
     if (pNode->next) {
       pNode->next->prev = pNode->prev;
     }
 
-    memset(pNode, 0, sizeof(SHashNode));
-    free(pNode);
+    taosRcuRetire(pObj->rcu, pNode);
   }
 }
 
@@ -141,6 +144,36 @@ void *sdbGetStrHashData(void *handle, void *key) {
   return NULL;
 }
 
+/*
+ * copy the data out inside a read section, so it can be called without the lock of the writers
+ */
+int sdbReadStrHashData(void *handle, void *key, void *data) {
+  int        hash;
+  SHashNode *pNode;
+  SHashObj * pObj;
+  char *     string = (char *)key;
+
+  pObj = (SHashObj *)handle;
+  if (pObj == NULL || pObj->maxSessions == 0) return -1;
+
+  hash = sdbHashString(pObj, string);
+
+  int32_t token = taosRcuReadLock(pObj->rcu);
+
+  pNode = atomic_load_ptr(&pObj->hashList[hash]);
+  while (pNode) {
+    if (strcmp(pNode->string, string) == 0) {
+      memcpy(data, pNode->data, pObj->dataSize);
+      break;
+    }
+    pNode = atomic_load_ptr(&pNode->next);
+  }
+
+  taosRcuReadUnlock(pObj->rcu, token);
+
+  return pNode ? 0 : -1;
+}
+
 void *sdbOpenStrHash(int maxSessions, int dataSize) {
   SHashObj *pObj;
 
@@ -160,6 +193,13 @@ void *sdbOpenStrHash(int maxSessions, int dataSize) {
   }
   memset(pObj->hashList, 0, sizeof(SHashNode *) * maxSessions);
 
+  pObj->rcu = taosInitRcu(NULL, NULL);
+  if (pObj->rcu == NULL) {
+    free(pObj->hashList);
+    free(pObj);
+    return NULL;
+  }
+
   return (void *)pObj;
 }
 
@@ -170,6 +210,8 @@ void sdbCloseStrHash(void *handle) {
   pObj = (SHashObj *)handle;
   if (pObj == NULL || pObj->maxSessions <= 0) return;
 
+  taosCleanUpRcu(pObj->rcu);
+
   if (pObj->hashList) {
     for (int i = 0; i < pObj->maxSessions; ++i) {
       pNode = pObj->hashList[i];
@@ -34,6 +34,9 @@ void (*sdbDeleteIndexFp[])(void *handle, void *key) = {sdbDeleteStrHash, sdbDele
 
 void *(*sdbGetIndexFp[])(void *handle, void *key) = {sdbGetStrHashData, sdbGetIntHashData, sdbGetIntHashData};
 
+int (*sdbReadIndexFp[])(void *handle, void *key, void *data) = {sdbReadStrHashData, sdbReadIntHashData,
+                                                                sdbReadIntHashData};
+
 void (*sdbCleanUpIndexFp[])(void *handle) = {
     sdbCloseStrHash, sdbCloseIntHash, sdbCloseIntHash,
 };
@@ -158,14 +161,26 @@ void sdbAddIntoUpdateList(SSdbTable *pTable, char type, char *row) {
   pTable->update[pTable->updatePos].row = row;
 }
 
+static void sdbUpdateAutoIndex(SSdbTable *pTable, char *data) {
+  if (pTable->keyType == SDB_KEYTYPE_AUTO && *(uint32_t *)data > pTable->autoIndex) {
+    pTable->autoIndex = *(uint32_t *)data;
+  }
+}
+
+static bool sdbNeedCheckpoint(SSdbTable *pTable) {
+  return pTable->numOfDeltaRows >= SDB_MIN_DELTA_ROWS &&
+         pTable->numOfDeltaRows > pTable->numOfRows * SDB_DELTA_ROWS_RATIO;
+}
+
 int sdbInitTableByFile(SSdbTable *pTable) {
   SRowMeta rowMeta;
   int      numOfDels = 0;
-  int      bytes = 0;
   int64_t  oldId = 0;
   void *   pMetaRow = NULL;
   int      total_size = 0;
   int      real_size = 0;
+  int64_t  checkpointEnd = 0;
+  char *   pMem = MAP_FAILED;
 
   oldId = pTable->id;
   if (sdbOpenSdbFile(pTable) < 0) return -1;
@@ -177,21 +192,57 @@ int sdbInitTableByFile(SSdbTable *pTable) {
     return -1;
   }
 
-  // Loop to read sdb file row by row
-  while (1) {
-    memset(rowHead, 0, total_size);
+  struct stat fstat;
+  if (stat(pTable->fn, &fstat) < 0) {
+    sdbError("failed to stat sdb file: %s", pTable->fn);
+    goto sdb_exit1;
+  }
 
-    bytes = read(pTable->fd, rowHead, sizeof(SRowHead));
-    if (bytes < 0) {
-      sdbError("failed to read sdb file: %s", pTable->fn);
+  // the whole file is parsed in memory
+  int64_t fileSize = fstat.st_size;
+  if (fileSize > pTable->size) {
+    pMem = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, pTable->fd, 0);
+    if (pMem == MAP_FAILED) {
+      sdbError("failed to mmap sdb file: %s, reason:%s", pTable->fn, strerror(errno));
       goto sdb_exit1;
     }
+    madvise(pMem, fileSize, MADV_SEQUENTIAL);
+  }
 
-    if (bytes == 0) break;
+  SSdbCheckpoint checkpoint;
+  if (fileSize - pTable->size >= sizeof(SSdbCheckpoint)) {
+    memcpy(&checkpoint, pMem + pTable->size, sizeof(SSdbCheckpoint));
+    if (checkpoint.magic == SDB_CHECKPOINT && checkpoint.size <= fileSize &&
+        taosCheckChecksumWhole((uint8_t *)&checkpoint, sizeof(SSdbCheckpoint))) {
+      pTable->size += sizeof(SSdbCheckpoint);
+      checkpointEnd = checkpoint.size;
+      pTable->autoIndex = checkpoint.autoIndex;
+      if (pTable->id < checkpoint.id) pTable->id = checkpoint.id;
+      sdbTrace("table:%s, checkpoint is found, rows:%ld id:%ld size:%ld", pTable->name, checkpoint.numOfRows,
+               checkpoint.id, checkpoint.size);
+    }
+  }
 
-    if (bytes < sizeof(SRowHead) || rowHead->delimiter != SDB_DELIMITER) {
+  // Loop to parse sdb file row by row
+  while (pTable->size < fileSize) {
+    char *  pRow = pMem + pTable->size;
+    int64_t left = fileSize - pTable->size;
+
+    uint32_t sdbEcommit = 0;
+    if (left >= sizeof(sdbEcommit)) memcpy(&sdbEcommit, pRow, sizeof(sdbEcommit));
+    if (sdbEcommit == SDB_ENDCOMMIT) {
+      pTable->size += sizeof(sdbEcommit);
+      continue;
+    }
+
+    if (left < sizeof(SRowHead)) {
+      pTable->size = fileSize;
+      break;
+    }
+
+    memcpy(rowHead, pRow, sizeof(SRowHead));
+    if (rowHead->delimiter != SDB_DELIMITER) {
       pTable->size++;
-      lseek(pTable->fd, -(bytes - 1), SEEK_CUR);
       continue;
     }
 
@@ -205,20 +256,35 @@ int sdbInitTableByFile(SSdbTable *pTable) {
     // sdbTrace("%s id:%ld rowSize:%d", pTable->name, rowHead->id,
     // rowHead->rowSize);
 
-    bytes = read(pTable->fd, rowHead->data, rowHead->rowSize + sizeof(TSCKSUM));
-    if (bytes < rowHead->rowSize + sizeof(TSCKSUM)) {
+    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
+    if (left < real_size) {
       // TODO: Here may cause pTable->size not end of the file
       sdbError("failed to read sdb file: %s  id: %d  rowSize: %d", pTable->fn, rowHead->id, rowHead->rowSize);
       break;
     }
 
-    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
+    memcpy(rowHead->data, pRow + sizeof(SRowHead), rowHead->rowSize + sizeof(TSCKSUM));
     if (!taosCheckChecksumWhole((uint8_t *)rowHead, real_size)) {
       sdbError("error sdb checksum, sdb: %s  id: %d, skip", pTable->name, rowHead->id);
       pTable->size += real_size;
       continue;
     }
 
+    if (pTable->size < checkpointEnd) {
+      // rows in checkpoint are unique, add them into index directly
+      rowMeta.id = rowHead->id;
+      rowMeta.offset = pTable->size;
+      rowMeta.rowSize = rowHead->rowSize;
+      rowMeta.row = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
+      (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
+      sdbUpdateAutoIndex(pTable, rowHead->data);
+      pTable->numOfRows++;
+
+      pTable->size += real_size;
+      if (pTable->id < abs(rowHead->id)) pTable->id = abs(rowHead->id);
+      continue;
+    }
+
     // Check if the the object exists already
 
     pMetaRow = sdbGetRow(pTable, rowHead->data);
@@ -233,7 +299,7 @@ int sdbInitTableByFile(SSdbTable *pTable) {
         rowMeta.rowSize = rowHead->rowSize;
         rowMeta.row = (*(pTable->appTool))(SDB_TYPE_DECODE, NULL, rowHead->data, rowHead->rowSize, NULL);
         (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, rowMeta.row, &rowMeta);
-        if (pTable->keyType == SDB_KEYTYPE_AUTO) pTable->autoIndex++;
+        sdbUpdateAutoIndex(pTable, rowHead->data);
         pTable->numOfRows++;
       }
     } else {                  // already exists
@@ -249,12 +315,21 @@ int sdbInitTableByFile(SSdbTable *pTable) {
       numOfDels++;
     }
 
+    pTable->numOfDeltaRows++;
     pTable->size += real_size;
     if (pTable->id < abs(rowHead->id)) pTable->id = abs(rowHead->id);
   }
 
+  if (pMem != MAP_FAILED) munmap(pMem, fileSize);
+  lseek(pTable->fd, 0, SEEK_END);
+
+  sdbTrace("table:%s, file is loaded, rows:%ld, delta rows:%ld", pTable->name, pTable->numOfRows,
+           pTable->numOfDeltaRows);
+
   sdbVersion += (pTable->id - oldId);
-  if (numOfDels > pTable->maxRows / 4) sdbSaveSnapShot(pTable);
+
+  // nothing is written while the file is loaded, so the checkpoint is saved in place
+  if (numOfDels > pTable->maxRows / 4 || sdbNeedCheckpoint(pTable)) sdbSaveSnapShot(pTable);
 
   pTable->numOfUpdates = 0;
   pTable->updatePos = 0;
@@ -315,17 +390,14 @@ SRowMeta *sdbGetRowMeta(void *handle, void *key) {
 
 void *sdbGetRow(void *handle, void *key) {
   SSdbTable *pTable = (SSdbTable *)handle;
-  SRowMeta * pMeta;
+  SRowMeta   rowMeta;
 
   if (handle == NULL) return NULL;
 
-  pthread_mutex_lock(&pTable->mutex);
-  pMeta = (*sdbGetIndexFp[pTable->keyType])(pTable->iHandle, key);
-  pthread_mutex_unlock(&pTable->mutex);
-
-  if (pMeta == NULL) return NULL;
+  // the index is read without the table lock, the row meta is copied out of the index node
+  if ((*sdbReadIndexFp[pTable->keyType])(pTable->iHandle, key, &rowMeta) < 0) return NULL;
 
-  return pMeta->row;
+  return rowMeta.row;
 }
 
 // row here must be encoded string (rowSize > 0) or the object it self (rowSize
@@ -387,7 +459,16 @@ int64_t sdbInsertRow(void *handle, void *row, int rowSize) {
     rowMeta.offset = pTable->size;
     rowMeta.rowSize = rowHead->rowSize;
     rowMeta.row = pObj;
-    (*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, pObj, &rowMeta);
+    if ((*sdbAddIndexFp[pTable->keyType])(pTable->iHandle, pObj, &rowMeta) == NULL) {
+      sdbError("table:%s, failed to add a record into index, id:%ld", pTable->name, rowMeta.id);
+      if (pTable->keyType == SDB_KEYTYPE_AUTO) pTable->autoIndex--;
+      pTable->id--;
+      sdbVersion--;
+      if (rowSize != 0) (*(pTable->appTool))(SDB_TYPE_DESTROY, pObj, NULL, 0, NULL);
+      pthread_mutex_unlock(&pTable->mutex);
+      tfree(rowHead);
+      return -1;
+    }
 
     /* Update the disk content */
     /* write(pTable->fd, &action, sizeof(action)); */
@@ -399,6 +480,7 @@ int64_t sdbInsertRow(void *handle, void *row, int rowSize) {
     sdbAddIntoUpdateList(pTable, SDB_TYPE_INSERT, rowMeta.row);
 
     pTable->numOfRows++;
+    pTable->numOfDeltaRows++;
     switch (pTable->keyType) {
       case SDB_KEYTYPE_STRING:
         sdbTrace(
@@ -419,6 +501,7 @@ int64_t sdbInsertRow(void *handle, void *row, int rowSize) {
     }
 
     id = rowMeta.id;
+    sdbCheckpointIfNeeded(pTable);
   }
 
   tfree(rowHead);
@@ -521,6 +604,8 @@ int sdbDeleteRow(void *handle, void *row) {
     // Delete from current layer
     (*sdbDeleteIndexFp[pTable->keyType])(pTable->iHandle, row);
 
+    pTable->numOfDeltaRows++;
+    sdbCheckpointIfNeeded(pTable);
     code = 0;
   }
 
@@ -620,6 +705,9 @@ int sdbUpdateRow(void *handle, void *row, int updateSize, char isUpdated) {
     }
 
     sdbAddIntoUpdateList(pTable, SDB_TYPE_UPDATE, pMetaRow);
+
+    pTable->numOfDeltaRows++;
+    sdbCheckpointIfNeeded(pTable);
     code = 0;
   }
 
@@ -684,6 +772,7 @@ int sdbBatchUpdateRow(void *handle, void *row, int rowSize) {
       lseek(pTable->fd, pTable->size, SEEK_SET);
       twrite(pTable->fd, rowHead, sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM));
       pTable->size += (sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM));
+      pTable->numOfDeltaRows++;
 
       sdbAddIntoUpdateList(pTable, SDB_TYPE_UPDATE, last_row);
 
@@ -695,6 +784,7 @@ int sdbBatchUpdateRow(void *handle, void *row, int rowSize) {
     sdbFinishCommit(pTable);
 
     (*(pTable->appTool))(SDB_TYPE_AFTER_BATCH_UPDATE, pMetaRow, NULL, 0, NULL);
+    sdbCheckpointIfNeeded(pTable);
   }
   pthread_mutex_unlock(&pTable->mutex);
 
@@ -710,6 +800,18 @@ void sdbCloseTable(void *handle) {
 
   if (pTable == NULL) return;
 
+  // wait for the checkpoint in process, it uses the rows and the file of the table
+  while (1) {
+    pthread_mutex_lock(&pTable->mutex);
+    int checkpointInProcess = pTable->checkpointInProcess;
+    pthread_mutex_unlock(&pTable->mutex);
+
+    if (!checkpointInProcess) break;
+
+    sdbTrace("table:%s, still in checkpoint, wait for completed", pTable->name);
+    taosMsleep(10);
+  }
+
   while (1) {
     pNode = sdbFetchRow(handle, pNode, &row);
     if (row == NULL) break;
@@ -826,82 +928,228 @@ void sdbResetTable(SSdbTable *pTable) {
   sdbTrace("table:%s is updated, sdbVerion:%ld id:%ld", pTable->name, sdbVersion, pTable->id);
 }
 
-// TODO: A problem here : use snapshot file to sync another node will cause
-// problem
-void sdbSaveSnapShot(void *handle) {
-  SSdbTable *pTable = (SSdbTable *)handle;
-  SRowMeta * pMeta;
-  void *     pNode = NULL;
-  int        total_size = 0;
-  int        real_size = 0;
-  int        size = 0;
-  int        numOfRows = 0;
-  uint32_t   sdbEcommit = SDB_ENDCOMMIT;
-  char *     dirc = NULL;
-  char *     basec = NULL;
-  /* char       action = SDB_TYPE_INSERT; */
-
-  if (pTable == NULL) return;
+static int sdbFlushSnapShotBuffer(int fd, char *buffer, int *len) {
+  if (*len > 0 && twrite(fd, buffer, *len) != *len) return -1;
+  *len = 0;
+  return 0;
+}
 
-  sdbTrace("Table:%s, save the snapshop", pTable->name);
+/*
+ * The checkpoint is saved from a snapshot of the index, and writers are only blocked while a buffer of rows is
+ * encoded. Rows written after the snapshot are in the file after the snapshot size, they are copied to the new
+ * file as its delta log, and then the new file replaces the old one.
+ */
+static void *sdbCheckpointToFile(void *param) {
+  SSdbTable *         pTable = (SSdbTable *)param;
+  SRowMeta *          pMeta;
+  void *              pNode = NULL;
+  int                 total_size = 0;
+  int                 real_size = 0;
+  int64_t             size = 0;
+  int64_t             numOfRows = 0;
+  uint32_t            sdbEcommit = SDB_ENDCOMMIT;
+  char *              dirc = NULL;
+  char *              basec = NULL;
+  SSdbCheckpoint      checkpoint = {0};
+  SSdbCheckpointRow * pRows = NULL;
+  int                 len = 0;
+
+  sdbTrace("table:%s, start to save checkpoint", pTable->name);
 
   char fn[128] = "\0";
   dirc = strdup(pTable->fn);
   basec = strdup(pTable->fn);
   sprintf(fn, "%s/.%s", dirname(dirc), basename(basec));
-  int fd = open(fn, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+  int fd = open(fn, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU | S_IRWXG | S_IRWXO);
   tfree(dirc);
   tfree(basec);
+  if (fd < 0) {
+    sdbError("failed to open file:%s while saving SDB snapshot, sdb: %s", fn, pTable->name);
+    pthread_mutex_lock(&pTable->mutex);
+    pTable->checkpointInProcess = 0;
+    pthread_mutex_unlock(&pTable->mutex);
+    return NULL;
+  }
 
   total_size = sizeof(SRowHead) + pTable->maxRowSize + sizeof(TSCKSUM);
+  int       bufferSize = MAX(SDB_SNAPSHOT_BUFFER_SIZE, total_size + sizeof(sdbEcommit));
+  char *    buffer = malloc(bufferSize);
   SRowHead *rowHead = (SRowHead *)malloc(total_size);
-  if (rowHead == NULL) {
-    sdbError("failed to allocate memory while saving SDB snapshot, sdb: %s", pTable->name);
-    return;
-  }
-  memset(rowHead, 0, size);
+  if (buffer == NULL || rowHead == NULL) goto _error;
 
-  // Write the header
-  twrite(fd, &(pTable->header), sizeof(SSdbHeader));
-  size += sizeof(SSdbHeader);
-  twrite(fd, &sdbEcommit, sizeof(sdbEcommit));
-  size += sizeof(sdbEcommit);
+  // take a snapshot of the index, the rows are encoded later
+  pthread_mutex_lock(&pTable->mutex);
 
-  while (1) {
+  int64_t maxNumOfRows = pTable->numOfRows + 1;
+  pRows = (SSdbCheckpointRow *)malloc(sizeof(SSdbCheckpointRow) * maxNumOfRows);
+  while (pRows != NULL) {
     pNode = (*sdbFetchRowFp[pTable->keyType])(pTable->iHandle, pNode, (void **)&pMeta);
     if (pMeta == NULL) break;
 
-    rowHead->delimiter = SDB_DELIMITER;
-    rowHead->id = pMeta->id;
-    (*(pTable->appTool))(SDB_TYPE_ENCODE, pMeta->row, rowHead->data, pTable->maxRowSize, &(rowHead->rowSize));
-    real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
-    if (taosCalcChecksumAppend(0, (uint8_t *)rowHead, real_size) < 0) {
-      sdbError("failed to get checksum while save sdb %s snapshot", pTable->name);
-      tfree(rowHead);
-      return;
+    if (numOfRows >= maxNumOfRows) {
+      maxNumOfRows *= 2;
+      SSdbCheckpointRow *tmp = (SSdbCheckpointRow *)realloc(pRows, sizeof(SSdbCheckpointRow) * maxNumOfRows);
+      if (tmp == NULL) tfree(pRows);
+      pRows = tmp;
+      if (pRows == NULL) break;
     }
 
-    /* write(fd, &action, sizeof(action)); */
-    /* size += sizeof(action); */
-    twrite(fd, rowHead, real_size);
-    size += real_size;
-    twrite(fd, &sdbEcommit, sizeof(sdbEcommit));
-    size += sizeof(sdbEcommit);
+    pRows[numOfRows].id = pMeta->id;
+    pRows[numOfRows].row = pMeta->row;
     numOfRows++;
   }
 
-  tfree(rowHead);
+  int64_t snapshotSize = pTable->size;
+  int64_t numOfDeltaRows = pTable->numOfDeltaRows;
+  int     numOfUpdates = pTable->numOfUpdates;
+  checkpoint.autoIndex = pTable->autoIndex;
+  checkpoint.id = pTable->id;
+
+  pthread_mutex_unlock(&pTable->mutex);
+
+  if (pRows == NULL) goto _error;
+
+  // Write the header, and the checkpoint record is written after all rows are saved
+  memcpy(buffer, &(pTable->header), sizeof(SSdbHeader));
+  len += sizeof(SSdbHeader);
+  memcpy(buffer + len, &sdbEcommit, sizeof(sdbEcommit));
+  len += sizeof(sdbEcommit);
+  int64_t checkpointOffset = len;
+  len += sizeof(SSdbCheckpoint);
+  size = len;
+
+  // rows are encoded into the buffer under lock, and the buffer is written into file without lock
+  for (int64_t i = 0; i < numOfRows;) {
+    pthread_mutex_lock(&pTable->mutex);
+
+    // a row deleted after the snapshot is destroyed once it is pushed out of the update list
+    if (pTable->numOfUpdates < numOfUpdates || pTable->numOfUpdates - numOfUpdates >= pTable->maxRows) {
+      pthread_mutex_unlock(&pTable->mutex);
+      sdbWarn("table:%s, too many updates while saving checkpoint, try later", pTable->name);
+      goto _error;
+    }
+
+    while (i < numOfRows && bufferSize - len >= total_size + sizeof(sdbEcommit)) {
+      rowHead->delimiter = SDB_DELIMITER;
+      rowHead->id = pRows[i].id;
+      (*(pTable->appTool))(SDB_TYPE_ENCODE, pRows[i].row, rowHead->data, pTable->maxRowSize, &(rowHead->rowSize));
+      real_size = sizeof(SRowHead) + rowHead->rowSize + sizeof(TSCKSUM);
+      if (taosCalcChecksumAppend(0, (uint8_t *)rowHead, real_size) < 0) {
+        pthread_mutex_unlock(&pTable->mutex);
+        sdbError("failed to get checksum while save sdb %s snapshot", pTable->name);
+        goto _error;
+      }
+
+      memcpy(buffer + len, rowHead, real_size);
+      len += real_size;
+      size += real_size;
+      memcpy(buffer + len, &sdbEcommit, sizeof(sdbEcommit));
+      len += sizeof(sdbEcommit);
+      size += sizeof(sdbEcommit);
+      i++;
+    }
+
+    pthread_mutex_unlock(&pTable->mutex);
+
+    if (sdbFlushSnapShotBuffer(fd, buffer, &len) < 0) goto _error;
+  }
+
+  if (sdbFlushSnapShotBuffer(fd, buffer, &len) < 0) goto _error;
+
+  checkpoint.magic = SDB_CHECKPOINT;
+  checkpoint.numOfRows = numOfRows;
+  checkpoint.size = size;
+  taosCalcChecksumAppend(0, (uint8_t *)&checkpoint, sizeof(SSdbCheckpoint));
+  if (pwrite(fd, &checkpoint, sizeof(SSdbCheckpoint), checkpointOffset) != sizeof(SSdbCheckpoint)) goto _error;
+  fdatasync(fd);
+
+  // rotate the delta log, rows written after the snapshot are moved to the new file
+  pthread_mutex_lock(&pTable->mutex);
+
+  for (int64_t offset = snapshotSize; offset < pTable->size;) {
+    int bytes = (int)MIN(bufferSize, pTable->size - offset);
+    if (pread(pTable->fd, buffer, bytes, offset) != bytes || twrite(fd, buffer, bytes) != bytes) {
+      pthread_mutex_unlock(&pTable->mutex);
+      goto _error;
+    }
+
+    offset += bytes;
+    size += bytes;
+  }
+
+  fdatasync(fd);
+
+  // Rename the .sdb.db file to sdb.db file, which replaces the old file
+  if (rename(fn, pTable->fn) != 0) {
+    pthread_mutex_unlock(&pTable->mutex);
+    goto _error;
+  }
 
-  // Remove the old file
   tclose(pTable->fd);
-  remove(pTable->fn);
-  // Rename the .sdb.db file to sdb.db file
-  rename(fn, pTable->fn);
   pTable->fd = fd;
   pTable->size = size;
-  pTable->numOfRows = numOfRows;
+  pTable->numOfDeltaRows -= numOfDeltaRows;
+  pTable->checkpointInProcess = 0;
+
+  pthread_mutex_unlock(&pTable->mutex);
+
+  sdbTrace("table:%s, checkpoint is saved, rows:%ld id:%ld size:%ld delta rows:%ld", pTable->name, numOfRows,
+           checkpoint.id, size, numOfDeltaRows);
+
+  tfree(pRows);
+  tfree(buffer);
+  tfree(rowHead);
+  return NULL;
+
+_error:
+  sdbError("failed to save snapshot of sdb: %s, reason:%s", pTable->name, strerror(errno));
+  tfree(pRows);
+  tfree(buffer);
+  tfree(rowHead);
+  tclose(fd);
+  remove(fn);
+
+  pthread_mutex_lock(&pTable->mutex);
+  pTable->checkpointInProcess = 0;
+  pthread_mutex_unlock(&pTable->mutex);
+  return NULL;
+}
+
+// TODO: A problem here : use snapshot file to sync another node will cause
+// problem
+void sdbSaveSnapShot(void *handle) {
+  SSdbTable *pTable = (SSdbTable *)handle;
+  if (pTable == NULL) return;
+
+  pthread_mutex_lock(&pTable->mutex);
+  int checkpointInProcess = pTable->checkpointInProcess;
+  pTable->checkpointInProcess = 1;
+  pthread_mutex_unlock(&pTable->mutex);
+
+  if (checkpointInProcess) {
+    sdbTrace("table:%s, checkpoint is already in process", pTable->name);
+    return;
+  }
+
+  sdbCheckpointToFile(pTable);
+}
+
+void sdbCheckpointIfNeeded(SSdbTable *pTable) {
+  // this function has to be called with pTable->mutex locked
+  pthread_attr_t thattr;
+  pthread_t      thread;
+
+  if (pTable->checkpointInProcess || !sdbNeedCheckpoint(pTable)) return;
+
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&thread, &thattr, sdbCheckpointToFile, pTable) != 0) {
+    sdbError("table:%s, failed to create thread to save checkpoint, reason:%s", pTable->name, strerror(errno));
+  } else {
+    pTable->checkpointInProcess = 1;
+  }
 
-  fdatasync(pTable->fd);
+  pthread_attr_destroy(&thattr);
 }
 
 void *sdbFetchRow(void *handle, void *pNode, void **ppRow) {
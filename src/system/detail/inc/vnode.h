@@ -49,6 +49,10 @@ extern "C" {
 #define TSDB_ACTION_UPDATE 3
 #define TSDB_ACTION_MAX    4
 
+#define TSDB_COMMIT_LOG_NONE  0
+#define TSDB_COMMIT_LOG_ASYNC 1
+#define TSDB_COMMIT_LOG_SYNC  2  // group commit, submit rsp is sent after the log is synced to disk
+
 enum _data_source {
   TSDB_DATA_SOURCE_METER,
   TSDB_DATA_SOURCE_VNODE,
@@ -129,6 +133,7 @@ typedef struct {
   int64_t         dfSize;
   int64_t         lfSize;
   uint64_t *      fmagic;  // hold magic number for each file
+  int32_t         headVersion;  // increased when a head file is replaced or removed, protected by vmutex
   char            cfn[TSDB_FILENAME_LEN];
   char            nfn[TSDB_FILENAME_LEN];
   char            lfn[TSDB_FILENAME_LEN];  // last file name
@@ -144,6 +149,15 @@ typedef struct {
   int64_t         mappingSize;
   int64_t         mappingThreshold;
 
+  char *          pSync;        // commit log is synced to disk up to here
+  char            logSync;      // group commit thread is running
+  char            logSyncStop;
+  pthread_t       logSyncThread;
+  pthread_mutex_t logSyncMutex;
+  pthread_cond_t  logSyncCond;
+  void *          pSyncRspHead;  // submit rsp waiting for the commit log sync
+  void *          pSyncRspTail;
+
   void *         commitTimer;
   void **        meterList;
   void *         pCachePool;
@@ -243,11 +257,14 @@ typedef struct SColumnInfoEx {
 struct SColumnFilterElem;
 
 typedef bool (*__filter_func_t)(struct SColumnFilterElem *pFilter, char *val1, char *val2);
+typedef void (*__filter_block_func_t)(struct SColumnFilterElem *pFilter, const char *pData, int32_t numOfRows,
+                                      uint64_t *bitmap);
 
 typedef struct SColumnFilterElem {
-  int16_t           bytes;  // column length
-  __filter_func_t   fp;
-  SColumnFilterInfo filterInfo;
+  int16_t               bytes;  // column length
+  __filter_func_t       fp;
+  __filter_block_func_t blockFp;  // filter on a block of data, NULL for binary/nchar column
+  SColumnFilterInfo     filterInfo;
 } SColumnFilterElem;
 
 typedef struct SSingleColumnFilterInfo {
@@ -321,18 +338,35 @@ typedef struct {
   pthread_mutex_t qmutex;
 } STranQueue;
 
+/*
+ * time spent on each phase to open vnodes at startup, the phases are accumulated over all vnodes
+ */
+typedef struct {
+  int32_t numOfVnodes;
+  int32_t numOfThreads;
+  int64_t elapsedUs;  // wall time to open all vnodes
+  int64_t meterUs;    // load meter objects
+  int64_t cacheUs;    // allocate cache pools
+  int64_t fileUs;     // check data files
+  int64_t logUs;      // restore data from commit logs
+} SVnodeStartupInfo;
+
 // internal globals
 extern int        tsMeterSizeOnFile;
 extern uint32_t   tsRebootTime;
 extern void **    rpcQhandle;
 extern void *     dmQhandle;
 extern void *     queryQhandle;
+extern void *     commitQhandle;
 extern int        tsVnodePeers;
 extern int        tsMaxVnode;
 extern int        tsMaxQueues;
 extern int        tsOpenVnodes;
 extern SVnodeObj *vnodeList;
 extern void *     vnodeTmrCtrl;
+extern int64_t    vnodeRetrieveCompressedBytes;
+extern int64_t    vnodeRetrieveSavedBytes;
+extern SVnodeStartupInfo vnodeStartupInfo;
 
 // read API
 extern int (*vnodeSearchKeyFunc[])(char *pValue, int num, TSKEY key, int order);
@@ -353,7 +387,9 @@ bool vnodeIsValidVnodeCfg(SVnodeCfg *pCfg);
 
 int32_t vnodeGetResultSize(void *handle, int32_t *numOfRows);
 
-int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t *size);
+int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t *size, int16_t *compress);
+
+int32_t vnodeGetQueryResultIov(void *handle, int32_t numOfRows, struct iovec **pIov);
 
 int64_t vnodeGetOffsetVal(void *thandle);
 
@@ -361,7 +397,13 @@ bool vnodeHasRemainResults(void *handle);
 
 int vnodeRetrieveQueryResult(void *handle, int *pNum, char *argv[]);
 
-int vnodeSaveQueryResult(void *handle, char *data, int32_t* size);
+int vnodeSaveQueryResult(void *handle, char *data, int32_t* size, int16_t *compress);
+
+void vnodeAdvanceQueryResult(void *handle, int32_t numOfFinal);
+
+bool vnodePinQueryResult(void *handle);
+
+void vnodeUnpinQueryResult(void *handle);
 
 int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *timePrec);
 
@@ -411,6 +453,8 @@ void vnodeSetCommitQuery(SMeterObj *pObj, SQuery *pQuery);
 
 int vnodeInsertPointToCache(SMeterObj *pObj, char *pData);
 
+int vnodeInsertBlockToCache(SMeterObj *pObj, char *pData, int numOfPoints);
+
 int vnodeQueryFromCache(SMeterObj *pObj, SQuery *pQuery);
 
 uint64_t vnodeGetPoolCount(SVnodeObj *pVnode);
@@ -574,6 +618,8 @@ int vnodeRenewCommitLog(int vnode);
 
 void vnodeRemoveCommitLog(int vnode);
 
+int vnodeSendSubmitRspAfterLogSync(SVnodeObj *pVnode, SShellObj *pShell, int code, int numOfPoints);
+
 int vnodeWriteToCommitLog(SMeterObj *pObj, char action, char *cont, int contLen, int sversion);
 
 extern int (*vnodeProcessAction[])(SMeterObj *, char *, int, char, void *, int, int *, TSKEY);
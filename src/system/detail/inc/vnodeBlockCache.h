@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_VNODEBLOCKCACHE_H
+#define TDENGINE_VNODEBLOCKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * cache of decompressed column blocks of data/last files, shared by all queries of all vnodes.
+ * A block is identified by the vnode, file id, file type and offset of the compressed column data in file,
+ * and the length and checksum of the compressed data are checked before a cached block is used, since
+ * the content of the last file at the same offset is changed after commit.
+ */
+typedef struct {
+  int32_t  vnode;
+  int32_t  fileId;
+  int32_t  last;    // in last file or data file
+  int16_t  colId;
+  int64_t  offset;  // offset of the compressed column data in file
+  int32_t  len;     // length of the compressed column data
+  int32_t  numOfPoints;
+  uint32_t checksum;
+} SBlockCacheKey;
+
+int32_t vnodeInitBlockCache(int64_t size);
+
+void vnodeCleanUpBlockCache();
+
+bool vnodeBlockCacheEnabled();
+
+/**
+ * copy the cached data of the column block into dst
+ * @return  true if the block is found in cache
+ */
+bool vnodeBlockCacheGet(SBlockCacheKey *pKey, char *dst, int32_t size);
+
+void vnodeBlockCachePut(SBlockCacheKey *pKey, const char *data, int32_t size);
+
+/**
+ * drop all cached blocks of a vnode, when the files of the vnode are removed
+ */
+void vnodeBlockCacheRemoveVnode(int32_t vnode);
+
+/**
+ * get the number of hit, miss and evicted blocks since the last call
+ */
+void vnodeBlockCacheGetStatis(int32_t *hits, int32_t *misses, int32_t *evictions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_VNODEBLOCKCACHE_H
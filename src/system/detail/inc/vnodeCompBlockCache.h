@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_VNODECOMPBLOCKCACHE_H
+#define TDENGINE_VNODECOMPBLOCKCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * cache of the validated comp block info (SCompBlock[]) of meters in head files, shared by all queries of all
+ * vnodes. There is one entry for each meter in each file. An entry read from an older head file, which is
+ * identified by the head version of the vnode, is dropped when it is looked up by a query on the new file.
+ */
+typedef struct {
+  int32_t  vnode;
+  int32_t  fileId;
+  int32_t  sid;
+  uint64_t uid;
+  int32_t  headVersion;  // version of the vnode head files when the head file is opened
+} SCompBlockCacheKey;
+
+int32_t vnodeInitCompBlockCache(int64_t size);
+
+void vnodeCleanUpCompBlockCache();
+
+/**
+ * get the number of comp blocks of the meter in file, and a copy of the blocks in *ppBlocks if ppBlocks is not NULL
+ * and there are blocks, which is freed by the caller
+ * @return  -1 if the entry is not in cache
+ */
+int32_t vnodeCompBlockCacheGet(SCompBlockCacheKey *pKey, void **ppBlocks);
+
+/**
+ * numOfBlocks is 0 for the meter without data in file
+ */
+void vnodeCompBlockCachePut(SCompBlockCacheKey *pKey, const void *pBlocks, int32_t numOfBlocks);
+
+/**
+ * drop the cached entries of a file when the head file is replaced or removed, or of all files if fileId is -1
+ */
+void vnodeCompBlockCacheRemove(int32_t vnode, int32_t fileId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_VNODECOMPBLOCKCACHE_H
@@ -28,6 +28,19 @@ __filter_func_t *vnodeGetValueFilterFuncArray(int32_t type);
 
 bool vnodeSupportPrefilter(int32_t type);
 
+// number of 64-bit words of the bitmap that holds one bit for each row
+#define FILTER_BITMAP_WORDS(rows) (((rows) + 63) >> 6)
+
+__filter_block_func_t *vnodeGetRangeBlockFilterFuncArray(int32_t type);
+
+__filter_block_func_t *vnodeGetValueBlockFilterFuncArray(int32_t type);
+
+/**
+ * set the bits of rows that are not null and qualified by any filter of this column, other bits are cleared
+ */
+void vnodeFilterColumnBlock(SSingleColumnFilterInfo *pFilterInfo, const char *pData, int32_t numOfRows,
+                            uint64_t *bitmap);
+
 #ifdef __cplusplus
 }
 #endif
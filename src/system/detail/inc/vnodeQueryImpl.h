@@ -166,6 +166,7 @@ void enableFunctForMasterScan(SQueryRuntimeEnv* pRuntimeEnv, int32_t order);
 
 int32_t mergeMetersResultToOneGroups(SMeterQuerySupportObj* pSupporter);
 void copyFromGroupBuf(SQInfo* pQInfo, SOutputRes* result);
+void mergeUnitResultToGroups(SMeterQuerySupportObj* pSupporter, SOutputRes* pUnitResult);
 
 SBlockInfo getBlockBasicInfo(void* pBlock, int32_t blockType);
 SCacheBlock* getCacheDataBlock(SMeterObj* pMeterObj, SQuery* pQuery, int32_t slot);
@@ -195,6 +196,12 @@ uint32_t getDataBlocksForMeters(SMeterQuerySupportObj* pSupporter, SQuery* pQuer
 int32_t LoadDatablockOnDemand(SCompBlock* pBlock, SField** pFields, int8_t* blkStatus, SQueryRuntimeEnv* pRuntimeEnv,
                               int32_t fileIdx, int32_t slotIdx, __block_search_fn_t searchFn, bool onDemand);
 
+/**
+ * advise the kernel to read the data block into page cache asynchronously, so the disk read of the blocks to be
+ * accessed next is overlapped with the processing of current block
+ */
+void vnodePrefetchDataBlock(SQueryFileInfo* pQueryFileInfo, SCompBlock* pBlock);
+
 /**
  * Create SMeterQueryInfo.
  * The MeterQueryInfo is created one for each table during super table query
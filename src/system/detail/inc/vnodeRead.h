@@ -58,6 +58,7 @@ typedef struct SQueryFileInfo {
   int32_t defaultMappingSize; /* default mapping size */
 
   int32_t headerFd;        /* file handler */
+  int32_t headVersion;     /* version of the vnode head files when this file is opened */
   char*   pHeaderFileData; /* mmap header files */
   size_t  headFileSize;
   int32_t  dataFd;
@@ -81,6 +82,7 @@ typedef struct SQueryCostSummary {
 
   int64_t readDiskBlocks;     // accessed disk block
   int64_t skippedFileBlocks;  // skipped blocks
+  int64_t blocksByStatis;     // file blocks answered by the block statistics, without loading data
   int64_t blocksInCache;      // accessed cache blocks
 
   int64_t readField;       // field size
@@ -88,6 +90,7 @@ typedef struct SQueryCostSummary {
   double  loadFieldUs;     // total elapsed time to read fields info
 
   int64_t totalBlockSize;  // read data blocks
+  int64_t totalRowSize;    // size of all columns of the read data blocks, as the whole rows are read
   double  loadBlocksUs;    // total elapsed time to read data blocks
 
   int64_t totalGenData;  // in-memory generated data
@@ -132,6 +135,14 @@ typedef struct RuntimeEnvironment {
   SQueryFileInfo* pHeaderFiles;
   uint32_t        numOfFiles; /* number of files of one vnode during query execution */
 
+  /*
+   * the next block that moveToNextBlock will ask the kernel to read ahead, so each block in the window of
+   * tsNumOfPrefetchBlocks is advised only once
+   */
+  SMeterObj* pPrefetchMeter;
+  int32_t    prefetchFileId;
+  int32_t    prefetchSlot;
+
   int16_t numOfRowsPerPage;
   int16_t offset[TSDB_MAX_COLUMNS];
 
@@ -145,6 +156,14 @@ typedef struct RuntimeEnvironment {
   STSBuf*           pTSBuf;
   STSCursor         cur;
   SQueryCostSummary summary;
+
+  /*
+   * qualified rows of the value filter are gathered into pFilteredData for all required columns, so the
+   * functions are applied on them block-wisely
+   */
+  uint64_t* pFilterBitmap;
+  char*     pFilteredData;
+  int32_t   filteredBufRows;  // number of rows that the pFilteredData can hold
 } SQueryRuntimeEnv;
 
 /* intermediate result during multimeter query involves interval */
@@ -207,6 +226,15 @@ typedef struct SMeterQuerySupportObj {
    */
   int32_t meterIdx;
 
+  /*
+   * the meters in range [meterStartIdx, meterEndIdx) of pSidSet are scanned by this query.
+   * A super table query may be split into several units, each of which scans a disjoint range of meters.
+   */
+  int32_t meterStartIdx;
+  int32_t meterEndIdx;
+
+  struct SQueryParallelInfo* pParallelInfo;
+
   int32_t meterOutputFd;
   int32_t lastPageId;
   int32_t numOfPages;
@@ -236,6 +264,7 @@ typedef struct _qinfo {
   int64_t        useconds;
   int            killed;
   struct _qinfo *prev, *next;
+  struct _qinfo *pParent;  // the query that a parallel query unit belongs to
 
   SQuery     query;
   int        num;
@@ -247,6 +276,7 @@ typedef struct _qinfo {
   char       bufIndex;
   char       changed;
   char       over;
+  char       inSend;  // the output buffer is being sent in place, see vnodePinQueryResult
   SMeterObj* pObj;
 
   int (*fp)(SMeterObj*, SQuery*);
@@ -256,6 +286,23 @@ typedef struct _qinfo {
 
 } SQInfo;
 
+#define TSDB_MIN_METERS_PER_QUERY_UNIT 64
+
+/*
+ * units of a super table query that are executed by query threads in parallel. Each unit is a
+ * SQInfo scanning a disjoint range of meters, and pUnits[0] is the query itself, into which the
+ * partial results of other units are merged when all units are completed.
+ */
+typedef struct SQueryParallelInfo {
+  int32_t         numOfUnits;
+  int32_t         nextUnit;   // the next unit to be claimed by a query thread
+  int32_t         completed;  // number of completed units
+  int32_t         refCount;   // the query and each scheduled task hold a reference
+  SQInfo**        pUnits;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+} SQueryParallelInfo;
+
 int32_t vnodeQuerySingleMeterPrepare(SQInfo* pQInfo, SMeterObj* pMeterObj, SMeterQuerySupportObj* pSMultiMeterObj,
                                      void* param);
 
@@ -280,6 +327,8 @@ void vnodeSingleMeterQuery(SSchedMsg* pMsg);
  */
 void vnodeMultiMeterQuery(SSchedMsg* pMsg);
 
+void vnodeReleaseQueryParallelInfo(SQueryParallelInfo* pParallelInfo);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@ typedef struct {
   int      numOfTotalPoints;  // track the total number of points imported
   void *   thandle;           // handle from TAOS layer
   void *   qhandle;
+  uint32_t generation;        // increased when the connection is created or gone, since the object is reused
 } SShellObj;
 
 #ifdef __cplusplus
@@ -70,6 +70,13 @@ int32_t vnodeCreateFilterInfo(void* pQInfo, SQuery *pQuery);
 bool vnodeFilterData(SQuery* pQuery, int32_t* numOfActualRead, int32_t index);
 bool vnodeDoFilterData(SQuery* pQuery, int32_t elemPos);
 
+/**
+ * filter rows in [start, start + numOfRows) of all filter columns, the qualified rows are set in the bitmap
+ * @param colBitmap   buffer for the bitmap of each column, of the same size as bitmap
+ * @return            the number of qualified rows
+ */
+int32_t vnodeFilterDataBlock(SQuery* pQuery, int32_t start, int32_t numOfRows, uint64_t* bitmap, uint64_t* colBitmap);
+
 bool vnodeIsProjectionQuery(SSqlFunctionExpr *pExpr, int32_t numOfOutput);
 
 int32_t vnodeIncQueryRefCount(SQueryMeterMsg *pQueryMsg, SMeterSidExtInfo **pSids, SMeterObj **pMeterObjList,
@@ -24,7 +24,9 @@
 #include "monitorSystem.h"
 #include "tcrc32c.h"
 #include "tglobalcfg.h"
+#include "tsimd.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Woverflow"
@@ -39,6 +41,7 @@ bool            tsDnodeStopping = false;
 
 int  dnodeCheckConfig();
 void dnodeCountRequest(SCountInfo *info);
+void dnodeGetStartupInfo(char *content, int len);
 
 void dnodeInitModules() {
   tsModule[TSDB_MOD_MGMT].name = "mgmt";
@@ -113,6 +116,7 @@ int dnodeInitSystem() {
   struct stat dirstat;
 
   taosResolveCRC();
+  taosResolveSIMD();
 
   tsRebootTime = taosGetTimestampSec();
   tscEmbedded = 1;
@@ -168,6 +172,7 @@ int dnodeInitSystem() {
   }
 
   monitorCountReqFp = dnodeCountRequest;
+  monitorStartupInfoFp = dnodeGetStartupInfo;
 
   dnodeStartModuleSpec();
 
@@ -216,6 +221,14 @@ void dnodeCountRequest(SCountInfo *info) {
   httpGetReqCount(&info->httpReqNum);
   info->selectReqNum = atomic_exchange_32(&vnodeSelectReqNum, 0);
   info->insertReqNum = atomic_exchange_32(&vnodeInsertReqNum, 0);
+  vnodeBlockCacheGetStatis(&info->blockCacheHits, &info->blockCacheMisses, &info->blockCacheEvictions);
+}
+
+void dnodeGetStartupInfo(char *content, int len) {
+  SVnodeStartupInfo *pInfo = &vnodeStartupInfo;
+  snprintf(content, len, "vnodes:%d opened by %d threads in %ldms, meters:%ld cache:%ld files:%ld logs:%ld",
+           pInfo->numOfVnodes, pInfo->numOfThreads, pInfo->elapsedUs / 1000, pInfo->meterUs / 1000,
+           pInfo->cacheUs / 1000, pInfo->fileUs / 1000, pInfo->logUs / 1000);
 }
 
 #pragma GCC diagnostic pop
\ No newline at end of file
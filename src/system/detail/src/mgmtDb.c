@@ -146,7 +146,7 @@ int mgmtCheckDbParams(SCreateDbMsg *pCreate) {
     return TSDB_CODE_INVALID_OPTION;
   }
 
-  if (pCreate->commitLog < 0 || pCreate->commitLog > 1) {
+  if (pCreate->commitLog < 0 || pCreate->commitLog > 2) {
     mTrace("invalid db option commitLog: %d", pCreate->commitLog);
     return TSDB_CODE_INVALID_OPTION;
   }
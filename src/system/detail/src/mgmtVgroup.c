@@ -150,7 +150,11 @@ SVgObj *mgmtCreateVgroup(SDbObj *pDb) {
     return NULL;
   }
 
-  sdbInsertRow(vgSdb, pVgroup, 0);
+  if (sdbInsertRow(vgSdb, pVgroup, 0) < 0) {
+    mError("db:%s, failed to insert vgroup into sdb", pDb->name);
+    free(pVgroup);
+    return NULL;
+  }
 
   mTrace("vgroup:%d, vgroup is created, db:%s replica:%d", pVgroup->vgId, pDb->name, pVgroup->numOfVnodes);
   for (int i = 0; i < pVgroup->numOfVnodes; ++i)
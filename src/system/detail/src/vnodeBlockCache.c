@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tclockcache.h"
+#include "tlog.h"
+#include "vnode.h"
+#include "vnodeBlockCache.h"
+
+#define BLOCK_CACHE_BUCKETS 1024  // hash buckets of each stripe
+
+/*
+ * the blocks are kept in a striped CLOCK cache, so query threads reading different blocks rarely contend, and the
+ * blocks only read once by a scan are evicted before the blocks that are queried repeatedly
+ */
+static void *blockCache = NULL;
+
+typedef struct {
+  SBlockCacheKey *pKey;
+  char *          dst;
+  int32_t         size;
+} SBlockCacheGetParam;
+
+static uint32_t vnodeBlockCacheHash(const void *key) {
+  const SBlockCacheKey *pKey = (const SBlockCacheKey *)key;
+
+  uint64_t h = (uint64_t)pKey->offset * 0x9E3779B97F4A7C15ULL;
+  h ^= ((uint64_t)pKey->vnode << 40) ^ ((uint64_t)pKey->fileId << 8) ^ (uint64_t)pKey->last;
+  h *= 0xFF51AFD7ED558CCDULL;
+  return (uint32_t)(h >> 32);
+}
+
+static bool vnodeBlockCacheSamePos(const void *key1, const void *key2) {
+  const SBlockCacheKey *pKey1 = (const SBlockCacheKey *)key1;
+  const SBlockCacheKey *pKey2 = (const SBlockCacheKey *)key2;
+
+  return pKey1->offset == pKey2->offset && pKey1->vnode == pKey2->vnode && pKey1->fileId == pKey2->fileId &&
+         pKey1->last == pKey2->last;
+}
+
+static bool vnodeBlockCacheSameData(const SBlockCacheKey *pKey1, const SBlockCacheKey *pKey2) {
+  return pKey1->colId == pKey2->colId && pKey1->len == pKey2->len && pKey1->numOfPoints == pKey2->numOfPoints &&
+         pKey1->checksum == pKey2->checksum;
+}
+
+static int32_t vnodeBlockCacheCopyOut(const void *cachedKey, const char *data, int32_t size, void *param) {
+  SBlockCacheGetParam *pParam = (SBlockCacheGetParam *)param;
+
+  // the file is rewritten since the block is cached
+  if (!vnodeBlockCacheSameData((const SBlockCacheKey *)cachedKey, pParam->pKey) || size != pParam->size) {
+    return TAOS_CLOCK_CACHE_DROP;
+  }
+
+  memcpy(pParam->dst, data, (size_t)size);
+  return TAOS_CLOCK_CACHE_HIT;
+}
+
+static bool vnodeBlockCacheOfVnode(const void *cachedKey, void *param) {
+  return ((const SBlockCacheKey *)cachedKey)->vnode == *(int32_t *)param;
+}
+
+int32_t vnodeInitBlockCache(int64_t size) {
+  if (size <= 0) {
+    dPrint("block cache is disabled");
+    return 0;
+  }
+
+  blockCache = taosInitClockCache(size, BLOCK_CACHE_BUCKETS, sizeof(SBlockCacheKey), vnodeBlockCacheHash,
+                                  vnodeBlockCacheSamePos);
+  if (blockCache == NULL) return -1;
+
+  dPrint("block cache is initialized, size:%ld", size);
+  return 0;
+}
+
+void vnodeCleanUpBlockCache() {
+  void *pCache = blockCache;
+
+  blockCache = NULL;
+  taosCleanUpClockCache(pCache);
+}
+
+bool vnodeBlockCacheEnabled() { return blockCache != NULL; }
+
+bool vnodeBlockCacheGet(SBlockCacheKey *pKey, char *dst, int32_t size) {
+  SBlockCacheGetParam param = {.pKey = pKey, .dst = dst, .size = size};
+  return taosGetFromClockCache(blockCache, pKey, vnodeBlockCacheCopyOut, &param) == TAOS_CLOCK_CACHE_HIT;
+}
+
+void vnodeBlockCachePut(SBlockCacheKey *pKey, const char *data, int32_t size) {
+  taosPutIntoClockCache(blockCache, pKey, data, size, NULL);
+}
+
+void vnodeBlockCacheRemoveVnode(int32_t vnode) {
+  if (blockCache == NULL) return;
+
+  taosRemoveFromClockCache(blockCache, vnodeBlockCacheOfVnode, &vnode);
+}
+
+void vnodeBlockCacheGetStatis(int32_t *hits, int32_t *misses, int32_t *evictions) {
+  if (blockCache == NULL) {
+    *hits = *misses = *evictions = 0;
+    return;
+  }
+
+  taosGetClockCacheStatis(blockCache, hits, misses, evictions);
+}
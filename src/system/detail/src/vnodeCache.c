@@ -477,38 +477,84 @@ int vnodeAllocateCacheBlock(SMeterObj *pObj) {
   return commit;
 }
 
-int vnodeInsertPointToCache(SMeterObj *pObj, char *pData) {
+/*
+ * copy one column of numOfRows rows from the row-wise submit payload into the cache block column,
+ * the common fixed sizes are copied by type to avoid a memcpy call per value
+ */
+static void vnodeTransposeColumn(char *dst, char *src, int16_t bytes, int32_t rowSize, int32_t numOfRows) {
+  switch (bytes) {
+    case 1:
+      for (int32_t i = 0; i < numOfRows; ++i, src += rowSize) dst[i] = *src;
+      break;
+    case 2:
+      for (int32_t i = 0; i < numOfRows; ++i, src += rowSize) ((int16_t *)dst)[i] = *(int16_t *)src;
+      break;
+    case 4:
+      for (int32_t i = 0; i < numOfRows; ++i, src += rowSize) ((int32_t *)dst)[i] = *(int32_t *)src;
+      break;
+    case 8:
+      for (int32_t i = 0; i < numOfRows; ++i, src += rowSize) ((int64_t *)dst)[i] = *(int64_t *)src;
+      break;
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i, src += rowSize, dst += bytes) memcpy(dst, src, bytes);
+      break;
+  }
+}
+
+/*
+ * insert numOfPoints consecutive rows of the submit payload into cache. Rows are transposed into the
+ * cache block columns one column at a time, a new cache block is allocated whenever the current one is
+ * full. The numOfPoints of a cache block is updated only after all its columns are written, so the
+ * query threads never see a partially copied row.
+ *
+ * return the number of points inserted, it is less than numOfPoints if no cache block is available
+ */
+int vnodeInsertBlockToCache(SMeterObj *pObj, char *pData, int numOfPoints) {
   SCacheBlock *pCacheBlock;
   SCacheInfo * pInfo;
   SCachePool * pPool;
+  int          points = 0;
 
   pInfo = (SCacheInfo *)pObj->pCache;
   pPool = (SCachePool *)vnodeList[pObj->vnode].pCachePool;
 
-  if (pInfo->numOfBlocks == 0) {
-    if (vnodeAllocateCacheBlock(pObj) < 0) {
-      return -1;
+  while (points < numOfPoints) {
+    if (pInfo->numOfBlocks == 0) {
+      if (vnodeAllocateCacheBlock(pObj) < 0) break;
     }
-  }
 
-  if (pInfo->currentSlot < 0) return -1;
-  pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
-  if (pCacheBlock->numOfPoints >= pObj->pointsPerBlock) {
-    if (vnodeAllocateCacheBlock(pObj) < 0) return -1;
+    if (pInfo->currentSlot < 0) break;
     pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    if (pCacheBlock->numOfPoints >= pObj->pointsPerBlock) {
+      if (vnodeAllocateCacheBlock(pObj) < 0) break;
+      pCacheBlock = pInfo->cacheBlocks[pInfo->currentSlot];
+    }
+
+    int rows = MIN(numOfPoints - points, pObj->pointsPerBlock - pCacheBlock->numOfPoints);
+
+    char *pCol = pData;
+    for (int col = 0; col < pObj->numOfColumns; ++col) {
+      int16_t bytes = pObj->schema[col].bytes;
+      vnodeTransposeColumn(pCacheBlock->offset[col] + pCacheBlock->numOfPoints * bytes, pCol, bytes,
+                           pObj->bytesPerPoint, rows);
+      pCol += bytes;
+    }
+
+    pCacheBlock->numOfPoints += rows;
+    pData += rows * pObj->bytesPerPoint;
+    points += rows;
   }
 
-  for (int col = 0; col < pObj->numOfColumns; ++col) {
-    memcpy(pCacheBlock->offset[col] + pCacheBlock->numOfPoints * pObj->schema[col].bytes, pData,
-           pObj->schema[col].bytes);
-    pData += pObj->schema[col].bytes;
+  if (points > 0) {
+    atomic_fetch_sub_32(&pObj->freePoints, points);
+    pPool->count += points;
   }
 
-  atomic_fetch_sub_32(&pObj->freePoints, 1);
-  pCacheBlock->numOfPoints++;
-  pPool->count++;
+  return points;
+}
 
-  return 0;
+int vnodeInsertPointToCache(SMeterObj *pObj, char *pData) {
+  return (vnodeInsertBlockToCache(pObj, pData, 1) == 1) ? 0 : -1;
 }
 
 void vnodeUpdateQuerySlotPos(SCacheInfo *pInfo, SQuery *pQuery) {
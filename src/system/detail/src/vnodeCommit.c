@@ -28,6 +28,179 @@ typedef struct {
   int  simpleCheck:24;
 } SCommitHead;
 
+typedef struct _sync_rsp {
+  SShellObj *       pShell;
+  void *            thandle;     // the connection and generation of the shell when the submit is received,
+  uint32_t          generation;  // since the shell object may be reused by a new connection before log sync
+  int               code;
+  int               numOfPoints;
+  struct _sync_rsp *next;
+} SSyncRsp;
+
+extern int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints);
+extern int vnodeSendShellSubmitRspIfConnected(SShellObj *pObj, void *thandle, uint32_t generation, int code,
+                                              int numOfPoints);
+
+static void vnodeSendSyncRspList(SSyncRsp *pRsp, int code) {
+  while (pRsp) {
+    SSyncRsp * pNext = pRsp->next;
+    SShellObj *pShell = pRsp->pShell;
+    if (vnodeSendShellSubmitRspIfConnected(pShell, pRsp->thandle, pRsp->generation,
+                                           (code != TSDB_CODE_SUCCESS) ? code : pRsp->code, pRsp->numOfPoints) < 0) {
+      dTrace("vid:%d sid:%d, shell connection is gone, submit rsp is discarded", pShell->vnode, pShell->sid);
+    }
+    free(pRsp);
+    pRsp = pNext;
+  }
+}
+
+/*
+ * sync the written part of the commit log to disk, and send the rsp of all submits waiting for it.
+ * logSyncMutex shall be locked, so the mapping is not renewed during msync
+ */
+static int vnodeSyncCommitLogImpl(SVnodeObj *pVnode, SSyncRsp **pRspList) {
+  pthread_mutex_lock(&(pVnode->logMutex));
+  *pRspList = (SSyncRsp *)pVnode->pSyncRspHead;
+  pVnode->pSyncRspHead = NULL;
+  pVnode->pSyncRspTail = NULL;
+  char *pStart = pVnode->pSync;
+  char *pEnd = pVnode->pWrite;
+  pthread_mutex_unlock(&(pVnode->logMutex));
+
+  if (pStart == NULL || pEnd <= pStart) return TSDB_CODE_SUCCESS;
+
+  // msync requires the address is aligned to page size
+  int64_t pageSize = sysconf(_SC_PAGESIZE);
+  char *  pAligned = pVnode->pMem + ((pStart - pVnode->pMem) / pageSize) * pageSize;
+  if (msync(pAligned, pEnd - pAligned, MS_SYNC) != 0) {
+    dError("vid:%d, failed to sync commit log, reason:%s", pVnode->vnode, strerror(errno));
+    return TSDB_CODE_INVALID_COMMIT_LOG;
+  }
+
+  pthread_mutex_lock(&(pVnode->logMutex));
+  pVnode->pSync = pEnd;
+  pthread_mutex_unlock(&(pVnode->logMutex));
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void vnodeSyncCommitLog(SVnodeObj *pVnode) {
+  SSyncRsp *pRspList = NULL;
+
+  pthread_mutex_lock(&(pVnode->logSyncMutex));
+  int code = vnodeSyncCommitLogImpl(pVnode, &pRspList);
+  pthread_mutex_unlock(&(pVnode->logSyncMutex));
+
+  vnodeSendSyncRspList(pRspList, code);
+}
+
+/*
+ * group commit: wait for the first submit rsp, then for at most tsCommitLogSyncTime ms for more submits or
+ * until tsCommitLogSyncBytes are written, then all of them are synced to disk by one msync
+ */
+static void *vnodeSyncCommitLogThread(void *param) {
+  SVnodeObj *pVnode = (SVnodeObj *)param;
+
+  while (1) {
+    pthread_mutex_lock(&(pVnode->logMutex));
+    while (pVnode->pSyncRspHead == NULL && !pVnode->logSyncStop) {
+      pthread_cond_wait(&(pVnode->logSyncCond), &(pVnode->logMutex));
+    }
+
+    if (pVnode->pSyncRspHead == NULL) {  // stopped and nothing left
+      pthread_mutex_unlock(&(pVnode->logMutex));
+      break;
+    }
+
+    struct timeval  now;
+    struct timespec deadline;
+    gettimeofday(&now, NULL);
+    int64_t nsec = (int64_t)now.tv_usec * 1000 + (int64_t)tsCommitLogSyncTime * 1000000;
+    deadline.tv_sec = now.tv_sec + nsec / 1000000000;
+    deadline.tv_nsec = nsec % 1000000000;
+
+    while (!pVnode->logSyncStop && pVnode->pWrite - pVnode->pSync < tsCommitLogSyncBytes) {
+      if (pthread_cond_timedwait(&(pVnode->logSyncCond), &(pVnode->logMutex), &deadline) == ETIMEDOUT) break;
+    }
+    pthread_mutex_unlock(&(pVnode->logMutex));
+
+    vnodeSyncCommitLog(pVnode);
+  }
+
+  dTrace("vid:%d, commit log sync thread is stopped", pVnode->vnode);
+  return NULL;
+}
+
+static void vnodeStartCommitLogSync(SVnodeObj *pVnode) {
+  pthread_attr_t thattr;
+
+  pthread_mutex_init(&(pVnode->logSyncMutex), NULL);
+  pthread_cond_init(&(pVnode->logSyncCond), NULL);
+  pVnode->pSync = pVnode->pWrite;
+  pVnode->logSyncStop = 0;
+
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+  if (pthread_create(&(pVnode->logSyncThread), &thattr, vnodeSyncCommitLogThread, pVnode) != 0) {
+    dError("vid:%d, failed to create commit log sync thread, reason:%s", pVnode->vnode, strerror(errno));
+    pthread_cond_destroy(&(pVnode->logSyncCond));
+    pthread_mutex_destroy(&(pVnode->logSyncMutex));
+  } else {
+    pVnode->logSync = 1;
+    dTrace("vid:%d, commit log sync thread is created, syncTime:%dms syncBytes:%d", pVnode->vnode,
+           tsCommitLogSyncTime, tsCommitLogSyncBytes);
+  }
+
+  pthread_attr_destroy(&thattr);
+}
+
+static void vnodeStopCommitLogSync(SVnodeObj *pVnode) {
+  if (!pVnode->logSync) return;
+
+  pthread_mutex_lock(&(pVnode->logMutex));
+  pVnode->logSyncStop = 1;
+  pthread_cond_signal(&(pVnode->logSyncCond));
+  pthread_mutex_unlock(&(pVnode->logMutex));
+
+  pthread_join(pVnode->logSyncThread, NULL);
+  pVnode->logSync = 0;
+
+  pthread_cond_destroy(&(pVnode->logSyncCond));
+  pthread_mutex_destroy(&(pVnode->logSyncMutex));
+}
+
+int vnodeSendSubmitRspAfterLogSync(SVnodeObj *pVnode, SShellObj *pShell, int code, int numOfPoints) {
+  SSyncRsp *pRsp = (SSyncRsp *)malloc(sizeof(SSyncRsp));
+  if (pRsp == NULL) {
+    dError("vid:%d, no memory for submit rsp, sync commit log at once", pVnode->vnode);
+    vnodeSyncCommitLog(pVnode);
+    return vnodeSendShellSubmitRspMsg(pShell, code, numOfPoints);
+  }
+
+  pRsp->pShell = pShell;
+  pRsp->thandle = pShell->thandle;
+  pRsp->generation = pShell->generation;
+  pRsp->code = code;
+  pRsp->numOfPoints = numOfPoints;
+  pRsp->next = NULL;
+
+  // the records of this submit are already written, so they are in front of pWrite
+  pthread_mutex_lock(&(pVnode->logMutex));
+  if (pVnode->pSyncRspTail) {
+    ((SSyncRsp *)pVnode->pSyncRspTail)->next = pRsp;
+  } else {
+    pVnode->pSyncRspHead = pRsp;
+  }
+  pVnode->pSyncRspTail = pRsp;
+
+  if (pVnode->pSyncRspHead == pRsp || pVnode->pWrite - pVnode->pSync >= tsCommitLogSyncBytes) {
+    pthread_cond_signal(&(pVnode->logSyncCond));
+  }
+  pthread_mutex_unlock(&(pVnode->logMutex));
+
+  return 0;
+}
+
 int vnodeOpenCommitLog(int vnode, uint64_t firstV) {
   SVnodeObj *pVnode = vnodeList + vnode;
   char *     fileName = pVnode->logFn;
@@ -78,6 +251,14 @@ int vnodeRenewCommitLog(int vnode) {
   SVnodeObj *pVnode = vnodeList + vnode;
   char *     fileName = pVnode->logFn;
   char *     oldName = pVnode->logOFn;
+  SSyncRsp * pRspList = NULL;
+  int        code = TSDB_CODE_SUCCESS;
+
+  // the waiting submits shall be synced before the old log is unmapped
+  if (pVnode->logSync) {
+    pthread_mutex_lock(&(pVnode->logSyncMutex));
+    code = vnodeSyncCommitLogImpl(pVnode, &pRspList);
+  }
 
   pthread_mutex_lock(&(pVnode->logMutex));
 
@@ -88,17 +269,25 @@ int vnodeRenewCommitLog(int vnode) {
   }
 
   if (pVnode->cfg.commitLog) vnodeOpenCommitLog(vnode, vnodeList[vnode].version);
+  pVnode->pSync = pVnode->pWrite;
 
   pthread_mutex_unlock(&(pVnode->logMutex));
 
+  if (pVnode->logSync) {
+    pthread_mutex_unlock(&(pVnode->logSyncMutex));
+    vnodeSendSyncRspList(pRspList, code);
+  }
+
   return pVnode->logFd;
 }
 
 void vnodeRemoveCommitLog(int vnode) { remove(vnodeList[vnode].logOFn); }
 
 size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
-  int    fd, ret;
+  int    fd = -1;
   char * cont = NULL;
+  char * pMem = MAP_FAILED;
+  size_t fileSize = 0;
   size_t totalLen = 0;
   int    actions = 0;
 
@@ -122,11 +311,21 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
     goto _error;
   }
 
-  ret = read(fd, firstV, sizeof(pVnode->version));
-  if (ret <= 0) {
+  fileSize = (size_t)fstat.st_size;
+  if (fileSize < sizeof(pVnode->version)) {
     dError("vid:%d, failed to read version", vnode);
     goto _error;
   }
+
+  // the log is parsed in memory, instead of reading it record by record
+  pMem = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (pMem == MAP_FAILED) {
+    dError("vid:%d, failed to mmap:%s, reason:%s", vnode, fileName, strerror(errno));
+    goto _error;
+  }
+  madvise(pMem, fileSize, MADV_SEQUENTIAL);
+
+  memcpy(firstV, pMem, sizeof(pVnode->version));
   pVnode->version = *firstV;
 
   int32_t bufLen = TSDB_PAYLOAD_SIZE;
@@ -139,10 +338,12 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
 
   SCommitHead head;
   int simpleCheck = 0;
+  size_t pos = sizeof(pVnode->version);
   while (1) {
-    ret = read(fd, &head, sizeof(head));
-    if (ret < 0) goto _error;
-    if (ret == 0) break;
+    if (fileSize - pos < sizeof(head)) break;
+    memcpy(&head, pMem + pos, sizeof(head));
+    pos += sizeof(head);
+
     if (((head.sversion+head.sid+head.contLen+head.action) & 0xFFFFFF) != head.simpleCheck) break;
     simpleCheck = head.simpleCheck;
 
@@ -156,7 +357,13 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
           bufLen = head.contLen+sizeof(simpleCheck);
         }
 
-        if (read(fd, cont, head.contLen+sizeof(simpleCheck)) < 0) goto _error;
+        // the last record is not completely written
+        if (fileSize - pos < head.contLen + sizeof(simpleCheck)) break;
+
+        // the content is copied out, since it may be modified during processing
+        memcpy(cont, pMem + pos, head.contLen+sizeof(simpleCheck));
+        pos += head.contLen + sizeof(simpleCheck);
+
         if (*(int *)(cont+head.contLen) != simpleCheck) break;
         SMeterObj *pObj = pVnode->meterList[head.sid];
         if (pObj == NULL) {
@@ -183,6 +390,7 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
     totalLen += sizeof(head) + head.contLen + sizeof(simpleCheck);
   }
 
+  munmap(pMem, fileSize);
   tclose(fd);
   tfree(cont);
   dTrace("vid:%d, %d pieces of uncommitted data are restored", vnode, actions);
@@ -190,6 +398,7 @@ size_t vnodeRestoreDataFromLog(int vnode, char *fileName, uint64_t *firstV) {
   return totalLen;
 
 _error:
+  if (pMem != MAP_FAILED) munmap(pMem, fileSize);
   tclose(fd);
   tfree(cont);
   dError("vid:%d, failed to restore %s, remove this node...", vnode, fileName);
@@ -235,6 +444,7 @@ int vnodeInitCommit(int vnode) {
   }
 
   pVnode->pWrite += size;
+  if (pVnode->cfg.commitLog == TSDB_COMMIT_LOG_SYNC) vnodeStartCommitLogSync(pVnode);
   dTrace("vid:%d, commit log is initialized", vnode);
 
   return 0;
@@ -243,6 +453,8 @@ int vnodeInitCommit(int vnode) {
 void vnodeCleanUpCommit(int vnode) {
   SVnodeObj *pVnode = vnodeList + vnode;
 
+  vnodeStopCommitLogSync(pVnode);
+
   if (VALIDFD(pVnode->logFd)) close(pVnode->logFd);
 
   if (pVnode->cfg.commitLog && (pVnode->logFd > 0 && remove(pVnode->logFn) < 0)) {
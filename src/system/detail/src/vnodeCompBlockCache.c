@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tclockcache.h"
+#include "tlog.h"
+#include "vnode.h"
+#include "vnodeCompBlockCache.h"
+#include "vnodeFile.h"
+
+#define COMP_BLOCK_CACHE_BUCKETS 4096  // hash buckets of each stripe
+
+// the entries are kept in a striped CLOCK cache, as what vnodeBlockCache does
+static void *compBlockCache = NULL;
+
+typedef struct {
+  SCompBlockCacheKey *pKey;
+  void **             ppBlocks;
+  int32_t             numOfBlocks;
+} SCompBlockCacheGetParam;
+
+static uint32_t vnodeCompBlockCacheHash(const void *key) {
+  const SCompBlockCacheKey *pKey = (const SCompBlockCacheKey *)key;
+
+  uint64_t h = ((uint64_t)pKey->vnode << 48) ^ ((uint64_t)pKey->fileId << 24) ^ (uint64_t)pKey->sid;
+  h *= 0xFF51AFD7ED558CCDULL;
+  return (uint32_t)(h >> 32);
+}
+
+static bool vnodeCompBlockCacheSamePos(const void *key1, const void *key2) {
+  const SCompBlockCacheKey *pKey1 = (const SCompBlockCacheKey *)key1;
+  const SCompBlockCacheKey *pKey2 = (const SCompBlockCacheKey *)key2;
+
+  return pKey1->sid == pKey2->sid && pKey1->fileId == pKey2->fileId && pKey1->vnode == pKey2->vnode;
+}
+
+static int32_t vnodeCompBlockCacheCopyOut(const void *cachedKey, const char *data, int32_t size, void *param) {
+  const SCompBlockCacheKey *pCached = (const SCompBlockCacheKey *)cachedKey;
+  SCompBlockCacheGetParam * pParam = (SCompBlockCacheGetParam *)param;
+  int32_t                   numOfBlocks = size / (int32_t)sizeof(SCompBlock);
+
+  if (pCached->headVersion != pParam->pKey->headVersion || pCached->uid != pParam->pKey->uid) {
+    // the head file is replaced, or the meter is dropped, since the entry is cached
+    if (pCached->headVersion < pParam->pKey->headVersion || pCached->uid != pParam->pKey->uid) {
+      return TAOS_CLOCK_CACHE_DROP;
+    }
+
+    return TAOS_CLOCK_CACHE_MISS;
+  }
+
+  if (pParam->ppBlocks != NULL) {
+    void *pBlocks = NULL;
+    if (numOfBlocks > 0) {
+      pBlocks = malloc((size_t)size);
+      if (pBlocks == NULL) return TAOS_CLOCK_CACHE_MISS;
+
+      memcpy(pBlocks, data, (size_t)size);
+    }
+
+    *pParam->ppBlocks = pBlocks;
+  }
+
+  pParam->numOfBlocks = numOfBlocks;
+  return TAOS_CLOCK_CACHE_HIT;
+}
+
+// a query still on the older head file does not replace the entry of the new one
+static bool vnodeCompBlockCacheReplace(const void *cachedKey, const void *key) {
+  return ((const SCompBlockCacheKey *)cachedKey)->headVersion <= ((const SCompBlockCacheKey *)key)->headVersion;
+}
+
+static bool vnodeCompBlockCacheOfFile(const void *cachedKey, void *param) {
+  const SCompBlockCacheKey *pCached = (const SCompBlockCacheKey *)cachedKey;
+  const SCompBlockCacheKey *pKey = (const SCompBlockCacheKey *)param;
+
+  return pCached->vnode == pKey->vnode && (pKey->fileId < 0 || pCached->fileId == pKey->fileId);
+}
+
+int32_t vnodeInitCompBlockCache(int64_t size) {
+  if (size <= 0) {
+    dPrint("comp block cache is disabled");
+    return 0;
+  }
+
+  compBlockCache = taosInitClockCache(size, COMP_BLOCK_CACHE_BUCKETS, sizeof(SCompBlockCacheKey),
+                                      vnodeCompBlockCacheHash, vnodeCompBlockCacheSamePos);
+  if (compBlockCache == NULL) return -1;
+
+  dPrint("comp block cache is initialized, size:%ld", size);
+  return 0;
+}
+
+void vnodeCleanUpCompBlockCache() {
+  void *pCache = compBlockCache;
+
+  compBlockCache = NULL;
+  taosCleanUpClockCache(pCache);
+}
+
+int32_t vnodeCompBlockCacheGet(SCompBlockCacheKey *pKey, void **ppBlocks) {
+  if (compBlockCache == NULL) return -1;
+
+  SCompBlockCacheGetParam param = {.pKey = pKey, .ppBlocks = ppBlocks, .numOfBlocks = -1};
+  taosGetFromClockCache(compBlockCache, pKey, vnodeCompBlockCacheCopyOut, &param);
+
+  return param.numOfBlocks;
+}
+
+void vnodeCompBlockCachePut(SCompBlockCacheKey *pKey, const void *pBlocks, int32_t numOfBlocks) {
+  if (compBlockCache == NULL) return;
+
+  taosPutIntoClockCache(compBlockCache, pKey, pBlocks, (int32_t)sizeof(SCompBlock) * numOfBlocks,
+                        vnodeCompBlockCacheReplace);
+}
+
+void vnodeCompBlockCacheRemove(int32_t vnode, int32_t fileId) {
+  if (compBlockCache == NULL) return;
+
+  SCompBlockCacheKey key = {.vnode = vnode, .fileId = fileId};
+  taosRemoveFromClockCache(compBlockCache, vnodeCompBlockCacheOfFile, &key);
+}
@@ -19,6 +19,8 @@
 #include "tscompression.h"
 #include "tutil.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
+#include "vnodeCompBlockCache.h"
 #include "vnodeFile.h"
 #include "vnodeUtil.h"
 
@@ -64,6 +66,10 @@ void vnodeAdustVnodeFile(SVnodeObj *pVnode);
 int vnodeSyncRetrieveFile(int vnode, int fd, uint32_t peerFid, uint64_t *fmagic);
 int vnodeSyncRestoreFile(int vnode, int sfd);
 void vnodeAdjustFileTier(int vnode);
+static void vnodeCompressBlock(SMeterObj *pObj, SData *data[], SData *cdata[], SField *fields, int points,
+                               char *buffer, int bufferSize);
+static int vnodeWriteCompressedBlock(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[],
+                                     SField *fields, int points);
 
 void vnodeGetHeadDataLname(char *headName, char *dataName, char *lastName, int vnode, int fileId) {
   if (headName != NULL) sprintf(headName, "%s/vnode%d/db/v%df%d.head", tsDirectory, vnode, vnode, fileId);
@@ -407,12 +413,17 @@ void vnodeRemoveFile(int vnode, int fileId) {
     close(fd);
   }
 
+  pthread_mutex_lock(&(pVnode->vmutex));
   remove(headName);
   remove(dataName);
   remove(lastName);
   remove(dHeadName);
   remove(dDataName);
   remove(dLastName);
+  pVnode->headVersion++;
+  pthread_mutex_unlock(&(pVnode->vmutex));
+
+  vnodeCompBlockCacheRemove(vnode, fileId);
 
   dTrace("vid:%d fileId:%d on disk: %s is removed, numOfFiles:%d maxFiles:%d", vnode, fileId, path,
          pVnode->numOfFiles, pVnode->maxFiles);
@@ -460,8 +471,10 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
     remove(dpath);
   }
 
+  pVnode->headVersion++;
   pthread_mutex_unlock(&(pVnode->vmutex));
 
+  vnodeCompBlockCacheRemove(pVnode->vnode, pVnode->commitFileId);
   pVnode->tfd = 0;
 
   dTrace("vid:%d, %s and %s is saved", pVnode->vnode, pVnode->cfn, pVnode->lfn);
@@ -473,10 +486,173 @@ void vnodeCloseCommitFiles(SVnodeObj *pVnode) {
 
 void vnodeBroadcastStatusToUnsyncedPeer(SVnodeObj *pVnode);
 
+/*
+ * A data block to be committed. It is read from cache by the commit thread, compressed by the commit thread pool,
+ * and then written into file by the commit thread again.
+ */
+typedef struct {
+  SMeterObj * pObj;
+  SMeterInfo *pMeter;
+  SCompBlock *pCompBlock;
+  SData *     data[TSDB_MAX_COLUMNS];
+  SData *     cdata[TSDB_MAX_COLUMNS];
+  SField *    fields;
+  char *      buffer;  // buffer for two stage compression
+  int         bufferSize;
+  int         points;
+  int8_t      compressing;
+  tsem_t      done;
+} SCommitBlock;
+
+/*
+ * Blocks of different meters are compressed in parallel, while they are written into file in the order they are
+ * submitted, so the files are the same as committing the blocks one by one.
+ */
+typedef struct {
+  int32_t       numOfBlocks;
+  int32_t       head;        // the first submitted block that is not written yet
+  int32_t       numOfQueued; // number of submitted blocks that are not written yet
+  SCommitBlock *pBlocks;
+  char *        buffer;
+} SCommitPipe;
+
+static void vnodeDestroyCommitPipe(SCommitPipe *pPipe);
+
+static SCommitPipe *vnodeCreateCommitPipe(int dmsize, int cmsize, int maxBytesPerPoint, int rowsInFileBlock,
+                                          int compression) {
+  SCommitPipe *pPipe = (SCommitPipe *)calloc(1, sizeof(SCommitPipe));
+  if (pPipe == NULL) return NULL;
+
+  // more blocks than threads, so the commit thread is able to read next blocks when others are compressed
+  pPipe->numOfBlocks = (commitQhandle == NULL) ? 1 : tsNumOfCommitThreads * 2;
+
+  int fsize = sizeof(SField) * TSDB_MAX_COLUMNS + sizeof(TSCKSUM);
+  int bsize = (compression == TWO_STAGE_COMP) ? maxBytesPerPoint * rowsInFileBlock + EXTRA_BYTES : 0;
+  int size = dmsize + cmsize + fsize + bsize;
+
+  pPipe->pBlocks = (SCommitBlock *)calloc(pPipe->numOfBlocks, sizeof(SCommitBlock));
+  pPipe->buffer = (char *)malloc((size_t)size * pPipe->numOfBlocks);
+  if (pPipe->pBlocks == NULL || pPipe->buffer == NULL) {
+    vnodeDestroyCommitPipe(pPipe);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < pPipe->numOfBlocks; ++i) {
+    SCommitBlock *pBlock = &pPipe->pBlocks[i];
+    char *        mem = pPipe->buffer + (size_t)size * i;
+
+    pBlock->data[0] = (SData *)mem;
+    pBlock->cdata[0] = (SData *)(mem + dmsize);
+    pBlock->fields = (SField *)(mem + dmsize + cmsize);
+    pBlock->buffer = (bsize > 0) ? mem + dmsize + cmsize + fsize : NULL;
+    pBlock->bufferSize = bsize;
+    tsem_init(&pBlock->done, 0, 0);
+  }
+
+  return pPipe;
+}
+
+static void vnodeWaitCommitBlock(SCommitBlock *pBlock) {
+  if (pBlock->compressing) {
+    tsem_wait(&pBlock->done);
+    pBlock->compressing = 0;
+  }
+}
+
+static void vnodeDestroyCommitPipe(SCommitPipe *pPipe) {
+  if (pPipe == NULL) return;
+
+  // blocks may still be compressed by the commit threads if the commit is aborted
+  if (pPipe->pBlocks != NULL) {
+    for (int32_t i = 0; i < pPipe->numOfBlocks; ++i) {
+      vnodeWaitCommitBlock(&pPipe->pBlocks[i]);
+      tsem_destroy(&pPipe->pBlocks[i].done);
+    }
+  }
+
+  tfree(pPipe->pBlocks);
+  tfree(pPipe->buffer);
+  free(pPipe);
+}
+
+static int vnodeWriteFirstCommitBlock(SCommitPipe *pPipe) {
+  SCommitBlock *pBlock = &pPipe->pBlocks[pPipe->head];
+  vnodeWaitCommitBlock(pBlock);
+
+  pPipe->head = (pPipe->head + 1) % pPipe->numOfBlocks;
+  pPipe->numOfQueued--;
+
+  if (vnodeWriteCompressedBlock(pBlock->pObj, pBlock->pCompBlock, pBlock->data, pBlock->cdata, pBlock->fields,
+                                pBlock->points) < 0) {
+    return -1;
+  }
+
+  pBlock->pMeter->last = pBlock->pCompBlock->last;
+  return 0;
+}
+
+/*
+ * write all submitted blocks into file
+ */
+static int vnodeFlushCommitPipe(SCommitPipe *pPipe) {
+  while (pPipe->numOfQueued > 0) {
+    if (vnodeWriteFirstCommitBlock(pPipe) < 0) return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * get a free block to hold the data of pObj, the first submitted block is written into file if no block is free
+ */
+static SCommitBlock *vnodeGetCommitBlock(SCommitPipe *pPipe, SMeterObj *pObj) {
+  if (pPipe->numOfQueued == pPipe->numOfBlocks && vnodeWriteFirstCommitBlock(pPipe) < 0) {
+    return NULL;
+  }
+
+  SCommitBlock *pBlock = &pPipe->pBlocks[(pPipe->head + pPipe->numOfQueued) % pPipe->numOfBlocks];
+  for (int col = 1; col < pObj->numOfColumns; ++col) {
+    pBlock->data[col] = (SData *)(((char *)pBlock->data[col - 1]) + sizeof(SData) +
+                                  pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+    pBlock->cdata[col] = (SData *)(((char *)pBlock->cdata[col - 1]) + sizeof(SData) +
+                                   pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
+  }
+
+  return pBlock;
+}
+
+static void vnodeProcessCompressBlock(SSchedMsg *pMsg) {
+  SCommitBlock *pBlock = (SCommitBlock *)pMsg->ahandle;
+
+  vnodeCompressBlock(pBlock->pObj, pBlock->data, pBlock->cdata, pBlock->fields, pBlock->points, pBlock->buffer,
+                     pBlock->bufferSize);
+  tsem_post(&pBlock->done);
+}
+
+static void vnodeSubmitCommitBlock(SCommitPipe *pPipe, SCommitBlock *pBlock, SMeterObj *pObj, SMeterInfo *pMeter,
+                                   SCompBlock *pCompBlock, int points) {
+  pBlock->pObj = pObj;
+  pBlock->pMeter = pMeter;
+  pBlock->pCompBlock = pCompBlock;
+  pBlock->points = points;
+  pPipe->numOfQueued++;
+
+  if (commitQhandle == NULL) {
+    vnodeCompressBlock(pObj, pBlock->data, pBlock->cdata, pBlock->fields, points, pBlock->buffer, pBlock->bufferSize);
+    return;
+  }
+
+  SSchedMsg schedMsg = {0};
+  schedMsg.fp = vnodeProcessCompressBlock;
+  schedMsg.ahandle = pBlock;
+
+  pBlock->compressing = 1;
+  taosScheduleTask(commitQhandle, &schedMsg);
+}
+
 void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   int              vnode = pVnode->vnode;
-  SData *          data[TSDB_MAX_COLUMNS], *cdata[TSDB_MAX_COLUMNS];  // first 4 bytes are length
-  char *           buffer = NULL, *dmem = NULL, *cmem = NULL, *hmem = NULL, *tmem = NULL;
+  char *           buffer = NULL, *hmem = NULL, *tmem = NULL;
   SMeterObj *      pObj = NULL;
   SCompInfo        compInfo = {0};
   SCompHeader *    pHeader;
@@ -485,14 +661,16 @@ void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   SColumnInfoEx    colList[TSDB_MAX_COLUMNS] = {0};
   SSqlFunctionExpr pExprs[TSDB_MAX_COLUMNS] = {0};
   int              commitAgain;
-  int              headLen, sid, col;
+  int              headLen, sid;
   int64_t          pointsRead;
   int64_t          pointsReadLast;
   SCompBlock *     pCompBlock = NULL;
   SVnodeCfg *      pCfg = &pVnode->cfg;
   TSCKSUM          chksum;
   SVnodeHeadInfo   headInfo;
-  uint8_t *        pOldCompBlocks;
+  uint8_t *        pOldCompBlocks = NULL;
+  SCommitPipe *    pPipe = NULL;
+  SCommitBlock *   pBlock = NULL;
 
   dPrint("vid:%d, committing to file, firstKey:%ld lastKey:%ld ssid:%d esid:%d", vnode, pVnode->firstKey,
          pVnode->lastKey, ssid, esid);
@@ -536,17 +714,18 @@ void *vnodeCommitMultiToFile(SVnodeObj *pVnode, int ssid, int esid) {
   // buffer to hold meterInfo
   int misize = pVnode->cfg.maxSessions * sizeof(SMeterInfo);
 
-  int totalSize = hmsize + dmsize + cmsize + misize + tmsize;
+  int totalSize = hmsize + misize + tmsize;
   buffer = malloc(totalSize);
-  if (buffer == NULL) {
+  pPipe = vnodeCreateCommitPipe(dmsize, cmsize, maxBytesPerPoint, pCfg->rowsInFileBlock, pCfg->compression);
+  if (buffer == NULL || pPipe == NULL) {
     dError("no enough memory for committing buffer");
+    tfree(buffer);
+    vnodeDestroyCommitPipe(pPipe);
     return NULL;
   }
 
   hmem = buffer;
-  dmem = hmem + hmsize;
-  cmem = dmem + dmsize;
-  tmem = cmem + cmsize;
+  tmem = hmem + hmsize;
   meterInfo = (SMeterInfo *)(tmem + tmsize);
 
   pthread_mutex_lock(&(pVnode->vmutex));
@@ -648,14 +827,7 @@ _again:
     pObj = (SMeterObj *)(pVnode->meterList[sid]);
     if ((pObj == NULL) || (pObj->pCache == NULL)) continue;
 
-    data[0] = (SData *)dmem;
-    cdata[0] = (SData *)cmem;
-    for (col = 1; col < pObj->numOfColumns; ++col) {
-      data[col] = (SData *)(((char *)data[col - 1]) + sizeof(SData) +
-                            pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
-      cdata[col] = (SData *)(((char *)cdata[col - 1]) + sizeof(SData) +
-                             pObj->pointsPerFileBlock * pObj->schema[col - 1].bytes + EXTRA_BYTES + sizeof(TSCKSUM));
-    }
+    if ((pBlock = vnodeGetCommitBlock(pPipe, pObj)) == NULL) goto _over;
 
     pMeter = meterInfo + sid;
     pMeter->tempHeadOffset = headLen;
@@ -668,7 +840,7 @@ _again:
     query.skey = pVnode->commitFirstKey;
     query.lastKey = query.skey;
 
-    query.sdata = data;
+    query.sdata = pBlock->data;
     vnodeSetCommitQuery(pObj, &query);
 
     dTrace("vid:%d sid:%d id:%s, start to commit, startKey:%lld slot:%d pos:%d", pObj->vnode, pObj->sid, pObj->meterId,
@@ -682,8 +854,11 @@ _again:
       if ((pMeter->lastBlock.sversion != pObj->sversion) || (query.over)) {
         // TODO : Check the correctness of this code. write the last block to
         // .data file
+        // the last block is copied into file directly, after the blocks submitted before it
+        if (vnodeFlushCommitPipe(pPipe) < 0) goto _over;
+
         pCompBlock = (SCompBlock *)(hmem + headLen);
-        assert(dmem - (char *)pCompBlock >= sizeof(SCompBlock));
+        assert(tmem - (char *)pCompBlock >= sizeof(SCompBlock));
         *pCompBlock = pMeter->lastBlock;
         if (pMeter->lastBlock.sversion != pObj->sversion) {
           pCompBlock->last = 0;
@@ -709,7 +884,7 @@ _again:
         pMeter->newNumOfBlocks++;
       } else {
         // read last block into memory
-        if (vnodeReadLastBlockToMem(pObj, &pMeter->lastBlock, data) < 0) goto _over;
+        if (vnodeReadLastBlockToMem(pObj, &pMeter->lastBlock, pBlock->data) < 0) goto _over;
         pMeter->last = 0;
         pointsReadLast = pMeter->lastBlock.numOfPoints;
         query.over = 0;
@@ -725,7 +900,7 @@ _again:
 
     while (query.over == 0) {
       pCompBlock = (SCompBlock *)(hmem + headLen);
-      assert(dmem - (char *)pCompBlock >= sizeof(SCompBlock));
+      assert(tmem - (char *)pCompBlock >= sizeof(SCompBlock));
       pointsRead += pointsReadLast;
 
       while (pointsRead < pObj->pointsPerFileBlock) {
@@ -739,9 +914,10 @@ _again:
 
       headInfo.totalStorage += ((pointsRead - pointsReadLast) * pObj->bytesPerPoint);
       pCompBlock->last = 1;
-      if (vnodeWriteBlockToFile(pObj, pCompBlock, data, cdata, pointsRead) < 0) goto _over;
-      if (pCompBlock->keyLast > pObj->lastKeyOnFile) pObj->lastKeyOnFile = pCompBlock->keyLast;
-      pMeter->last = pCompBlock->last;
+      vnodeSubmitCommitBlock(pPipe, pBlock, pObj, pMeter, pCompBlock, pointsRead);
+
+      TSKEY keyLast = *((TSKEY *)(pBlock->data[0]->data + (pointsRead - 1) * pObj->schema[0].bytes));
+      if (keyLast > pObj->lastKeyOnFile) pObj->lastKeyOnFile = keyLast;
 
       // write block info into header buffer
       headLen += sizeof(SCompBlock);
@@ -757,6 +933,9 @@ _again:
 
       pointsRead = 0;
       pointsReadLast = 0;
+
+      if ((pBlock = vnodeGetCommitBlock(pPipe, pObj)) == NULL) goto _over;
+      query.sdata = pBlock->data;
     }
 
     dTrace("vid:%d sid:%d id:%s, %d points are committed, lastKey:%lld slot:%d pos:%d newNumOfBlocks:%d",
@@ -779,6 +958,7 @@ _again:
     pthread_mutex_unlock(&(pVnode->vmutex));
   }
 
+  if (vnodeFlushCommitPipe(pPipe) < 0) goto _over;
   if (pVnode->lastKey > pVnode->commitLastKey) commitAgain = 1;
 
   dTrace("vid:%d, finish appending the data file", vnode);
@@ -898,6 +1078,7 @@ _over:
   pVnode->commitInProcess = 0;
   vnodeCommitOver(pVnode);
   memset(&(vnodeList[vnode].commitThread), 0, sizeof(vnodeList[vnode].commitThread));
+  vnodeDestroyCommitPipe(pPipe);
   tfree(buffer);
   tfree(pOldCompBlocks);
 
@@ -1056,6 +1237,12 @@ int vnodeReadColumnToMem(int fd, SCompBlock *pBlock, SField **fields, int col, c
   /* If data is NULL, that means only to read SField content. So no need to read data part. */
   if (data == NULL) return 0;
 
+  /* all data of this column in current block are null, set null values instead of reading it from disk */
+  if (tfields[col].numOfNullPoints == pBlock->numOfPoints) {
+    setNullN(data, tfields[col].type, tfields[col].bytes, pBlock->numOfPoints);
+    return 0;
+  }
+
   lseek(fd, pBlock->offset + tfields[col].offset, SEEK_SET);
 
   if (pBlock->algorithm) {
@@ -1193,38 +1380,17 @@ int vnodeReadLastBlockToMem(SMeterObj *pObj, SCompBlock *pBlock, SData *sdata[])
   return code;
 }
 
-int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
-  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
-  SVnodeCfg *pCfg = &pVnode->cfg;
-  int        wlen = 0;
-  SField *   fields = NULL;
-  int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
-  int32_t    offset = size;
-  char *     buffer = NULL;
-  int        bufferSize = 0;
-
-  int dfd = pVnode->dfd;
-
-  if (pCompBlock->last && (points < pObj->pointsPerFileBlock * tsFileBlockMinPercent)) {
-    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
-           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
-           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
-    pCompBlock->last = 1;
-    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
-  } else {
-    pCompBlock->last = 0;
-  }
-
-  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
-  pCompBlock->len = 0;
-
-  fields = (SField *)calloc(1, size);
-  if (fields == NULL) return -1;
+/*
+ * compress the columns of a data block into cdata, and calculate the statistics of each column in fields. Nothing is
+ * written into file, so it can be executed in any thread.
+ */
+static void vnodeCompressBlock(SMeterObj *pObj, SData *data[], SData *cdata[], SField *fields, int points,
+                               char *buffer, int bufferSize) {
+  SVnodeCfg *pCfg = &vnodeList[pObj->vnode].cfg;
+  int32_t    offset = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
 
-  if (pCfg->compression == TWO_STAGE_COMP){
-    bufferSize = pObj->maxBytes * points + EXTRA_BYTES;
-    buffer = (char *)malloc(bufferSize);
-  } 
+  // the statistics are accumulated into fields
+  memset(fields, 0, offset);
 
   for (int i = 0; i < pObj->numOfColumns; ++i) {
     fields[i].colId = pObj->schema[i].colId;
@@ -1250,14 +1416,38 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
     getStatistics(data[0]->data, data[i]->data, pObj->schema[i].bytes, points, pObj->schema[i].type, &fields[i].min,
                   &fields[i].max, &fields[i].sum, &fields[i].minIndex, &fields[i].maxIndex, &fields[i].numOfNullPoints);
   }
+}
 
-  tfree(buffer);
+/*
+ * write a data block compressed by vnodeCompressBlock into the data file, or the last file if there are only a few
+ * points in the block and pCompBlock->last is set
+ */
+static int vnodeWriteCompressedBlock(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[],
+                                     SField *fields, int points) {
+  SVnodeObj *pVnode = &vnodeList[pObj->vnode];
+  SVnodeCfg *pCfg = &pVnode->cfg;
+  int        wlen = 0;
+  int        size = sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM);
+
+  int dfd = pVnode->dfd;
+
+  if (pCompBlock->last && (points < pObj->pointsPerFileBlock * tsFileBlockMinPercent)) {
+    dTrace("vid:%d sid:%d id:%s, points:%d are written to last block, block stime: %ld, block etime: %ld",
+           pObj->vnode, pObj->sid, pObj->meterId, points, *((TSKEY *)(data[0]->data)),
+           *((TSKEY * )(data[0]->data + (points - 1) * pObj->schema[0].bytes)));
+    pCompBlock->last = 1;
+    dfd = pVnode->tfd > 0 ? pVnode->tfd : pVnode->lfd;
+  } else {
+    pCompBlock->last = 0;
+  }
+
+  pCompBlock->offset = lseek(dfd, 0, SEEK_END);
+  pCompBlock->len = 0;
 
   // Write SField part
   taosCalcChecksumAppend(0, (uint8_t *)fields, size);
   wlen = twrite(dfd, fields, size);
   if (wlen <= 0) {
-    tfree(fields);
     dError("vid:%d sid:%d id:%s, failed to write block, wlen:%d reason:%s", pObj->vnode, pObj->sid, pObj->meterId, wlen,
            strerror(errno));
 #ifdef CLUSTER		   
@@ -1269,7 +1459,6 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
   pVnode->vnodeStatistic.compStorage += wlen;
   pVnode->dfSize += wlen;
   pCompBlock->len += wlen;
-  tfree(fields);
 
   // Write data part
   for (int i = 0; i < pObj->numOfColumns; ++i) {
@@ -1302,8 +1491,70 @@ int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[]
   return 0;
 }
 
+int vnodeWriteBlockToFile(SMeterObj *pObj, SCompBlock *pCompBlock, SData *data[], SData *cdata[], int points) {
+  SVnodeCfg *pCfg = &vnodeList[pObj->vnode].cfg;
+  SField *   fields = NULL;
+  char *     buffer = NULL;
+  int        bufferSize = 0;
+
+  fields = (SField *)calloc(1, sizeof(SField) * pObj->numOfColumns + sizeof(TSCKSUM));
+  if (fields == NULL) return -1;
+
+  if (pCfg->compression == TWO_STAGE_COMP){
+    bufferSize = pObj->maxBytes * points + EXTRA_BYTES;
+    buffer = (char *)malloc(bufferSize);
+  } 
+
+  vnodeCompressBlock(pObj, data, cdata, fields, points, buffer, bufferSize);
+  tfree(buffer);
+
+  int code = vnodeWriteCompressedBlock(pObj, pCompBlock, data, cdata, fields, points);
+  tfree(fields);
+
+  return code;
+}
+
 static int forwardInFile(SQuery *pQuery, int32_t midSlot, int32_t step, SVnodeObj *pVnode, SMeterObj *pObj);
 
+/*
+ * read the timestamp column of a block for a point lookup. The decompressed column is shared with queries through the
+ * block cache, so successive lookups in the same block, e.g. imports, do not decompress it again.
+ */
+static int vnodeReadTimestampColumn(SMeterObj *pObj, SQuery *pQuery, int fd, int32_t slot, char *data, int dataSize,
+                                    char *temp, char *buffer, int bufferSize) {
+  SCompBlock *pBlock = pQuery->pBlock + slot;
+  SField **   pFields = pQuery->pFields + slot;
+
+  if (pBlock->algorithm == 0 || !vnodeBlockCacheEnabled()) {
+    return vnodeReadColumnToMem(fd, pBlock, pFields, 0, data, dataSize, temp, buffer, bufferSize);
+  }
+
+  // load the SField to locate the timestamp column
+  if (vnodeReadColumnToMem(fd, pBlock, pFields, 0, NULL, 0, NULL, buffer, bufferSize) < 0) return -1;
+
+  SField *pField = *pFields;
+  int64_t offset = pBlock->offset + pField[0].offset;
+  TSCKSUM checksum = 0;
+  if (pread(fd, &checksum, sizeof(TSCKSUM), offset + pField[0].len) != sizeof(TSCKSUM)) return -1;
+
+  SBlockCacheKey key = {.vnode = pObj->vnode,
+                        .fileId = pQuery->fileId,
+                        .last = pBlock->last,
+                        .colId = pField[0].colId,
+                        .offset = offset,
+                        .len = pField[0].len,
+                        .numOfPoints = pBlock->numOfPoints,
+                        .checksum = checksum};
+
+  int32_t size = TSDB_KEYSIZE * pBlock->numOfPoints;
+  if (vnodeBlockCacheGet(&key, data, size)) return 0;
+
+  if (vnodeReadColumnToMem(fd, pBlock, pFields, 0, data, dataSize, temp, buffer, bufferSize) < 0) return -1;
+
+  vnodeBlockCachePut(&key, data, size);
+  return 0;
+}
+
 int vnodeSearchPointInFile(SMeterObj *pObj, SQuery *pQuery) {
   TSKEY       latest, oldest;
   int         ret = 0;
@@ -1408,12 +1659,21 @@ int vnodeSearchPointInFile(SMeterObj *pObj, SQuery *pQuery) {
       if (pQuery->ekey < pBlock[midSlot].keyFirst) break;
     }
 
+    // the start key is at the boundary of the block, no need to read the timestamp column
+    if ((QUERY_IS_ASC_QUERY(pQuery) && pQuery->skey <= pBlock[midSlot].keyFirst) ||
+        (!QUERY_IS_ASC_QUERY(pQuery) && pQuery->skey >= pBlock[midSlot].keyLast)) {
+      pQuery->pos = QUERY_IS_ASC_QUERY(pQuery) ? 0 : pBlock[midSlot].numOfPoints - 1;
+      pQuery->key = QUERY_IS_ASC_QUERY(pQuery) ? pBlock[midSlot].keyFirst : pBlock[midSlot].keyLast;
+
+      ret = vnodeForwardStartPosition(pQuery, pBlock, midSlot, pVnode, pObj);
+      break;
+    }
+
     temp = malloc(pObj->pointsPerFileBlock * TSDB_KEYSIZE + EXTRA_BYTES);  // only first column
     data = malloc(pObj->pointsPerFileBlock * TSDB_KEYSIZE + EXTRA_BYTES);  // only first column
     dfd = pBlock[midSlot].last ? pQuery->lfd : pQuery->dfd;
-    ret = vnodeReadColumnToMem(dfd, pBlock + midSlot, pQuery->pFields + midSlot, 0, data,
-                               pObj->pointsPerFileBlock*TSDB_KEYSIZE+EXTRA_BYTES,
-                               temp, buffer, bufferSize);
+    ret = vnodeReadTimestampColumn(pObj, pQuery, dfd, midSlot, data, pObj->pointsPerFileBlock * TSDB_KEYSIZE + EXTRA_BYTES,
+                                   temp, buffer, bufferSize);
     if (ret < 0) {
       ret = vnodeRecoverFromPeer(pVnode, pQuery->fileId);
       break;
@@ -556,3 +556,162 @@ __filter_func_t* vnodeGetValueFilterFuncArray(int32_t type) {
 }
 
 bool vnodeSupportPrefilter(int32_t type) { return type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR; }
+
+/*
+ * Block version of the filter functions. Each 64 rows are checked in a loop without branch to generate one
+ * word of the bitmap, so the loop can be vectorized by compiler.
+ */
+#define BLOCK_FILTER_IMPL(name, type, cond)                                                            \
+  static void name(SColumnFilterElem *pFilter, const char *pData, int32_t numOfRows, uint64_t *bitmap) { \
+    const type *val = (const type *)pData;                                                             \
+    for (int32_t i = 0; i < numOfRows; i += 64) {                                                      \
+      int32_t  n = MIN(64, numOfRows - i);                                                             \
+      uint64_t bits = 0;                                                                               \
+      for (int32_t j = 0; j < n; ++j) {                                                                \
+        type v = val[i + j];                                                                           \
+        bits |= ((uint64_t)(cond)) << j;                                                               \
+      }                                                                                                \
+      bitmap[i >> 6] |= bits;                                                                          \
+    }                                                                                                  \
+  }
+
+#define BLOCK_FILTER_TYPE_IMPL(t, type, lower, upper, equalCond)                     \
+  BLOCK_FILTER_IMPL(blockLess_##t, type, v < (upper))                                \
+  BLOCK_FILTER_IMPL(blockLarge_##t, type, v > (lower))                               \
+  BLOCK_FILTER_IMPL(blockEqual_##t, type, equalCond)                                 \
+  BLOCK_FILTER_IMPL(blockLessEqual_##t, type, v <= (upper))                          \
+  BLOCK_FILTER_IMPL(blockLargeEqual_##t, type, v >= (lower))                         \
+  BLOCK_FILTER_IMPL(blockNequal_##t, type, v != (lower))                             \
+  BLOCK_FILTER_IMPL(blockRangeFilter_##t##_ee, type, v > (lower) && v < (upper))     \
+  BLOCK_FILTER_IMPL(blockRangeFilter_##t##_ie, type, v >= (lower) && v < (upper))    \
+  BLOCK_FILTER_IMPL(blockRangeFilter_##t##_ei, type, v > (lower) && v <= (upper))    \
+  BLOCK_FILTER_IMPL(blockRangeFilter_##t##_ii, type, v >= (lower) && v <= (upper))
+
+#define LOWER_I pFilter->filterInfo.lowerBndi
+#define UPPER_I pFilter->filterInfo.upperBndi
+#define LOWER_D pFilter->filterInfo.lowerBndd
+#define UPPER_D pFilter->filterInfo.upperBndd
+
+BLOCK_FILTER_TYPE_IMPL(i8, int8_t, LOWER_I, UPPER_I, v == LOWER_I)
+BLOCK_FILTER_TYPE_IMPL(i16, int16_t, LOWER_I, UPPER_I, v == LOWER_I)
+BLOCK_FILTER_TYPE_IMPL(i32, int32_t, LOWER_I, UPPER_I, v == LOWER_I)
+BLOCK_FILTER_TYPE_IMPL(i64, int64_t, LOWER_I, UPPER_I, v == LOWER_I)
+BLOCK_FILTER_TYPE_IMPL(ds, float, LOWER_D, UPPER_D, fabs(v - LOWER_D) <= FLT_EPSILON)
+BLOCK_FILTER_TYPE_IMPL(dd, double, LOWER_D, UPPER_D, v == LOWER_D)
+
+#define BLOCK_FILTER_FUNC_ARRAY(t)                                                                      \
+  __filter_block_func_t blockFilterFunc_##t[] = {                                                      \
+      NULL, blockLess_##t, blockLarge_##t, blockEqual_##t, blockLessEqual_##t, blockLargeEqual_##t,    \
+      blockNequal_##t, NULL,                                                                           \
+  };                                                                                                   \
+  __filter_block_func_t rangeBlockFilterFunc_##t[] = {                                                 \
+      NULL, blockRangeFilter_##t##_ee, blockRangeFilter_##t##_ie, blockRangeFilter_##t##_ei,           \
+      blockRangeFilter_##t##_ii,                                                                       \
+  };
+
+BLOCK_FILTER_FUNC_ARRAY(i8)
+BLOCK_FILTER_FUNC_ARRAY(i16)
+BLOCK_FILTER_FUNC_ARRAY(i32)
+BLOCK_FILTER_FUNC_ARRAY(i64)
+BLOCK_FILTER_FUNC_ARRAY(ds)
+BLOCK_FILTER_FUNC_ARRAY(dd)
+
+__filter_block_func_t* vnodeGetRangeBlockFilterFuncArray(int32_t type) {
+  switch(type) {
+    case TSDB_DATA_TYPE_BOOL:       return rangeBlockFilterFunc_i8;
+    case TSDB_DATA_TYPE_TINYINT:    return rangeBlockFilterFunc_i8;
+    case TSDB_DATA_TYPE_SMALLINT:   return rangeBlockFilterFunc_i16;
+    case TSDB_DATA_TYPE_INT:        return rangeBlockFilterFunc_i32;
+    case TSDB_DATA_TYPE_TIMESTAMP:  //timestamp uses bigint filter
+    case TSDB_DATA_TYPE_BIGINT:     return rangeBlockFilterFunc_i64;
+    case TSDB_DATA_TYPE_FLOAT:      return rangeBlockFilterFunc_ds;
+    case TSDB_DATA_TYPE_DOUBLE:     return rangeBlockFilterFunc_dd;
+    default:return NULL;
+  }
+}
+
+__filter_block_func_t* vnodeGetValueBlockFilterFuncArray(int32_t type) {
+  switch(type) {
+    case TSDB_DATA_TYPE_BOOL:       return blockFilterFunc_i8;
+    case TSDB_DATA_TYPE_TINYINT:    return blockFilterFunc_i8;
+    case TSDB_DATA_TYPE_SMALLINT:   return blockFilterFunc_i16;
+    case TSDB_DATA_TYPE_INT:        return blockFilterFunc_i32;
+    case TSDB_DATA_TYPE_TIMESTAMP:  //timestamp uses bigint filter
+    case TSDB_DATA_TYPE_BIGINT:     return blockFilterFunc_i64;
+    case TSDB_DATA_TYPE_FLOAT:      return blockFilterFunc_ds;
+    case TSDB_DATA_TYPE_DOUBLE:     return blockFilterFunc_dd;
+    default: return NULL;
+  }
+}
+
+// clear the bits of null values, which are compared by the bit pattern of the null value of each type
+#define BLOCK_CLEAR_NULL_IMPL(utype, nullVal, pData, numOfRows, bitmap) \
+  do {                                                                   \
+    const utype *val = (const utype *)(pData);                           \
+    for (int32_t i = 0; i < (numOfRows); i += 64) {                      \
+      int32_t  n = MIN(64, (numOfRows) - i);                             \
+      uint64_t bits = 0;                                                 \
+      for (int32_t j = 0; j < n; ++j) {                                  \
+        bits |= ((uint64_t)(val[i + j] != (utype)(nullVal))) << j;       \
+      }                                                                  \
+      (bitmap)[i >> 6] &= bits;                                          \
+    }                                                                    \
+  } while (0)
+
+static void clearNullRows(int32_t type, int32_t bytes, const char *pData, int32_t numOfRows, uint64_t *bitmap) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      BLOCK_CLEAR_NULL_IMPL(uint8_t, TSDB_DATA_BOOL_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      BLOCK_CLEAR_NULL_IMPL(uint8_t, TSDB_DATA_TINYINT_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      BLOCK_CLEAR_NULL_IMPL(uint16_t, TSDB_DATA_SMALLINT_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      BLOCK_CLEAR_NULL_IMPL(uint32_t, TSDB_DATA_INT_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_BIGINT:
+      BLOCK_CLEAR_NULL_IMPL(uint64_t, TSDB_DATA_BIGINT_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      BLOCK_CLEAR_NULL_IMPL(uint32_t, TSDB_DATA_FLOAT_NULL, pData, numOfRows, bitmap);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      BLOCK_CLEAR_NULL_IMPL(uint64_t, TSDB_DATA_DOUBLE_NULL, pData, numOfRows, bitmap);
+      break;
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        if (isNull((char *)pData + i * bytes, type)) {
+          bitmap[i >> 6] &= ~(1ULL << (i & 63));
+        }
+      }
+  }
+}
+
+void vnodeFilterColumnBlock(SSingleColumnFilterInfo *pFilterInfo, const char *pData, int32_t numOfRows,
+                            uint64_t *bitmap) {
+  int32_t bytes = pFilterInfo->info.data.bytes;
+  memset(bitmap, 0, FILTER_BITMAP_WORDS(numOfRows) * sizeof(uint64_t));
+
+  // the filters of one column are OR'ed
+  for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+    SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[j];
+
+    if (pFilterElem->blockFp != NULL) {
+      pFilterElem->blockFp(pFilterElem, pData, numOfRows, bitmap);
+      continue;
+    }
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      char *pElem = (char *)pData + i * bytes;
+      if (pFilterElem->fp(pFilterElem, pElem, pElem)) {
+        bitmap[i >> 6] |= (1ULL << (i & 63));
+      }
+    }
+  }
+
+  clearNullRows(pFilterInfo->info.data.type, bytes, pData, numOfRows, bitmap);
+}
@@ -271,6 +271,17 @@ int vnodeOpenFileForImport(SImportInfo *pImport, char *payload, SHeadInfo *pHinf
 }
 
 extern int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints);
+
+// in sync commit log mode, the imported rows are acknowledged only after the commit log is synced to disk
+static void vnodeSendImportRspMsg(SShellObj *pShell) {
+  SVnodeObj *pVnode = vnodeList + pShell->vnode;
+
+  if (pShell->code == TSDB_CODE_SUCCESS && pVnode->logSync) {
+    vnodeSendSubmitRspAfterLogSync(pVnode, pShell, pShell->code, pShell->numOfTotalPoints);
+  } else {
+    vnodeSendShellSubmitRspMsg(pShell, pShell->code, pShell->numOfTotalPoints);
+  }
+}
 int vnodeImportToFile(SImportInfo *pImport);
 
 void vnodeProcessImportTimer(void *param, void *tmrId) {
@@ -330,7 +341,7 @@ void vnodeProcessImportTimer(void *param, void *tmrId) {
   // send response back to shell
   if (pShell) {
     pShell->count--;
-    if (pShell->count <= 0) vnodeSendShellSubmitRspMsg(pImport->pShell, pShell->code, pShell->numOfTotalPoints);
+    if (pShell->count <= 0) vnodeSendImportRspMsg(pImport->pShell);
   }
 
   pImport->signature = NULL;
@@ -976,7 +987,7 @@ int vnodeImportPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
 
   if (pShell) {
     pShell->count--;
-    if (pShell->count <= 0) vnodeSendShellSubmitRspMsg(pShell, pShell->code, pShell->numOfTotalPoints);
+    if (pShell->count <= 0) vnodeSendImportRspMsg(pShell);
   }
 
   return 0;
@@ -613,7 +613,7 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
     goto _over;
   }
   
-  for (i = 0; i < numOfPoints; ++i) { // meter will be dropped, abort current insertion
+  for (i = 0; i < numOfPoints;) { // meter will be dropped, abort current insertion
     if (pObj->state >= TSDB_METER_STATE_DELETING) {
       dWarn("vid:%d sid:%d id:%s, meter is dropped, abort insert, state:%d", pObj->vnode, pObj->sid, pObj->meterId,
             pObj->state);
@@ -626,22 +626,40 @@ int vnodeInsertPoints(SMeterObj *pObj, char *cont, int contLen, char source, voi
       dWarn("vid:%d sid:%d id:%s, received key:%ld not larger than lastKey:%ld", pObj->vnode, pObj->sid, pObj->meterId,
             *((TSKEY *)pData), pObj->lastKey);
       pData += pObj->bytesPerPoint;
+      i++;
       continue;
     }
 
-    if (!VALID_TIMESTAMP(*((TSKEY *)pData), tsKey, pVnode->cfg.precision)) {
+    // find the run of rows with increasing and valid keys, they are copied into cache in one pass
+    TSKEY prevKey = pObj->lastKey;
+    char *pRow = pData;
+    int   rows = 0;
+    while (i + rows < numOfPoints) {
+      TSKEY key = *((TSKEY *)pRow);
+      if (key <= prevKey || !VALID_TIMESTAMP(key, tsKey, pVnode->cfg.precision)) break;
+
+      prevKey = key;
+      pRow += pObj->bytesPerPoint;
+      rows++;
+    }
+
+    if (rows == 0) {
       code = TSDB_CODE_TIMESTAMP_OUT_OF_RANGE;
       break;
     }
 
-    if (vnodeInsertPointToCache(pObj, pData) < 0) {
+    int inserted = vnodeInsertBlockToCache(pObj, pData, rows);
+    if (inserted > 0) {
+      pObj->lastKey = *((TSKEY *)(pData + (inserted - 1) * pObj->bytesPerPoint));
+      pData += inserted * pObj->bytesPerPoint;
+      points += inserted;
+      i += inserted;
+    }
+
+    if (inserted < rows) {
       code = TSDB_CODE_ACTION_IN_PROGRESS;
       break;
     }
-
-    pObj->lastKey = *((TSKEY *)pData);
-    pData += pObj->bytesPerPoint;
-    points++;
   }
   atomic_fetch_add_64(&(pVnode->vnodeStatistic.pointsWritten), points * (pObj->numOfColumns - 1));
   atomic_fetch_add_64(&(pVnode->vnodeStatistic.totalStorage), points * pObj->bytesPerPoint);
@@ -28,6 +28,8 @@
 #include "vnodeUtil.h"
 
 #include "vnodeCache.h"
+#include "vnodeBlockCache.h"
+#include "vnodeCompBlockCache.h"
 #include "vnodeDataFilterFunc.h"
 #include "vnodeFile.h"
 #include "vnodeQueryImpl.h"
@@ -247,6 +249,40 @@ static void vnodeInitDataBlockInfo(SQueryLoadBlockInfo *pBlockLoadInfo) {
   pBlockLoadInfo->fileListIndex = -1;
 }
 
+/*
+ * the validated comp block info of one meter in one file is kept in the comp block cache and shared by queries.
+ * The key consists of the head file version, so it is out of date once the head file is replaced by commit.
+ */
+static void getCompBlockCacheKey(SCompBlockCacheKey *pKey, SMeterObj *pMeterObj, SQueryFileInfo *pQueryFileInfo) {
+  pKey->vnode = pMeterObj->vnode;
+  pKey->fileId = pQueryFileInfo->fileID;
+  pKey->sid = pMeterObj->sid;
+  pKey->uid = pMeterObj->uid;
+  pKey->headVersion = pQueryFileInfo->headVersion;
+}
+
+static void setCompBlockInfo(SQueryRuntimeEnv *pRuntimeEnv, SCompBlock *pCompBlock, int32_t numOfBlocks) {
+  SQuery *pQuery = pRuntimeEnv->pQuery;
+
+  // free allocated SField data
+  vnodeFreeFieldsEx(pRuntimeEnv);
+  pQuery->numOfBlocks = numOfBlocks;
+
+  int32_t compBlockSize = numOfBlocks * sizeof(SCompBlock);
+  size_t  bufferSize = compBlockSize + POINTER_BYTES * numOfBlocks;
+
+  // prepare buffer to hold compblock data
+  if (pQuery->blockBufferSize != bufferSize) {
+    pQuery->pBlock = realloc(pQuery->pBlock, bufferSize);
+    pQuery->blockBufferSize = (int32_t)bufferSize;
+  }
+
+  memset(pQuery->pBlock, 0, (size_t)pQuery->blockBufferSize);
+  memcpy(pQuery->pBlock, pCompBlock, (size_t)compBlockSize);
+
+  pQuery->pFields = (SField **)((char *)pQuery->pBlock + compBlockSize);
+}
+
 /*
  * read comp block info from header file
  *
@@ -268,6 +304,23 @@ static int vnodeGetCompBlockInfo(SMeterObj *pMeterObj, SQueryRuntimeEnv *pRuntim
     return pQuery->numOfBlocks;
   }
 
+  SCompBlockCacheKey key;
+  getCompBlockCacheKey(&key, pMeterObj, pQueryFileInfo);
+
+  SCompBlock *pCachedBlock = NULL;
+  int32_t     numOfBlocks = vnodeCompBlockCacheGet(&key, (void **)&pCachedBlock);
+  if (numOfBlocks >= 0) {
+    if (numOfBlocks > 0) {
+      setCompBlockInfo(pRuntimeEnv, pCachedBlock, numOfBlocks);
+      vnodeSetCompBlockInfoLoaded(pRuntimeEnv, fileIndex, pMeterObj->sid);
+      free(pCachedBlock);
+    }
+
+    dTrace("QInfo:%p vid:%d sid:%d id:%s, fileId:%d, load compblock info from cache, blocks:%d", pQInfo,
+           pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQueryFileInfo->fileID, numOfBlocks);
+    return numOfBlocks;
+  }
+
   SQueryCostSummary *pSummary = &pRuntimeEnv->summary;
   pSummary->readCompInfo++;
   pSummary->numOfSeek++;
@@ -291,6 +344,7 @@ static int vnodeGetCompBlockInfo(SMeterObj *pMeterObj, SQueryRuntimeEnv *pRuntim
 
   // no data in this file for specified meter, abort
   if (compHeader->compInfoOffset == 0) {
+    vnodeCompBlockCachePut(&key, NULL, 0);
     return 0;
   }
 
@@ -315,26 +369,14 @@ static int vnodeGetCompBlockInfo(SMeterObj *pMeterObj, SQueryRuntimeEnv *pRuntim
   }
 
   if (compInfo->numOfBlocks <= 0 || compInfo->uid != pMeterObj->uid) {
+    vnodeCompBlockCachePut(&key, NULL, 0);
     return 0;
   }
 
-  // free allocated SField data
-  vnodeFreeFieldsEx(pRuntimeEnv);
-  pQuery->numOfBlocks = (int32_t)compInfo->numOfBlocks;
-
   int32_t compBlockSize = compInfo->numOfBlocks * sizeof(SCompBlock);
-  size_t  bufferSize = compBlockSize + POINTER_BYTES * compInfo->numOfBlocks;
-
-  // prepare buffer to hold compblock data
-  if (pQuery->blockBufferSize != bufferSize) {
-    pQuery->pBlock = realloc(pQuery->pBlock, bufferSize);
-    pQuery->blockBufferSize = (int32_t)bufferSize;
-  }
-
-  memset(pQuery->pBlock, 0, (size_t)pQuery->blockBufferSize);
 
 #if 1
-  memcpy(pQuery->pBlock, (char *)compInfo + sizeof(SCompInfo), (size_t)compBlockSize);
+  setCompBlockInfo(pRuntimeEnv, (SCompBlock *)((char *)compInfo + sizeof(SCompInfo)), compInfo->numOfBlocks);
   TSCKSUM checksum = *(TSCKSUM *)((char *)compInfo + sizeof(SCompInfo) + compBlockSize);
 #else
   TSCKSUM checksum;
@@ -348,7 +390,7 @@ static int vnodeGetCompBlockInfo(SMeterObj *pMeterObj, SQueryRuntimeEnv *pRuntim
     return -1;
   }
 
-  pQuery->pFields = (SField **)((char *)pQuery->pBlock + compBlockSize);
+  vnodeCompBlockCachePut(&key, pQuery->pBlock, pQuery->numOfBlocks);
   vnodeSetCompBlockInfoLoaded(pRuntimeEnv, fileIndex, pMeterObj->sid);
 
   int64_t et = taosGetTimestampUs();
@@ -542,17 +584,16 @@ static int32_t readDataFromDiskFile(int fd, SQInfo *pQInfo, SQueryFileInfo *pQue
 }
 
 static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFileInfo *pQueryFileInfo, SCompBlock *pBlock, SField *pFields,
-                                 int32_t col, SData *sdata, void *tmpBuf, char *buffer, int32_t buffersize) {
+                                 int32_t col, int32_t vnode, SData *sdata, void *tmpBuf, char *buffer,
+                                 int32_t buffersize) {
   char *dst = (pBlock->algorithm) ? tmpBuf : sdata->data;
 
   int64_t offset = pBlock->offset + pFields[col].offset;
   SQInfo *pQInfo = (SQInfo *)GET_QINFO_ADDR(pQuery);
+  int32_t size = pFields[col].bytes * pBlock->numOfPoints;
 
   int     fd = pBlock->last ? pQueryFileInfo->lastFd : pQueryFileInfo->dataFd;
-  int32_t ret = (*readDataFunctor[DEFAULT_IO_ENGINE])(fd, pQInfo, pQueryFileInfo, dst, offset, pFields[col].len);
-  if (ret != 0) {
-    return ret;
-  }
+  int32_t ret = 0;
 
   // load checksum
   TSCKSUM checksum = 0;
@@ -562,6 +603,26 @@ static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFileInfo *pQueryFileInfo,
     return ret;
   }
 
+  // only the decompressed blocks are cached, uncompressed data are read from file directly
+  bool           useCache = pBlock->algorithm && vnodeBlockCacheEnabled();
+  SBlockCacheKey key = {.vnode = vnode,
+                        .fileId = pQueryFileInfo->fileID,
+                        .last = pBlock->last,
+                        .colId = pFields[col].colId,
+                        .offset = offset,
+                        .len = pFields[col].len,
+                        .numOfPoints = pBlock->numOfPoints,
+                        .checksum = checksum};
+
+  if (useCache && vnodeBlockCacheGet(&key, sdata->data, size)) {
+    return 0;
+  }
+
+  ret = (*readDataFunctor[DEFAULT_IO_ENGINE])(fd, pQInfo, pQueryFileInfo, dst, offset, pFields[col].len);
+  if (ret != 0) {
+    return ret;
+  }
+
   // check column data integrity
   if (checksum != taosCalcChecksum(0, (const uint8_t *)dst, pFields[col].len)) {
     dLError("QInfo:%p, column data checksum error, file:%s, col: %d, offset:%ld", GET_QINFO_ADDR(pQuery),
@@ -571,8 +632,11 @@ static int32_t loadColumnIntoMem(SQuery *pQuery, SQueryFileInfo *pQueryFileInfo,
   }
 
   if (pBlock->algorithm) {
-    (*pDecompFunc[pFields[col].type])(tmpBuf, pFields[col].len, pBlock->numOfPoints, sdata->data,
-                                      pFields[col].bytes * pBlock->numOfPoints, pBlock->algorithm, buffer, buffersize);
+    (*pDecompFunc[pFields[col].type])(tmpBuf, pFields[col].len, pBlock->numOfPoints, sdata->data, size,
+                                      pBlock->algorithm, buffer, buffersize);
+    if (useCache) {
+      vnodeBlockCachePut(&key, sdata->data, size);
+    }
   }
 
   return 0;
@@ -664,8 +728,8 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
     } else {
       columnBytes += (*pField)[PRIMARYKEY_TIMESTAMP_COL_INDEX].len + sizeof(TSCKSUM);
       int32_t ret =
-          loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, PRIMARYKEY_TIMESTAMP_COL_INDEX, *primaryTSBuf,
-                            tmpBuf, pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
+          loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, PRIMARYKEY_TIMESTAMP_COL_INDEX, pMeterObj->vnode,
+                            *primaryTSBuf, tmpBuf, pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
       if (ret != 0) {
         return -1;
       }
@@ -702,7 +766,7 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
           fillWithNull(pQuery, sdata[i]->data, i, pBlock->numOfPoints);
         } else {
           columnBytes += (*pField)[j].len + sizeof(TSCKSUM);
-          ret = loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, j, sdata[i], tmpBuf,
+          ret = loadColumnIntoMem(pQuery, pQueryFileInfo, pBlock, *pField, j, pMeterObj->vnode, sdata[i], tmpBuf,
                                   pRuntimeEnv->secondaryUnzipBuffer, pRuntimeEnv->unzipBufSize);
 
           pSummary->numOfSeek++;
@@ -737,6 +801,10 @@ static int32_t loadDataBlockIntoMem(SCompBlock *pBlock, SField **pField, SQueryR
          GET_QINFO_ADDR(pQuery), pMeterObj->vnode, pMeterObj->sid, pMeterObj->meterId, pQuery->slot, loadPrimaryCol,
          pBlock->numOfPoints, (et - st) / 1000.0);
 
+  for (int32_t k = 0; k < pBlock->numOfCols; ++k) {
+    pSummary->totalRowSize += (*pField)[k].len + sizeof(TSCKSUM);
+  }
+
   pSummary->totalBlockSize += columnBytes;
   pSummary->loadBlocksUs += (et - st);
   pSummary->readDiskBlocks++;
@@ -1191,21 +1259,11 @@ static bool needToLoadDataBlock(SQuery *pQuery, SField *pField, SQLFunctionCtx *
       continue;
     }
 
-    if (pFilterInfo->info.data.type == TSDB_DATA_TYPE_FLOAT) {
-      float minval = *(double *)(&pField[colIndex].min);
-      float maxval = *(double *)(&pField[colIndex].max);
-
-      for (int32_t i = 0; i < pFilterInfo->numOfFilters; ++i) {
-        if (pFilterInfo->pFilters[i].fp(&pFilterInfo->pFilters[i], (char *)&minval, (char *)&maxval)) {
-          return true;
-        }
-      }
-    } else {
-      for (int32_t i = 0; i < pFilterInfo->numOfFilters; ++i) {
-        if (pFilterInfo->pFilters[i].fp(&pFilterInfo->pFilters[i], (char *)&pField[colIndex].min,
-                                        (char *)&pField[colIndex].max)) {
-          return true;
-        }
+    // the min/max value of float column is kept in float, see getStatics_f
+    for (int32_t i = 0; i < pFilterInfo->numOfFilters; ++i) {
+      if (pFilterInfo->pFilters[i].fp(&pFilterInfo->pFilters[i], (char *)&pField[colIndex].min,
+                                      (char *)&pField[colIndex].max)) {
+        return true;
       }
     }
   }
@@ -1220,6 +1278,46 @@ static bool needToLoadDataBlock(SQuery *pQuery, SField *pField, SQLFunctionCtx *
   return true;
 }
 
+/*
+ * All rows in the data block are qualified by the value filter, if there is no null value in each filter column and
+ * both the min and max value of the column are qualified by one filter of this column. In this case, the
+ * pre-aggregation info in fields can be used instead of loading the data block.
+ */
+static bool allRowsQualifiedByFilter(SQuery *pQuery, SField *pField) {
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+    int32_t                  colIndex = pFilterInfo->info.colIdx;
+
+    if (colIndex < 0 || pField[colIndex].colId != pFilterInfo->info.data.colId ||
+        pField[colIndex].numOfNullPoints > 0 || !vnodeSupportPrefilter(pFilterInfo->info.data.type)) {
+      return false;
+    }
+
+    // the min/max value of float column is kept in float, see getStatics_f
+    char *minval = (char *)&pField[colIndex].min;
+    char *maxval = (char *)&pField[colIndex].max;
+
+    bool qualified = false;
+    for (int32_t i = 0; i < pFilterInfo->numOfFilters && !qualified; ++i) {
+      SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[i];
+
+      // not equal filter is not continuous, the values between min and max are unknown
+      if (pFilterElem->filterInfo.lowerRelOptr == TSDB_RELATION_NOT_EQUAL &&
+          memcmp(minval, maxval, pFilterInfo->info.data.bytes) != 0) {
+        continue;
+      }
+
+      qualified = pFilterElem->fp(pFilterElem, minval, minval) && pFilterElem->fp(pFilterElem, maxval, maxval);
+    }
+
+    if (!qualified) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static int32_t setGroupResultForKey(SQueryRuntimeEnv *pRuntimeEnv, char *pData, int16_t type, char *columnData) {
   SOutputRes *pOutputRes = NULL;
 
@@ -1376,6 +1474,24 @@ static bool functionNeedToExecute(SQueryRuntimeEnv *pRuntimeEnv, SQLFunctionCtx
   return true;
 }
 
+// set the input column data of filter columns
+static void setFilterColumnData(SQueryRuntimeEnv *pRuntimeEnv, char *data, bool isDiskFileBlock) {
+  SQuery *pQuery = pRuntimeEnv->pQuery;
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+    int32_t                  colIdx = isDiskFileBlock ? pFilterInfo->info.colIdxInBuf : pFilterInfo->info.colIdx;
+    SColumnInfo *            pColumnInfo = &pFilterInfo->info.data;
+
+    /*
+     * NOTE: here the tbname/tags column cannot reach here, since it will never be a filter column,
+     * so we do NOT check if is a tag or not
+     */
+    pFilterInfo->pData = doGetDataBlocks(isDiskFileBlock, pRuntimeEnv, data, colIdx, pColumnInfo->colId,
+                                         pColumnInfo->type, pColumnInfo->bytes, pFilterInfo->info.colIdxInBuf);
+  }
+}
+
 static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *forwardStep, TSKEY *primaryKeyCol,
                                         char *data, SField *pFields, SBlockInfo *pBlockInfo, bool isDiskFileBlock) {
   SQLFunctionCtx *pCtx = pRuntimeEnv->pCtx;
@@ -1412,19 +1528,7 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
                   pFields, hasNull, pRuntimeEnv->blockStatus, &sasArray[k], pRuntimeEnv->scanFlag);
   }
 
-  // set the input column data
-  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
-    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
-    int32_t                  colIdx = isDiskFileBlock ? pFilterInfo->info.colIdxInBuf : pFilterInfo->info.colIdx;
-    SColumnInfo *            pColumnInfo = &pFilterInfo->info.data;
-
-    /*
-     * NOTE: here the tbname/tags column cannot reach here, since it will never be a filter column,
-     * so we do NOT check if is a tag or not
-     */
-    pFilterInfo->pData = doGetDataBlocks(isDiskFileBlock, pRuntimeEnv, data, colIdx, pColumnInfo->colId,
-                                         pColumnInfo->type, pColumnInfo->bytes, pFilterInfo->info.colIdxInBuf);
-  }
+  setFilterColumnData(pRuntimeEnv, data, isDiskFileBlock);
 
   int32_t numOfRes = 0;
   int32_t step = GET_FORWARD_DIRECTION_FACTOR(pQuery->order.order);
@@ -1509,6 +1613,166 @@ static int32_t rowwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t *
   return num;
 }
 
+/*
+ * With value filter, the functions are applied on the qualified rows block-wisely, unless the functions or query
+ * need to be executed row by row, e.g., multi-output functions or checking the result buffer for each row.
+ */
+static bool functionsApplicableOnFilteredBlock(SQueryRuntimeEnv *pRuntimeEnv, TSKEY *primaryKeyCol) {
+  SQuery *pQuery = pRuntimeEnv->pQuery;
+
+  if (pRuntimeEnv->pTSBuf != NULL || isGroupbyNormalCol(pQuery->pGroupbyExpr) || pQuery->checkBufferInLoop == 1 ||
+      isPointInterpoQuery(pQuery) || !IS_DATA_BLOCK_LOADED(pRuntimeEnv->blockStatus) || primaryKeyCol == NULL) {
+    return false;
+  }
+
+  for (int32_t k = 0; k < pQuery->numOfOutputCols; ++k) {
+    int32_t functionId = pQuery->pSelectExpr[k].pBase.functionId;
+    if (IS_MULTIOUTPUT(aAggs[functionId].nStatus)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int32_t prepareFilteredDataBuffer(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOfRows) {
+  if (pRuntimeEnv->filteredBufRows >= numOfRows) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SQuery *pQuery = pRuntimeEnv->pQuery;
+
+  // cache blocks may be larger than the file block, so the buffer is enlarged on demand
+  numOfRows = MAX(numOfRows, pRuntimeEnv->pMeterObj->pointsPerFileBlock);
+
+  int32_t rowSize = TSDB_KEYSIZE;
+  for (int32_t i = 0; i < pQuery->numOfCols; ++i) {
+    rowSize += pQuery->colList[i].data.bytes;
+  }
+
+  char *pData = realloc(pRuntimeEnv->pFilteredData, (size_t)rowSize * numOfRows);
+  if (pData == NULL) {
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+  pRuntimeEnv->pFilteredData = pData;
+
+  // the second half is used to keep the bitmap of each filter column
+  uint64_t *pBitmap = realloc(pRuntimeEnv->pFilterBitmap, FILTER_BITMAP_WORDS(numOfRows) * 2 * sizeof(uint64_t));
+  if (pBitmap == NULL) {
+    return TSDB_CODE_SERV_OUT_OF_MEMORY;
+  }
+  pRuntimeEnv->pFilterBitmap = pBitmap;
+
+  pRuntimeEnv->filteredBufRows = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void gatherQualifiedRows(char *dst, const char *src, int32_t bytes, const uint64_t *bitmap, int32_t numOfRows) {
+  int32_t numOfWords = FILTER_BITMAP_WORDS(numOfRows);
+
+  for (int32_t i = 0; i < numOfWords; ++i) {
+    uint64_t bits = bitmap[i];
+
+    // all rows in this word are qualified, copy them at once
+    if (bits == UINT64_MAX) {
+      memcpy(dst, src + (i << 6) * bytes, 64 * bytes);
+      dst += 64 * bytes;
+      continue;
+    }
+
+    while (bits != 0) {
+      int32_t pos = (i << 6) + __builtin_ctzll(bits);
+      memcpy(dst, src + pos * bytes, bytes);
+
+      dst += bytes;
+      bits &= (bits - 1);
+    }
+  }
+}
+
+/**
+ * the rows qualified by the value filter are found with the bitmap of all filter columns, and gathered into the
+ * continuous buffer for each required column, then all functions are invoked on the qualified rows at once.
+ */
+static int32_t filteredBlockwiseApplyAllFunctions(SQueryRuntimeEnv *pRuntimeEnv, int32_t forwardStep,
+                                                  TSKEY *primaryKeyCol, char *data, SField *pFields,
+                                                  SBlockInfo *pBlockInfo, bool isDiskFileBlock) {
+  SQLFunctionCtx *pCtx = pRuntimeEnv->pCtx;
+  SQuery *        pQuery = pRuntimeEnv->pQuery;
+
+  int64_t prevNumOfRes = getNumOfResult(pRuntimeEnv);
+  setFilterColumnData(pRuntimeEnv, data, isDiskFileBlock);
+
+  // the order of qualified rows is the same as the data block, no matter the asc/desc query order
+  int32_t   startOffset = QUERY_IS_ASC_QUERY(pQuery) ? pQuery->pos : pQuery->pos - (forwardStep - 1);
+  uint64_t *bitmap = pRuntimeEnv->pFilterBitmap;
+
+  int32_t numOfQualified =
+      vnodeFilterDataBlock(pQuery, startOffset, forwardStep, bitmap, bitmap + FILTER_BITMAP_WORDS(forwardStep));
+  if (numOfQualified == 0) {
+    return 0;
+  }
+
+  int32_t capacity = pRuntimeEnv->filteredBufRows;
+  TSKEY * tsList = (TSKEY *)pRuntimeEnv->pFilteredData;
+  gatherQualifiedRows((char *)tsList, (char *)(primaryKeyCol + startOffset), TSDB_KEYSIZE, bitmap, forwardStep);
+
+  // only the columns required by the functions are gathered
+  char *colData[TSDB_MAX_COLUMNS] = {0};
+  for (int32_t k = 0; k < pQuery->numOfOutputCols; ++k) {
+    SColIndexEx *pCol = &pQuery->pSelectExpr[k].pBase.colInfo;
+    if (TSDB_COL_IS_TAG(pCol->flag) || colData[pCol->colIdxInBuf] != NULL) {
+      continue;
+    }
+
+    char *pDst = pRuntimeEnv->pFilteredData + (size_t)capacity * TSDB_KEYSIZE;
+    for (int32_t i = 0; i < pCol->colIdxInBuf; ++i) {
+      pDst += (size_t)capacity * pQuery->colList[i].data.bytes;
+    }
+
+    SColumnInfo *pColInfo = &pQuery->colList[pCol->colIdxInBuf].data;
+    int32_t      colIdx = isDiskFileBlock ? pCol->colIdxInBuf : pCol->colIdx;
+    int16_t      bytes = pColInfo->bytes;
+
+    char *pSrc = doGetDataBlocks(isDiskFileBlock, pRuntimeEnv, data, colIdx, pCol->colId, pColInfo->type, bytes,
+                                 pCol->colIdxInBuf);
+    gatherQualifiedRows(pDst, pSrc + startOffset * bytes, bytes, bitmap, forwardStep);
+    colData[pCol->colIdxInBuf] = pDst;
+  }
+
+  TSKEY   ts = QUERY_IS_ASC_QUERY(pQuery) ? pQuery->skey : pQuery->ekey;
+  int64_t alignedTimestamp =
+      taosGetIntervalStartTimestamp(ts, pQuery->nAggTimeInterval, pQuery->intervalTimeUnit, pQuery->precision);
+
+  for (int32_t k = 0; k < pQuery->numOfOutputCols; ++k) {
+    int32_t      functionId = pQuery->pSelectExpr[k].pBase.functionId;
+    SColIndexEx *pCol = &pQuery->pSelectExpr[k].pBase.colInfo;
+
+    char *dataBlock = TSDB_COL_IS_TAG(pCol->flag) ? NULL : colData[pCol->colIdxInBuf];
+    bool  hasNull = hasNullVal(pQuery, k, pBlockInfo, pFields, isDiskFileBlock);
+
+    // the pre-aggregation info of the block is not valid for the qualified rows
+    setExecParams(pQuery, &pCtx[k], alignedTimestamp, dataBlock, (char *)tsList, numOfQualified, functionId, NULL,
+                  hasNull, pRuntimeEnv->blockStatus, NULL, pRuntimeEnv->scanFlag);
+
+    // qualified rows start from the beginning of the buffer
+    pCtx[k].startOffset = 0;
+    pCtx[k].ptsList = tsList;
+  }
+
+  for (int32_t k = 0; k < pQuery->numOfOutputCols; ++k) {
+    int32_t functionId = pQuery->pSelectExpr[k].pBase.functionId;
+    if (functionNeedToExecute(pRuntimeEnv, &pCtx[k], functionId)) {
+      aAggs[functionId].xFunction(&pCtx[k]);
+    }
+  }
+
+  int64_t numOfIncrementRes = getNumOfResult(pRuntimeEnv) - prevNumOfRes;
+  validateTimestampForSupplementResult(pRuntimeEnv, numOfIncrementRes);
+
+  return (int32_t)numOfIncrementRes;
+}
+
 static int32_t getForwardStepsInBlock(int32_t numOfPoints, __block_search_fn_t searchFn, SQuery *pQuery,
                                       int64_t *pData) {
   int32_t endPos = searchFn((char *)pData, numOfPoints, pQuery->ekey, pQuery->order.order);
@@ -1627,7 +1891,14 @@ static int32_t applyFunctionsOnBlock(SQueryRuntimeEnv *pRuntimeEnv, SBlockInfo *
 
   bool isFileBlock = IS_FILE_BLOCK(pRuntimeEnv->blockStatus);
 
-  if (pQuery->numOfFilterCols > 0 || pRuntimeEnv->pTSBuf != NULL || isGroupbyNormalCol(pQuery->pGroupbyExpr)) {
+  // if the block is not loaded with value filter, all rows in this block are qualified by the filter
+  bool hasValueFilter = (pQuery->numOfFilterCols > 0) && IS_DATA_BLOCK_LOADED(pRuntimeEnv->blockStatus);
+
+  if (hasValueFilter && functionsApplicableOnFilteredBlock(pRuntimeEnv, pPrimaryColumn) &&
+      prepareFilteredDataBuffer(pRuntimeEnv, newForwardStep) == TSDB_CODE_SUCCESS) {
+    *numOfRes = filteredBlockwiseApplyAllFunctions(pRuntimeEnv, newForwardStep, pPrimaryColumn, sdata, pFields,
+                                                   pBlockInfo, isFileBlock);
+  } else if (hasValueFilter || pRuntimeEnv->pTSBuf != NULL || isGroupbyNormalCol(pQuery->pGroupbyExpr)) {
     *numOfRes =
         rowwiseApplyAllFunctions(pRuntimeEnv, &newForwardStep, pPrimaryColumn, sdata, pFields, pBlockInfo, isFileBlock);
   } else {
@@ -1767,6 +2038,15 @@ void setExecParams(SQuery *pQuery, SQLFunctionCtx *pCtx, int64_t startQueryTimes
     pCtx->preAggVals.max = pField->max;
     pCtx->preAggVals.min = pField->min;
     pCtx->preAggVals.numOfNull = pField->numOfNullPoints;
+
+    // the min/max value of float column is kept in float in fields, while double is expected by functions
+    if (pField->type == TSDB_DATA_TYPE_FLOAT) {
+      double min = GET_FLOAT_VAL(&pField->min);
+      double max = GET_FLOAT_VAL(&pField->max);
+
+      pCtx->preAggVals.min = *(int64_t *)&min;
+      pCtx->preAggVals.max = *(int64_t *)&max;
+    }
   } else {
     pCtx->preAggVals.isSet = false;
   }
@@ -1997,6 +2277,10 @@ static void teardownQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv) {
     tfree(pRuntimeEnv->colDataBuffer[i]);
   }
 
+  tfree(pRuntimeEnv->pFilteredData);
+  tfree(pRuntimeEnv->pFilterBitmap);
+  pRuntimeEnv->filteredBufRows = 0;
+
   tfree(pRuntimeEnv->secondaryUnzipBuffer);
 
   taosCleanUpIntHash(pRuntimeEnv->hashList);
@@ -2076,6 +2360,11 @@ bool isQueryKilled(SQuery *pQuery) {
     return true;
   }
 
+  // a query unit is stopped as soon as the query it belongs to is killed
+  if (pQInfo->pParent != NULL && pQInfo->pParent->killed == 1) {
+    pQInfo->killed = 1;
+  }
+
   return (pQInfo->killed == 1);
 }
 
@@ -2873,7 +3162,12 @@ static int32_t vnodeOpenVnodeDBFiles(SQInfo *pQInfo, SQueryFileInfo *pVnodeFiles
   snprintf(pVnodeFiles->headerFilePath, 256, "%s%s", prefix, fileName);
 
 #if 1
+  // head files are replaced with vmutex locked, so the version always matches the content of opened file
+  SVnodeObj *pVnode = &vnodeList[vnodeId];
+  pthread_mutex_lock(&pVnode->vmutex);
   pVnodeFiles->headerFd = open(pVnodeFiles->headerFilePath, O_RDONLY);
+  pVnodeFiles->headVersion = pVnode->headVersion;
+  pthread_mutex_unlock(&pVnode->vmutex);
 #else
   int32_t *val = (int32_t *)taosGetStrHashData(fileHandleHashList, pVnodeFiles->headerFilePath);
   if (val == NULL) {
@@ -3835,6 +4129,9 @@ int32_t vnodeMultiMeterQueryPrepare(SQInfo *pQInfo, SQuery *pQuery, void *param)
   tSidSetSort(pSupporter->pSidSet);
   vnodeOpenAllFiles(pQInfo, pMeter->vnode);
 
+  pSupporter->meterStartIdx = 0;
+  pSupporter->meterEndIdx = pSupporter->pSidSet->numOfSids;
+
   if ((ret = allocateOutputBufForGroup(pSupporter, pQuery, true)) != TSDB_CODE_SUCCESS) {
     return ret;
   }
@@ -4135,6 +4432,14 @@ static int32_t moveToNextBlockInCache(SQueryRuntimeEnv *pRuntimeEnv, int32_t ste
   return DISK_DATA_LOADED;
 }
 
+/*
+ * ask the kernel to read the block into page cache, so it is ready when the scan arrives at it
+ */
+void vnodePrefetchDataBlock(SQueryFileInfo *pQueryFileInfo, SCompBlock *pBlock) {
+  int fd = pBlock->last ? pQueryFileInfo->lastFd : pQueryFileInfo->dataFd;
+  posix_fadvise(fd, pBlock->offset, pBlock->len, POSIX_FADV_WILLNEED);
+}
+
 /**
  *  move the cursor to next block and not load
  */
@@ -4193,6 +4498,23 @@ static int32_t moveToNextBlock(SQueryRuntimeEnv *pRuntimeEnv, int32_t step, __bl
        */
       return ret;
     }
+
+    // blocks are not prefetched if they are answered by the block statistics
+    if (IS_DATA_BLOCK_LOADED(pRuntimeEnv->blockStatus)) {
+      int32_t distance = (pRuntimeEnv->prefetchSlot - pQuery->slot) * step;
+      if (pRuntimeEnv->pPrefetchMeter != pMeterObj || pRuntimeEnv->prefetchFileId != pQuery->fileId || distance <= 0 ||
+          distance > tsNumOfPrefetchBlocks + 1) {
+        pRuntimeEnv->pPrefetchMeter = pMeterObj;
+        pRuntimeEnv->prefetchFileId = pQuery->fileId;
+        pRuntimeEnv->prefetchSlot = pQuery->slot + step;
+      }
+
+      while (pRuntimeEnv->prefetchSlot >= 0 && pRuntimeEnv->prefetchSlot < pQuery->numOfBlocks &&
+             (pRuntimeEnv->prefetchSlot - pQuery->slot) * step <= tsNumOfPrefetchBlocks) {
+        vnodePrefetchDataBlock(&pRuntimeEnv->pHeaderFiles[fileIndex], &pQuery->pBlock[pRuntimeEnv->prefetchSlot]);
+        pRuntimeEnv->prefetchSlot += step;
+      }
+    }
   } else {  // data in cache
     return moveToNextBlockInCache(pRuntimeEnv, step, searchFn);
   }
@@ -5483,14 +5805,15 @@ SMeterDataInfo **vnodeFilterQualifiedMeters(SQInfo *pQInfo, int32_t vid, SQueryF
   int32_t groupId = 0;
   TSKEY   skey, ekey;
 
-  for (int32_t i = 0; i < pSidSet->numOfSids; ++i) {  // load all meter meta info
+  // load meta info of all meters in the range of current query
+  for (int32_t i = pSupporter->meterStartIdx; i < pSupporter->meterEndIdx; ++i) {
     SMeterObj *pMeterObj = getMeterObj(pSupporter->pMeterObj, pMeterSidExtInfo[i]->sid);
     if (pMeterObj == NULL) {
       dError("QInfo:%p failed to find required sid:%d", pQInfo, pMeterSidExtInfo[i]->sid);
       continue;
     }
 
-    if (i >= pSidSet->starterPos[groupId + 1]) {
+    while (i >= pSidSet->starterPos[groupId + 1]) {
       groupId += 1;
     }
 
@@ -5774,45 +6097,64 @@ uint32_t getDataBlocksForMeters(SMeterQuerySupportObj *pSupporter, SQuery *pQuer
     SMeterObj *pMeterObj = pMeterDataInfo[j]->pMeterObj;
 
     SCompInfo *compInfo = (SCompInfo *)(pHeaderData + pMeterDataInfo[j]->offsetInHeaderFile);
-    int32_t    ret = validateCompBlockInfoSegment(pQInfo, pQueryFileInfo->headerFilePath, pMeterObj->vnode, compInfo,
-                                               pMeterDataInfo[j]->offsetInHeaderFile);
-    if (ret != 0) {
-      clearMeterDataBlockInfo(pMeterDataInfo[j]);
-      continue;
-    }
+    SCompBlock *pCompBlock = (SCompBlock *)((char *)compInfo + sizeof(SCompInfo));
 
-    if (compInfo->numOfBlocks <= 0 || compInfo->uid != pMeterDataInfo[j]->pMeterObj->uid) {
-      clearMeterDataBlockInfo(pMeterDataInfo[j]);
-      continue;
-    }
+    /*
+     * the comp block info in cache has been validated by a previous query on the same head file, so the checksum
+     * of the mapped data is not calculated again. The blocks are referenced in the mapped file during the query.
+     */
+    SCompBlockCacheKey key;
+    getCompBlockCacheKey(&key, pMeterObj, pQueryFileInfo);
 
-    int32_t     size = compInfo->numOfBlocks * sizeof(SCompBlock);
-    SCompBlock *pCompBlock = (SCompBlock *)((char *)compInfo + sizeof(SCompInfo));
+    int32_t numOfCompBlocks = vnodeCompBlockCacheGet(&key, NULL);
+
+    if (numOfCompBlocks < 0) {
+      int32_t ret = validateCompBlockInfoSegment(pQInfo, pQueryFileInfo->headerFilePath, pMeterObj->vnode, compInfo,
+                                                 pMeterDataInfo[j]->offsetInHeaderFile);
+      if (ret != 0) {
+        clearMeterDataBlockInfo(pMeterDataInfo[j]);
+        continue;
+      }
 
-    int64_t st = taosGetTimestampUs();
+      if (compInfo->numOfBlocks <= 0 || compInfo->uid != pMeterDataInfo[j]->pMeterObj->uid) {
+        vnodeCompBlockCachePut(&key, NULL, 0);
+        clearMeterDataBlockInfo(pMeterDataInfo[j]);
+        continue;
+      }
 
-    // check compblock integrity
-    TSCKSUM checksum = *(TSCKSUM *)((char *)compInfo + sizeof(SCompInfo) + size);
-    ret = validateCompBlockSegment(pQInfo, pQueryFileInfo->headerFilePath, compInfo, (char *)pCompBlock,
-                                   pMeterObj->vnode, checksum);
-    if (ret < 0) {
+      int32_t size = compInfo->numOfBlocks * sizeof(SCompBlock);
+
+      int64_t st = taosGetTimestampUs();
+
+      // check compblock integrity
+      TSCKSUM checksum = *(TSCKSUM *)((char *)compInfo + sizeof(SCompInfo) + size);
+      ret = validateCompBlockSegment(pQInfo, pQueryFileInfo->headerFilePath, compInfo, (char *)pCompBlock,
+                                     pMeterObj->vnode, checksum);
+      if (ret < 0) {
+        clearMeterDataBlockInfo(pMeterDataInfo[j]);
+        continue;
+      }
+
+      int64_t et = taosGetTimestampUs();
+
+      pSummary->readCompInfo++;
+      pSummary->totalCompInfoSize += (size + sizeof(SCompInfo) + sizeof(TSCKSUM));
+      pSummary->loadCompInfoUs += (et - st);
+
+      numOfCompBlocks = compInfo->numOfBlocks;
+      vnodeCompBlockCachePut(&key, pCompBlock, numOfCompBlocks);
+    } else if (numOfCompBlocks == 0) {
       clearMeterDataBlockInfo(pMeterDataInfo[j]);
       continue;
     }
 
-    int64_t et = taosGetTimestampUs();
-
-    pSummary->readCompInfo++;
-    pSummary->totalCompInfoSize += (size + sizeof(SCompInfo) + sizeof(TSCKSUM));
-    pSummary->loadCompInfoUs += (et - st);
-
     if (!setCurrentQueryRange(pMeterDataInfo[j], pQuery, pSupporter->rawEKey, &minval, &maxval)) {
       clearMeterDataBlockInfo(pMeterDataInfo[j]);
       continue;
     }
 
     int32_t end = 0;
-    if (!getValidDataBlocksRangeIndex(pMeterDataInfo[j], pQuery, pCompBlock, compInfo->numOfBlocks, minval, maxval,
+    if (!getValidDataBlocksRangeIndex(pMeterDataInfo[j], pQuery, pCompBlock, numOfCompBlocks, minval, maxval,
                                       &end)) {
       clearMeterDataBlockInfo(pMeterDataInfo[j]);
       continue;
@@ -6470,6 +6812,7 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, int8_t *blkS
   SQueryFileInfo *pQueryFileInfo = &pRuntimeEnv->pHeaderFiles[fileIdx];
 
   TSKEY *primaryKeys = (TSKEY *)pRuntimeEnv->primaryColBuffer->data;
+  bool   fieldsLoaded = false;
 
   pQuery->slot = slotIdx;
   pQuery->pos = QUERY_IS_ASC_QUERY(pQuery) ? 0 : pBlock->numOfPoints - 1;
@@ -6481,17 +6824,25 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, int8_t *blkS
        (pQuery->ekey <= pBlock->keyFirst && pQuery->lastKey >= pBlock->keyLast && !QUERY_IS_ASC_QUERY(pQuery))) &&
       onDemand) {
     int32_t req = 0;
-    if (pQuery->numOfFilterCols > 0) {
-      req = BLK_DATA_ALL_NEEDED;
-    } else {
-      for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
-        int32_t functID = pQuery->pSelectExpr[i].pBase.functionId;
-        req |= aAggs[functID].dataReqFunc(&pRuntimeEnv->pCtx[i], pBlock->keyFirst, pBlock->keyLast,
-                                          pQuery->pSelectExpr[i].pBase.colInfo.colId, *blkStatus);
+    for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+      int32_t functID = pQuery->pSelectExpr[i].pBase.functionId;
+      req |= aAggs[functID].dataReqFunc(&pRuntimeEnv->pCtx[i], pBlock->keyFirst, pBlock->keyLast,
+                                        pQuery->pSelectExpr[i].pBase.colInfo.colId, *blkStatus);
+    }
+
+    if (pRuntimeEnv->pTSBuf > 0) {
+      req |= BLK_DATA_ALL_NEEDED;
+    }
+
+    // with value filter, the data block is not required only if all rows are qualified according to the fields
+    if (pQuery->numOfFilterCols > 0 && req != BLK_DATA_ALL_NEEDED) {
+      if (loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pFields) < 0) {
+        return DISK_DATA_LOAD_FAILED;
       }
 
-      if (pRuntimeEnv->pTSBuf > 0) {
-        req |= BLK_DATA_ALL_NEEDED;
+      fieldsLoaded = true;
+      if (!allRowsQualifiedByFilter(pQuery, *pFields)) {
+        req = BLK_DATA_ALL_NEEDED;
       }
     }
 
@@ -6501,17 +6852,20 @@ int32_t LoadDatablockOnDemand(SCompBlock *pBlock, SField **pFields, int8_t *blkS
              pBlock->keyFirst, pBlock->keyLast, pBlock->numOfPoints);
 
       setTimestampRange(pRuntimeEnv, pBlock->keyFirst, pBlock->keyLast);
+      pRuntimeEnv->summary.blocksByStatis++;
     } else if (req == BLK_DATA_FILEDS_NEEDED) {
-      if (loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pFields) < 0) {
+      if (!fieldsLoaded && loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pFields) < 0) {
         return DISK_DATA_LOAD_FAILED;
       }
+
+      pRuntimeEnv->summary.blocksByStatis++;
     } else {
       assert(req == BLK_DATA_ALL_NEEDED);
       goto _load_all;
     }
   } else {
   _load_all:
-    if (loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pFields) < 0) {
+    if (!fieldsLoaded && loadDataBlockFieldsInfo(pRuntimeEnv, pQueryFileInfo, pBlock, pFields) < 0) {
       return DISK_DATA_LOAD_FAILED;
     }
 
@@ -6765,6 +7119,59 @@ void copyFromGroupBuf(SQInfo *pQInfo, SOutputRes *result) {
   assert(pQuery->pointsRead <= pQuery->pointsToRead);
 }
 
+/**
+ * merge the partial results of one query unit into the group results of current query.
+ * Both of them are generated against the same groups, and the meters scanned by them are disjoint.
+ *
+ * @param pSupporter
+ * @param pUnitResult
+ */
+void mergeUnitResultToGroups(SMeterQuerySupportObj *pSupporter, SOutputRes *pUnitResult) {
+  SQueryRuntimeEnv *pRuntimeEnv = &pSupporter->runtimeEnv;
+  SQuery *          pQuery = pRuntimeEnv->pQuery;
+  SQLFunctionCtx *  pCtx = pRuntimeEnv->pCtx;
+
+  for (int32_t i = 0; i < pSupporter->pSidSet->numOfSubSet; ++i) {
+    SOutputRes *pSrc = &pUnitResult[i];
+    SOutputRes *pDst = &pSupporter->pResult[i];
+
+    if (pSrc->numOfRows == 0) {
+      continue;
+    }
+
+    // no result for this group in current query, take over the result of the unit
+    if (pDst->numOfRows == 0) {
+      SWAP(*pDst, *pSrc, SOutputRes);
+      continue;
+    }
+
+    setGroupOutputBuffer(pRuntimeEnv, pDst);
+
+    for (int32_t j = 0; j < pQuery->numOfOutputCols; ++j) {
+      int32_t functionId = pQuery->pSelectExpr[j].pBase.functionId;
+
+      pCtx[j].currentStage = FIRST_STAGE_MERGE;
+      pCtx[j].size = 1;
+      pCtx[j].hasNull = true;
+      pCtx[j].aInputElemBuf = pSrc->result[j]->data;
+
+      if (functionId == TSDB_FUNC_TAG_DUMMY || functionId == TSDB_FUNC_TAG) {
+        tVariantDestroy(&pCtx[j].tag);
+        tVariantCreateFromBinary(&pCtx[j].tag, pCtx[j].aInputElemBuf, pCtx[j].inputBytes, pCtx[j].inputType);
+      }
+    }
+
+    for (int32_t j = 0; j < pQuery->numOfOutputCols; ++j) {
+      int32_t functionId = pQuery->pSelectExpr[j].pBase.functionId;
+      if (functionId == TSDB_FUNC_TAG_DUMMY) {
+        continue;
+      }
+
+      aAggs[functionId].distMergeFunc(&pCtx[j]);
+    }
+  }
+}
+
 // todo refactor according to its called env!!
 static void getAlignedIntervalQueryRange(SQuery *pQuery, TSKEY keyInData, TSKEY skey, TSKEY ekey) {
   if (pQuery->nAggTimeInterval == 0) {
@@ -6914,30 +7321,131 @@ static int32_t resultInterpolate(SQInfo *pQInfo, tFilePage **data, tFilePage **p
   return numOfRes;
 }
 
-static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data, int32_t* size) {
+/*
+ * compress each column by the codec of its type, binary columns are compressed by LZ4.
+ * The size of compressed result is returned, or -1 if the result is not smaller after compression or out of memory.
+ */
+static int32_t doCompressQueryResultByColumn(SQInfo *pQInfo, int32_t numOfRows, char *data) {
+  SQuery *pQuery = &pQInfo->query;
+
+  int     tnumOfRows = vnodeList[pQInfo->pObj->vnode].cfg.rowsInFileBlock;
+  int32_t dataSize = pQuery->rowSize * numOfRows;
+
+  int32_t maxBytes = 0;
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {
+    maxBytes = MAX(maxBytes, pQuery->pSelectExpr[col].resBytes);
+  }
+
+  int32_t bufferSize = maxBytes * numOfRows + EXTRA_BYTES;
+  char *  buffer = malloc((size_t)bufferSize);
+  char *  compBuf = malloc((size_t)dataSize + (sizeof(SRetrieveColHeader) + EXTRA_BYTES) * pQuery->numOfOutputCols);
+  if (buffer == NULL || compBuf == NULL) {
+    dError("QInfo:%p failed to allocate compression buffer, rsp msg is not compressed", pQInfo);
+    tfree(buffer);
+    tfree(compBuf);
+    return -1;
+  }
+
+  char *d = compBuf;
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {
+    int32_t bytes = pQuery->pSelectExpr[col].resBytes;
+    int16_t type = pQuery->pSelectExpr[col].resType;
+    char *  src = pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex;
+
+    SRetrieveColHeader *pHeader = (SRetrieveColHeader *)d;
+    d += sizeof(SRetrieveColHeader);
+
+    int32_t len = 0;
+    if (type >= TSDB_DATA_TYPE_BOOL && type <= TSDB_DATA_TYPE_NCHAR) {
+      len = (*pCompFunc[type])(src, bytes * numOfRows, numOfRows, d, bytes * numOfRows + EXTRA_BYTES, TWO_STAGE_COMP,
+                               buffer, bufferSize);
+    } else {
+      len = tsCompressString(src, bytes * numOfRows, numOfRows, d, bytes * numOfRows + EXTRA_BYTES, TWO_STAGE_COMP,
+                             buffer, bufferSize);
+    }
+
+    pHeader->type = (int8_t)type;
+    pHeader->bytes = htons((int16_t)bytes);
+    pHeader->compLen = htonl(len);
+    d += len;
+  }
+
+  int32_t size = (int32_t)(d - compBuf);
+  if (size < dataSize) {
+    memcpy(data, compBuf, (size_t)size);
+  } else {
+    size = -1;
+  }
+
+  free(compBuf);
+  free(buffer);
+  return size;
+}
+
+/*
+ * compress the whole result by LZ4, which is the only format an old client can decompress. The old client derives
+ * the decompressed size from its final result fields, so the intermediate result of a super table query, whose
+ * columns may be wider, is never compressed in this way.
+ * The size of compressed result is returned, or -1 if the result is not smaller after compression or out of memory.
+ */
+static int32_t doCompressQueryResult(SQInfo *pQInfo, int32_t numOfRows, char *data) {
+  SQuery *pQuery = &pQInfo->query;
+
+  int     tnumOfRows = vnodeList[pQInfo->pObj->vnode].cfg.rowsInFileBlock;
+  int32_t dataSize = pQuery->rowSize * numOfRows;
+
+  char *compBuf = malloc((size_t)dataSize);
+  if (compBuf == NULL) {
+    dError("QInfo:%p failed to allocate compression buffer, rsp msg is not compressed", pQInfo);
+    return -1;
+  }
+
+  char *d = compBuf;
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {
+    int32_t bytes = pQuery->pSelectExpr[col].resBytes;
+
+    memcpy(d, pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex, bytes * numOfRows);
+    d += bytes * numOfRows;
+  }
+
+  int32_t size = tsCompressString(compBuf, dataSize, 1, data, dataSize + EXTRA_BYTES, 0, 0, 0);
+  if (size >= dataSize) {
+    size = -1;
+  }
+
+  free(compBuf);
+  return size;
+}
+
+/*
+ * the format of the result in msg is returned in compress, which holds the best format the client accepts
+ */
+static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data, int32_t* size, int16_t *compress) {
   SMeterObj* pObj = pQInfo->pObj;
   SQuery* pQuery = &pQInfo->query;
 
   int tnumOfRows = vnodeList[pObj->vnode].cfg.rowsInFileBlock;
   int32_t dataSize = pQInfo->query.rowSize * numOfRows;
 
+  int32_t compSize = -1;
   if (dataSize >= tsCompressMsgSize && tsCompressMsgSize > 0) {
-    char* compBuf = malloc((size_t) dataSize);
-
-    // for metric query, bufIndex always be 0.
-    char* d = compBuf;
-    for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {  // pQInfo->bufIndex == 0
-      int32_t bytes = pQuery->pSelectExpr[col].resBytes;
-
-      memmove(d, pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex, bytes * numOfRows);
-      d += bytes * numOfRows;
+    if (*compress == TSDB_RSP_COMPRESS_COLUMN) {
+      compSize = doCompressQueryResultByColumn(pQInfo, numOfRows, data);
+    } else if (*compress == TSDB_RSP_COMPRESS_LZ4 && pQInfo->pMeterQuerySupporter == NULL) {
+      compSize = doCompressQueryResult(pQInfo, numOfRows, data);
     }
 
-    *size = tsCompressString(compBuf, dataSize, 1, data, dataSize + EXTRA_BYTES, 0, 0, 0);
+    if (compSize > 0) {
+      int64_t saved = atomic_add_fetch_64(&vnodeRetrieveSavedBytes, dataSize - compSize);
+      atomic_add_fetch_64(&vnodeRetrieveCompressedBytes, dataSize);
+      dTrace("QInfo:%p compress rsp msg, before:%d, after:%d, total saved:%ld", pQInfo, dataSize, compSize, saved);
+    }
+  }
 
-    dTrace("QInfo:%p compress rsp msg, before:%d, after:%d", pQInfo, dataSize, *size);
-    free(compBuf);
+  if (compSize > 0) {
+    *size = compSize;
   } else { // for metric query, bufIndex always be 0.
+    *compress = TSDB_RSP_COMPRESS_NONE;
     for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {  // pQInfo->bufIndex == 0
       int32_t bytes = pQuery->pSelectExpr[col].resBytes;
 
@@ -6958,7 +7466,7 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char* data
  * @param numOfRows the number of rows that are not returned in current retrieve
  * @return
  */
-int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t* size) {
+int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, int32_t* size, int16_t *compress) {
   SQInfo *pQInfo = (SQInfo *)handle;
   SQuery *   pQuery = &pQInfo->query;
 
@@ -6966,6 +7474,7 @@ int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, i
 
   // load data from file to msg buffer
   if (isTSCompQuery(pQuery)) {
+    *compress = TSDB_RSP_COMPRESS_NONE;
     int32_t fd = open(pQuery->sdata[0]->data, O_RDONLY, 0666);
 
     // make sure file exist
@@ -6983,12 +7492,51 @@ int32_t vnodeCopyQueryResultToMsg(void *handle, char *data, int32_t numOfRows, i
              pQuery->sdata[0]->data, strerror(errno));
     }
   } else {
-    doCopyQueryResultToMsg(pQInfo, numOfRows, data, size);
+    doCopyQueryResultToMsg(pQInfo, numOfRows, data, size, compress);
   }
 
   return numOfRows;
 }
 
+/**
+ * Refer to the result of each column in place, instead of copying them into the message buffer.
+ * Only the result of projection query on one meter is referred, since it is double buffered and the next round of
+ * query writes into the other buffer. Zero is returned if the result has to be copied, i.e., the output buffer is
+ * reused by the next round, the result is kept in file or needs to be compressed.
+ *
+ * @param handle
+ * @param numOfRows the number of rows that are not returned in current retrieve
+ * @param pIov      array of numOfOutputCols elements, it should be freed by caller
+ * @return          the number of elements in pIov
+ */
+int32_t vnodeGetQueryResultIov(void *handle, int32_t numOfRows, struct iovec **pIov) {
+  SQInfo *pQInfo = (SQInfo *)handle;
+  SQuery *pQuery = &pQInfo->query;
+
+  *pIov = NULL;
+
+  int32_t dataSize = pQuery->rowSize * numOfRows;
+  if (pQInfo->pMeterQuerySupporter != NULL || (dataSize >= tsCompressMsgSize && tsCompressMsgSize > 0)) {
+    return 0;
+  }
+
+  struct iovec *iov = malloc(sizeof(struct iovec) * pQuery->numOfOutputCols);
+  if (iov == NULL) {
+    return 0;
+  }
+
+  int tnumOfRows = vnodeList[pQInfo->pObj->vnode].cfg.rowsInFileBlock;
+  for (int32_t col = 0; col < pQuery->numOfOutputCols; ++col) {
+    int32_t bytes = pQuery->pSelectExpr[col].resBytes;
+
+    iov[col].iov_base = pQuery->sdata[col]->data + bytes * tnumOfRows * pQInfo->bufIndex;
+    iov[col].iov_len = bytes * numOfRows;
+  }
+
+  *pIov = iov;
+  return pQuery->numOfOutputCols;
+}
+
 int32_t vnodeQueryResultInterpolate(SQInfo *pQInfo, tFilePage **pDst, tFilePage **pDataSrc, int32_t numOfRows,
                                     int32_t *numOfInterpo) {
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
@@ -7058,10 +7606,12 @@ void vnodePrintQueryStatistics(SMeterQuerySupportObj *pSupporter) {
          pSummary->loadFieldUs / 1000.0);
 
   dTrace(
-      "QInfo:%p statis: file blocks:%d, size:%d Bytes, elapsed time:%.2f ms, skipped:%d, in-memory gen null:%d Bytes",
-      pQInfo, pSummary->readDiskBlocks, pSummary->totalBlockSize, pSummary->loadBlocksUs / 1000.0,
+      "QInfo:%p statis: file blocks:%" PRId64 ", size:%" PRId64 " Bytes(%" PRId64 " Bytes of all columns), "
+      "elapsed time:%.2f ms, skipped:%" PRId64 ", in-memory gen null:%" PRId64 " Bytes",
+      pQInfo, pSummary->readDiskBlocks, pSummary->totalBlockSize, pSummary->totalRowSize, pSummary->loadBlocksUs / 1000.0,
       pSummary->skippedFileBlocks, pSummary->totalGenData);
 
+  dTrace("QInfo:%p statis: file blocks answered by block statistics:%d", pQInfo, pSummary->blocksByStatis);
   dTrace("QInfo:%p statis: cache blocks:%d", pQInfo, pSummary->blocksInCache, 0);
   dTrace("QInfo:%p statis: temp file:%d Bytes", pQInfo, pSummary->tmpBufferInDisk);
 
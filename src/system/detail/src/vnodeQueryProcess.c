@@ -103,8 +103,8 @@ static SMeterDataInfo *queryOnMultiDataCache(SQInfo *pQInfo, SMeterDataInfo *pMe
   int32_t totalBlocks = 0;
 
   for (int32_t groupIdx = 0; groupIdx < pSupporter->pSidSet->numOfSubSet; ++groupIdx) {
-    int32_t start = pSupporter->pSidSet->starterPos[groupIdx];
-    int32_t end = pSupporter->pSidSet->starterPos[groupIdx + 1] - 1;
+    int32_t start = MAX(pSupporter->pSidSet->starterPos[groupIdx], pSupporter->meterStartIdx);
+    int32_t end = MIN(pSupporter->pSidSet->starterPos[groupIdx + 1], pSupporter->meterEndIdx) - 1;
 
     if (isQueryKilled(pQuery)) {
       return pMeterInfo;
@@ -344,6 +344,9 @@ static SMeterDataInfo *queryOnMultiDataFiles(SQInfo *pQInfo, SMeterDataInfo *pMe
     // sequentially scan the pHeaderData file
     int32_t j = QUERY_IS_ASC_QUERY(pQuery) ? 0 : numOfBlocks - 1;
 
+    // blocks in (j, prefetchIdx) have been prefetched
+    int32_t prefetchIdx = j + step;
+
     for (; j < numOfBlocks && j >= 0; j += step) {
       if (isQueryKilled(pQuery)) {
         break;
@@ -396,6 +399,18 @@ static SMeterDataInfo *queryOnMultiDataFiles(SQInfo *pQInfo, SMeterDataInfo *pMe
         continue;
       }
 
+      // keep the following blocks being read by kernel, unless blocks are answered by the block statistics
+      if (IS_DATA_BLOCK_LOADED(pRuntimeEnv->blockStatus)) {
+        if ((prefetchIdx - j) * step <= 0) {
+          prefetchIdx = j + step;
+        }
+
+        while (prefetchIdx >= 0 && prefetchIdx < numOfBlocks && (prefetchIdx - j) * step <= tsNumOfPrefetchBlocks) {
+          vnodePrefetchDataBlock(pQueryFileInfo, pDataBlockInfoEx[prefetchIdx].pBlock.compBlock);
+          prefetchIdx += step;
+        }
+      }
+
       SBlockInfo binfo = getBlockBasicInfo(pBlock, BLK_FILE_BLOCK);
 
       assert(pQuery->pos >= 0 && pQuery->pos < pBlock->numOfPoints);
@@ -845,6 +860,155 @@ static void doMultiMeterSupplementaryScan(SQInfo *pQInfo) {
   SET_MASTER_SCAN_FLAG(pRuntimeEnv);
 }
 
+static bool doMultiMeterQueryScan(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SQuery *               pQuery = &pQInfo->query;
+
+  pSupporter->pMeterDataInfo = (SMeterDataInfo *)calloc(1, sizeof(SMeterDataInfo) * pSupporter->numOfMeters);
+  if (pSupporter->pMeterDataInfo == NULL) {
+    dError("QInfo:%p failed to allocate memory, %s", pQInfo, strerror(errno));
+    return false;
+  }
+
+  dTrace("QInfo:%p query start, qrange:%lld-%lld, order:%d, group:%d, meters:%d-%d", pQInfo, pSupporter->rawSKey,
+         pSupporter->rawEKey, pQuery->order.order, pSupporter->pSidSet->numOfSubSet, pSupporter->meterStartIdx,
+         pSupporter->meterEndIdx - 1);
+
+  dTrace("QInfo:%p main query scan start", pQInfo);
+  int64_t st = taosGetTimestampMs();
+  doOrderedScan(pQInfo);
+  int64_t et = taosGetTimestampMs();
+  dTrace("QInfo:%p main scan completed, elapsed time: %lldms, supplementary scan start, order:%d", pQInfo, et - st,
+         pQuery->order.order ^ 1);
+
+  doCloseAllOpenedResults(pSupporter);
+  doMultiMeterSupplementaryScan(pQInfo);
+
+  return true;
+}
+
+static void doRunQueryUnits(SQueryParallelInfo *pParallelInfo) {
+  SQInfo *pQInfo = pParallelInfo->pUnits[0];
+
+  while (1) {
+    int32_t index = atomic_fetch_add_32(&pParallelInfo->nextUnit, 1);
+    if (index >= pParallelInfo->numOfUnits) {
+      break;
+    }
+
+    SQInfo *pUnit = pParallelInfo->pUnits[index];
+    if (pQInfo->killed) {
+      pUnit->killed = 1;
+    }
+
+    if (!doMultiMeterQueryScan(pUnit)) {
+      pQInfo->code = TSDB_CODE_SERV_OUT_OF_MEMORY;
+      pQInfo->killed = 1;
+    }
+
+    pthread_mutex_lock(&pParallelInfo->mutex);
+    if (++pParallelInfo->completed == pParallelInfo->numOfUnits) {
+      pthread_cond_signal(&pParallelInfo->cond);
+    }
+    pthread_mutex_unlock(&pParallelInfo->mutex);
+  }
+}
+
+static void vnodeMultiMeterQueryUnit(SSchedMsg *pMsg) {
+  SQueryParallelInfo *pParallelInfo = (SQueryParallelInfo *)pMsg->ahandle;
+
+  doRunQueryUnits(pParallelInfo);
+  vnodeReleaseQueryParallelInfo(pParallelInfo);
+}
+
+void vnodeReleaseQueryParallelInfo(SQueryParallelInfo *pParallelInfo) {
+  if (atomic_sub_fetch_32(&pParallelInfo->refCount, 1) > 0) {
+    return;
+  }
+
+  pthread_mutex_destroy(&pParallelInfo->mutex);
+  pthread_cond_destroy(&pParallelInfo->cond);
+
+  tfree(pParallelInfo->pUnits);
+  free(pParallelInfo);
+}
+
+static void mergeQueryCostSummary(SQueryCostSummary *pSummary, SQueryCostSummary *pUnitSummary) {
+  pSummary->cacheTimeUs += pUnitSummary->cacheTimeUs;
+  pSummary->fileTimeUs += pUnitSummary->fileTimeUs;
+  pSummary->numOfFiles += pUnitSummary->numOfFiles;
+  pSummary->numOfSeek += pUnitSummary->numOfSeek;
+  pSummary->readDiskBlocks += pUnitSummary->readDiskBlocks;
+  pSummary->skippedFileBlocks += pUnitSummary->skippedFileBlocks;
+  pSummary->blocksByStatis += pUnitSummary->blocksByStatis;
+  pSummary->blocksInCache += pUnitSummary->blocksInCache;
+  pSummary->readField += pUnitSummary->readField;
+  pSummary->totalFieldSize += pUnitSummary->totalFieldSize;
+  pSummary->loadFieldUs += pUnitSummary->loadFieldUs;
+  pSummary->totalBlockSize += pUnitSummary->totalBlockSize;
+  pSummary->totalRowSize += pUnitSummary->totalRowSize;
+  pSummary->loadBlocksUs += pUnitSummary->loadBlocksUs;
+  pSummary->totalGenData += pUnitSummary->totalGenData;
+  pSummary->readCompInfo += pUnitSummary->readCompInfo;
+  pSummary->totalCompInfoSize += pUnitSummary->totalCompInfoSize;
+  pSummary->loadCompInfoUs += pUnitSummary->loadCompInfoUs;
+}
+
+/*
+ * The meters are split into units that are claimed by idle query threads. Current thread claims units as well,
+ * so the query is completed even if all query threads are busy, and it only waits for the units that are
+ * being executed by other threads.
+ */
+static void doParallelMultiMeterQueryScan(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  SQueryParallelInfo *   pParallelInfo = pSupporter->pParallelInfo;
+
+  int64_t st = taosGetTimestampMs();
+
+  SSchedMsg schedMsg = {0};
+  schedMsg.fp = vnodeMultiMeterQueryUnit;
+  schedMsg.msg = NULL;
+  schedMsg.thandle = (void *)1;
+  schedMsg.ahandle = pParallelInfo;
+
+  for (int32_t i = 1; i < pParallelInfo->numOfUnits; ++i) {
+    atomic_add_fetch_32(&pParallelInfo->refCount, 1);
+    taosScheduleTask(queryQhandle, &schedMsg);
+  }
+
+  doRunQueryUnits(pParallelInfo);
+
+  pthread_mutex_lock(&pParallelInfo->mutex);
+  while (pParallelInfo->completed < pParallelInfo->numOfUnits) {
+    pthread_cond_wait(&pParallelInfo->cond, &pParallelInfo->mutex);
+  }
+  pthread_mutex_unlock(&pParallelInfo->mutex);
+
+  int64_t et = taosGetTimestampMs();
+  dTrace("QInfo:%p %d query units completed, elapsed time: %lldms, start to merge results", pQInfo,
+         pParallelInfo->numOfUnits, et - st);
+
+  for (int32_t i = 1; i < pParallelInfo->numOfUnits; ++i) {
+    SQInfo *               pUnit = pParallelInfo->pUnits[i];
+    SMeterQuerySupportObj *pUnitSupporter = pUnit->pMeterQuerySupporter;
+
+    if (!isQueryKilled(&pQInfo->query)) {
+      mergeUnitResultToGroups(pSupporter, pUnitSupporter->pResult);
+    }
+
+    mergeQueryCostSummary(&pSupporter->runtimeEnv.summary, &pUnitSupporter->runtimeEnv.summary);
+
+    vnodeFreeQInfo(pUnit, false);
+    pParallelInfo->pUnits[i] = NULL;
+  }
+
+  dTrace("QInfo:%p results of %d query units merged, elapsed time: %lldms", pQInfo, pParallelInfo->numOfUnits,
+         taosGetTimestampMs() - et);
+
+  pSupporter->pParallelInfo = NULL;
+  vnodeReleaseQueryParallelInfo(pParallelInfo);
+}
+
 static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
   SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
   SQuery *               pQuery = &pQInfo->query;
@@ -875,25 +1039,12 @@ static void vnodeMultiMeterQueryProcessor(SQInfo *pQInfo) {
     return;
   }
 
-  pSupporter->pMeterDataInfo = (SMeterDataInfo *)calloc(1, sizeof(SMeterDataInfo) * pSupporter->numOfMeters);
-  if (pSupporter->pMeterDataInfo == NULL) {
-    dError("QInfo:%p failed to allocate memory, %s", pQInfo, strerror(errno));
+  if (pSupporter->pParallelInfo != NULL) {
+    doParallelMultiMeterQueryScan(pQInfo);
+  } else if (!doMultiMeterQueryScan(pQInfo)) {
     return;
   }
 
-  dTrace("QInfo:%p query start, qrange:%lld-%lld, order:%d, group:%d", pQInfo, pSupporter->rawSKey, pSupporter->rawEKey,
-         pQuery->order.order, pSupporter->pSidSet->numOfSubSet);
-
-  dTrace("QInfo:%p main query scan start", pQInfo);
-  int64_t st = taosGetTimestampMs();
-  doOrderedScan(pQInfo);
-  int64_t et = taosGetTimestampMs();
-  dTrace("QInfo:%p main scan completed, elapsed time: %lldms, supplementary scan start, order:%d", pQInfo, et - st,
-         pQuery->order.order ^ 1);
-
-  doCloseAllOpenedResults(pSupporter);
-  doMultiMeterSupplementaryScan(pQInfo);
-
   if (isQueryKilled(pQuery)) {
     dTrace("QInfo:%p query killed, abort", pQInfo);
     return;
@@ -25,6 +25,7 @@
 #include "vnode.h"
 #include "vnodeRead.h"
 #include "vnodeUtil.h"
+#include "vnodeQueryImpl.h"
 
 #pragma GCC diagnostic ignored "-Wint-conversion"
 
@@ -394,6 +395,24 @@ __clean_memory:
   return NULL;
 }
 
+static void vnodeFreeQueryUnits(SQInfo *pQInfo) {
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+  if (pSupporter == NULL || pSupporter->pParallelInfo == NULL) {
+    return;
+  }
+
+  SQueryParallelInfo *pParallelInfo = pSupporter->pParallelInfo;
+  for (int32_t i = 1; i < pParallelInfo->numOfUnits; ++i) {
+    if (pParallelInfo->pUnits[i] != NULL) {
+      vnodeFreeQInfo(pParallelInfo->pUnits[i], false);
+      pParallelInfo->pUnits[i] = NULL;
+    }
+  }
+
+  pSupporter->pParallelInfo = NULL;
+  vnodeReleaseQueryParallelInfo(pParallelInfo);
+}
+
 static void vnodeFreeQInfoInQueueImpl(SSchedMsg *pMsg) {
   SQInfo *pQInfo = (SQInfo *)pMsg->ahandle;
   vnodeFreeQInfo(pQInfo, true);
@@ -423,6 +442,11 @@ void vnodeFreeQInfo(void *param, bool decQueryRef) {
   pQInfo->killed = 1;
   TSDB_WAIT_TO_SAFE_DROP_QINFO(pQInfo);
 
+  // the result may be still sent in place by the retrieve msg
+  while (atomic_load_8(&pQInfo->inSend)) {
+    taosMsleep(1);
+  }
+
   SMeterObj *pObj = pQInfo->pObj;
   dTrace("QInfo:%p start to free SQInfo", pQInfo);
 
@@ -452,6 +476,7 @@ void vnodeFreeQInfo(void *param, bool decQueryRef) {
   }
 
   sem_destroy(&(pQInfo->dataReady));
+  vnodeFreeQueryUnits(pQInfo);
   vnodeQueryFreeQInfoEx(pQInfo);
 
   for (int32_t i = 0; i < pQuery->numOfFilterCols; ++i) {
@@ -691,24 +716,15 @@ _error:
   return NULL;
 }
 
-/*
- * query on multi-meters
- */
-void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExpr, SSqlFunctionExpr *pSqlExprs,
-                              SQueryMeterMsg *pQueryMsg, int32_t *code) {
-  SQInfo *pQInfo;
-  SQuery *pQuery;
-
-  assert(QUERY_IS_STABLE_QUERY(pQueryMsg->queryType) && pQueryMsg->numOfCols > 0 && pQueryMsg->pSidExtInfo != 0 &&
-         pQueryMsg->numOfSids >= 1);
-
-  pQInfo = vnodeAllocateQInfoEx(pQueryMsg, pGroupbyExpr, pSqlExprs, *pMetersObj);
+static SQInfo *vnodeAllocateMultiMeterQInfo(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExpr,
+                                            SSqlFunctionExpr *pSqlExprs, SQueryMeterMsg *pQueryMsg, int32_t *code) {
+  SQInfo *pQInfo = vnodeAllocateQInfoEx(pQueryMsg, pGroupbyExpr, pSqlExprs, *pMetersObj);
   if (pQInfo == NULL) {
     *code = TSDB_CODE_SERV_OUT_OF_MEMORY;
-    goto _error;
+    return NULL;
   }
 
-  pQuery = &(pQInfo->query);
+  SQuery *pQuery = &(pQInfo->query);
   dTrace("qmsg:%p create QInfo:%p, QInfo created", pQueryMsg, pQInfo);
 
   pQuery->skey = pQueryMsg->skey;
@@ -724,8 +740,6 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
     goto _error;
   }
 
-  SSchedMsg schedMsg = {0};
-
   SMeterQuerySupportObj *pSupporter = (SMeterQuerySupportObj *)calloc(1, sizeof(SMeterQuerySupportObj));
   pSupporter->numOfMeters = pQueryMsg->numOfSids;
 
@@ -768,6 +782,153 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
   }
 
   pQInfo->pMeterQuerySupporter = pSupporter;
+  return pQInfo;
+
+_error:
+  vnodeFreeQInfo(pQInfo, false);
+  return NULL;
+}
+
+static bool isMergeableFunction(int32_t functionId) {
+  switch (functionId) {
+    case TSDB_FUNC_COUNT:
+    case TSDB_FUNC_SUM:
+    case TSDB_FUNC_AVG:
+    case TSDB_FUNC_MIN:
+    case TSDB_FUNC_MAX:
+    case TSDB_FUNC_SPREAD:
+    case TSDB_FUNC_FIRST_DST:
+    case TSDB_FUNC_LAST_DST:
+    case TSDB_FUNC_TAG:
+    case TSDB_FUNC_TAG_DUMMY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*
+ * Only the super table query that generates fixed number of rows for each group, which consists of
+ * functions whose partial results can be merged at vnode, is split into units.
+ */
+static int32_t vnodeGetNumOfQueryUnits(SQInfo *pQInfo) {
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+
+  if (tsQueryParallelism <= 1 || pSupporter->runtimeEnv.pTSBuf != NULL || pQuery->nAggTimeInterval > 0 ||
+      !isFixedOutputQuery(pQuery) || isPointInterpoQuery(pQuery) || isGroupbyNormalCol(pQuery->pGroupbyExpr)) {
+    return 1;
+  }
+
+  for (int32_t i = 0; i < pQuery->numOfOutputCols; ++i) {
+    if (!isMergeableFunction(pQuery->pSelectExpr[i].pBase.functionId)) {
+      return 1;
+    }
+  }
+
+  int32_t numOfUnits = pSupporter->pSidSet->numOfSids / TSDB_MIN_METERS_PER_QUERY_UNIT;
+  return MAX(1, MIN(numOfUnits, tsQueryParallelism));
+}
+
+/*
+ * split the meters of a super table query into units, each of which has its own runtime environment and
+ * scans a disjoint range of meters. If failed, the query is executed by one query thread.
+ */
+static void vnodeCreateQueryUnits(SQInfo *pQInfo, SMeterObj **pMetersObj, SQueryMeterMsg *pQueryMsg) {
+  int32_t numOfUnits = vnodeGetNumOfQueryUnits(pQInfo);
+  if (numOfUnits <= 1) {
+    return;
+  }
+
+  SQuery *               pQuery = &pQInfo->query;
+  SMeterQuerySupportObj *pSupporter = pQInfo->pMeterQuerySupporter;
+
+  SQueryParallelInfo *pParallelInfo = calloc(1, sizeof(SQueryParallelInfo));
+  if (pParallelInfo == NULL) {
+    return;
+  }
+
+  pParallelInfo->pUnits = calloc(numOfUnits, POINTER_BYTES);
+  if (pParallelInfo->pUnits == NULL) {
+    free(pParallelInfo);
+    return;
+  }
+
+  pthread_mutex_init(&pParallelInfo->mutex, NULL);
+  pthread_cond_init(&pParallelInfo->cond, NULL);
+
+  pParallelInfo->numOfUnits = numOfUnits;
+  pParallelInfo->refCount = 1;
+  pParallelInfo->pUnits[0] = pQInfo;
+  pSupporter->pParallelInfo = pParallelInfo;
+
+  int32_t numOfSids = pSupporter->pSidSet->numOfSids;
+  int32_t numOfCreated = 1;
+
+  for (int32_t i = 1; i < numOfUnits; ++i) {
+    SSqlFunctionExpr *pExprs = malloc(sizeof(SSqlFunctionExpr) * pQuery->numOfOutputCols);
+    SSqlGroupbyExpr * pGroupbyExpr = NULL;
+    if (pQuery->pGroupbyExpr != NULL) {
+      pGroupbyExpr = malloc(sizeof(SSqlGroupbyExpr));
+    }
+
+    if (pExprs == NULL || (pQuery->pGroupbyExpr != NULL && pGroupbyExpr == NULL)) {
+      tfree(pExprs);
+      tfree(pGroupbyExpr);
+      break;
+    }
+
+    memcpy(pExprs, pQuery->pSelectExpr, sizeof(SSqlFunctionExpr) * pQuery->numOfOutputCols);
+    if (pGroupbyExpr != NULL) {
+      memcpy(pGroupbyExpr, pQuery->pGroupbyExpr, sizeof(SSqlGroupbyExpr));
+    }
+
+    int32_t code = TSDB_CODE_SUCCESS;
+    SQInfo *pUnit = vnodeAllocateMultiMeterQInfo(pMetersObj, pGroupbyExpr, pExprs, pQueryMsg, &code);
+    if (pUnit == NULL) {
+      break;
+    }
+
+    pUnit->pParent = pQInfo;
+    pParallelInfo->pUnits[i] = pUnit;
+    if (vnodeMultiMeterQueryPrepare(pUnit, &pUnit->query, NULL) != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    pUnit->pMeterQuerySupporter->meterStartIdx = (int32_t)((int64_t)numOfSids * i / numOfUnits);
+    pUnit->pMeterQuerySupporter->meterEndIdx = (int32_t)((int64_t)numOfSids * (i + 1) / numOfUnits);
+    numOfCreated += 1;
+  }
+
+  if (numOfCreated < numOfUnits) {
+    dError("QInfo:%p failed to create %d query units, query by one thread", pQInfo, numOfUnits);
+    vnodeFreeQueryUnits(pQInfo);
+    return;
+  }
+
+  pSupporter->meterEndIdx = numOfSids / numOfUnits;
+  dTrace("QInfo:%p %d meters are split into %d query units", pQInfo, numOfSids, numOfUnits);
+}
+
+/*
+ * query on multi-meters
+ */
+void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyExpr, SSqlFunctionExpr *pSqlExprs,
+                              SQueryMeterMsg *pQueryMsg, int32_t *code) {
+  SQInfo *pQInfo;
+  SQuery *pQuery;
+
+  assert(QUERY_IS_STABLE_QUERY(pQueryMsg->queryType) && pQueryMsg->numOfCols > 0 && pQueryMsg->pSidExtInfo != 0 &&
+         pQueryMsg->numOfSids >= 1);
+
+  pQInfo = vnodeAllocateMultiMeterQInfo(pMetersObj, pGroupbyExpr, pSqlExprs, pQueryMsg, code);
+  if (pQInfo == NULL) {
+    return NULL;
+  }
+
+  pQuery = &(pQInfo->query);
+
+  SSchedMsg schedMsg = {0};
 
   STSBuf *pTSBuf = NULL;
   if (pQueryMsg->tsLen > 0) {
@@ -785,6 +946,8 @@ void *vnodeQueryOnMultiMeters(SMeterObj **pMetersObj, SSqlGroupbyExpr *pGroupbyE
     return pQInfo;
   }
 
+  vnodeCreateQueryUnits(pQInfo, pMetersObj, pQueryMsg);
+
   pQInfo->signature = TSDB_QINFO_QUERY_FLAG;
 
   schedMsg.msg = NULL;
@@ -848,13 +1011,25 @@ int vnodeRetrieveQueryInfo(void *handle, int *numOfRows, int *rowSize, int16_t *
 }
 
 // vnodeRetrieveQueryInfo must be called first
-int vnodeSaveQueryResult(void *handle, char *data, int32_t *size) {
+int vnodeSaveQueryResult(void *handle, char *data, int32_t *size, int16_t *compress) {
   SQInfo *pQInfo = (SQInfo *)handle;
 
   // the remained number of retrieved rows, not the interpolated result
   int numOfRows = pQInfo->pointsRead - pQInfo->pointsReturned;
 
-  int32_t numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows, size);
+  int32_t numOfFinal = vnodeCopyQueryResultToMsg(pQInfo, data, numOfRows, size, compress);
+  vnodeAdvanceQueryResult(pQInfo, numOfFinal);
+
+  return numOfFinal;
+}
+
+/*
+ * the result in output buffer is returned, so the query is scheduled to continue and may overwrite
+ * the output buffer
+ */
+void vnodeAdvanceQueryResult(void *handle, int32_t numOfFinal) {
+  SQInfo *pQInfo = (SQInfo *)handle;
+
   pQInfo->pointsReturned += numOfFinal;
 
   dTrace("QInfo:%p %d are returned, totalReturned:%d totalRead:%d", pQInfo, numOfFinal, pQInfo->pointsReturned,
@@ -897,8 +1072,31 @@ int vnodeSaveQueryResult(void *handle, char *data, int32_t *size) {
       taosScheduleTask(queryQhandle, &schedMsg);
     }
   }
+}
 
-  return numOfFinal;
+/*
+ * the output buffer is pinned while it is sent in place, and vnodeFreeQInfo waits until it is unpinned.
+ * The flag is set with the query flag held, so vnodeFreeQInfo either fails to drop the QInfo before it
+ * is set, or finds it set. Return false if the QInfo is being freed.
+ */
+bool vnodePinQueryResult(void *handle) {
+  SQInfo *pQInfo = (SQInfo *)handle;
+
+  uint64_t oldSignature = TSDB_QINFO_SET_QUERY_FLAG(pQInfo);
+  if (oldSignature == 0 || oldSignature != (uint64_t)pQInfo) {
+    dTrace("%p freed or killed, old sig:%p failed to pin result", pQInfo, oldSignature);
+    return false;
+  }
+
+  atomic_store_8(&pQInfo->inSend, 1);
+  TSDB_QINFO_RESET_SIG(pQInfo);
+
+  return true;
+}
+
+void vnodeUnpinQueryResult(void *handle) {
+  SQInfo *pQInfo = (SQInfo *)handle;
+  atomic_store_8(&pQInfo->inSend, 0);
 }
 
 static int32_t validateQueryMeterMsg(SQueryMeterMsg *pQueryMsg) {
@@ -35,6 +35,9 @@ extern int tsMaxQueues;
 void *      pShellServer = NULL;
 SShellObj **shellList = NULL;
 
+// guards thandle and generation of the shell objects, the commit log sync thread checks them before sending rsp
+static pthread_mutex_t vnodeShellMutex = PTHREAD_MUTEX_INITIALIZER;
+
 int vnodeProcessRetrieveRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj);
@@ -42,6 +45,10 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj);
 int vnodeSelectReqNum = 0;
 int vnodeInsertReqNum = 0;
 
+// size of retrieved results before compression, and bytes saved by compression
+int64_t vnodeRetrieveCompressedBytes = 0;
+int64_t vnodeRetrieveSavedBytes = 0;
+
 void *vnodeProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
   int        sid, vnode;
   SShellObj *pObj = (SShellObj *)ahandle;
@@ -52,7 +59,10 @@ void *vnodeProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
 
   if (msg == NULL) {
     if (pObj) {
+      pthread_mutex_lock(&vnodeShellMutex);
       pObj->thandle = NULL;
+      pObj->generation++;
+      pthread_mutex_unlock(&vnodeShellMutex);
       dTrace("QInfo:%p %s free qhandle", pObj->qhandle, __FUNCTION__);
       vnodeFreeQInfoInQueue(pObj->qhandle);
       pObj->qhandle = NULL;
@@ -68,7 +78,10 @@ void *vnodeProcessMsgFromShell(char *msg, void *ahandle, void *thandle) {
   if (pObj == NULL) {
     if (shellList[vnode]) {
       pObj = shellList[vnode] + sid;
+      pthread_mutex_lock(&vnodeShellMutex);
       pObj->thandle = thandle;
+      pObj->generation++;
+      pthread_mutex_unlock(&vnodeShellMutex);
       pObj->sid = sid;
       pObj->vnode = vnode;
       pObj->ip = peerIp;
@@ -258,6 +271,24 @@ int vnodeSendShellSubmitRspMsg(SShellObj *pObj, int code, int numOfPoints) {
   return msgLen;
 }
 
+/*
+ * the submit rsp is sent only if the shell object still serves the connection the submit came from, since the
+ * object is reused by a new connection once the old one is gone. It returns -1 if the connection is gone
+ */
+int vnodeSendShellSubmitRspIfConnected(SShellObj *pObj, void *thandle, uint32_t generation, int code,
+                                       int numOfPoints) {
+  int ret = -1;
+
+  pthread_mutex_lock(&vnodeShellMutex);
+  if (pObj->thandle == thandle && pObj->generation == generation) {
+    vnodeSendShellSubmitRspMsg(pObj, code, numOfPoints);
+    ret = 0;
+  }
+  pthread_mutex_unlock(&vnodeShellMutex);
+
+  return ret;
+}
+
 int vnodeProcessQueryRequest(char *pMsg, int msgLen, SShellObj *pObj) {
   int                ret, code = 0;
   SQueryMeterMsg *   pQueryMsg;
@@ -391,6 +422,9 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   char *pStart;
 
+  struct iovec *pIov = NULL;
+  int32_t       numOfIov = 0;
+
   int code = 0;
   pRetrieve = (SRetrieveMeterMsg *)pMsg;
   pRetrieve->free = htons(pRetrieve->free);
@@ -417,10 +451,24 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   if (code == TSDB_CODE_SUCCESS) {
     size = vnodeGetResultSize((void *)(pRetrieve->qhandle), &numOfRows);
+
+    // the result columns are sent in place, and appended to the msg only if it can not be written directly
+    if (numOfRows > 0) {
+      numOfIov = vnodeGetQueryResultIov((void *)(pRetrieve->qhandle), numOfRows, &pIov);
+    }
+
+    // the output buffer is pinned until it is sent, since the QInfo may be freed by another thread
+    if (numOfIov > 0 && !vnodePinQueryResult((void *)(pRetrieve->qhandle))) {
+      tfree(pIov);
+      numOfIov = 0;
+      numOfRows = 0;
+      code = TSDB_CODE_QUERY_CANCELLED;
+    }
   }
 
-  pStart = taosBuildRspMsgWithSize(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, size + 100);
+  pStart = taosBuildRspMsgWithSize(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, (numOfIov > 0 ? 0 : size) + 100);
   if (pStart == NULL) {
+    if (numOfIov > 0) vnodeUnpinQueryResult((void *)(pRetrieve->qhandle));
     taosSendSimpleRsp(pObj->thandle, TSDB_MSG_TYPE_RETRIEVE_RSP, TSDB_CODE_SERV_OUT_OF_MEMORY);
     goto _exit;
   }
@@ -433,6 +481,7 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
   pRsp = (SRetrieveMeterRsp *)pMsg;
   pRsp->numOfRows = htonl(numOfRows);
   pRsp->precision = htons(timePrec);
+  pRsp->compress = htons(TSDB_RSP_COMPRESS_NONE);
 
   if (code == TSDB_CODE_SUCCESS) {
     pRsp->offset = htobe64(vnodeGetOffsetVal(pRetrieve->qhandle));
@@ -444,12 +493,13 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
 
   pMsg = pRsp->data;
 
-  if (numOfRows > 0 && code == TSDB_CODE_SUCCESS) {
-    int32_t oldSize = size;
-    vnodeSaveQueryResult((void *)(pRetrieve->qhandle), pRsp->data, &size);
-    if (oldSize > size) {
-      pRsp->compress = htons(1); // denote that the response msg is compressed
-    }
+  if (numOfIov > 0) {
+    size = 0;
+  } else if (numOfRows > 0 && code == TSDB_CODE_SUCCESS) {
+    // an old client can only decompress the results compressed by LZ4 as a whole
+    int16_t compress = (pRetrieve->free & TSDB_QUERY_TYPE_COMP_COLUMN) ? TSDB_RSP_COMPRESS_COLUMN : TSDB_RSP_COMPRESS_LZ4;
+    vnodeSaveQueryResult((void *)(pRetrieve->qhandle), pRsp->data, &size, &compress);
+    pRsp->compress = htons(compress);
   }
 
   pMsg += size;
@@ -461,9 +511,18 @@ void vnodeExecuteRetrieveReq(SSchedMsg *pSched) {
     pObj->qhandle = NULL;
   }
 
-  taosSendMsgToPeer(pObj->thandle, pStart, msgLen);
+  if (numOfIov > 0) {
+    // the next round is scheduled ahead of the next retrieve msg, as what vnodeSaveQueryResult does. It writes
+    // the other output buffer, and the QInfo is kept until the send returns, since it is pinned
+    vnodeAdvanceQueryResult((void *)(pRetrieve->qhandle), numOfRows);
+    taosSendMsgToPeerV(pObj->thandle, pStart, msgLen, pIov, numOfIov);
+    vnodeUnpinQueryResult((void *)(pRetrieve->qhandle));
+  } else {
+    taosSendMsgToPeer(pObj->thandle, pStart, msgLen);
+  }
 
 _exit:
+  free(pIov);
   free(pSched->msg);
 
   return;
@@ -582,7 +641,14 @@ int vnodeProcessShellSubmitRequest(char *pMsg, int msgLen, SShellObj *pObj) {
 
 _submit_over:
   // for import, send the submit response only when return code is not zero
-  if (pSubmit->import == 0 || code != 0) ret = vnodeSendShellSubmitRspMsg(pObj, code, numOfTotalPoints);
+  if (pSubmit->import == 0 || code != 0) {
+    // in sync commit log mode, the rsp is sent only after the commit log is synced to disk
+    if (code == TSDB_CODE_SUCCESS && vnodeList[pSubmit->vnode].logSync) {
+      ret = vnodeSendSubmitRspAfterLogSync(vnodeList + pSubmit->vnode, pObj, code, numOfTotalPoints);
+    } else {
+      ret = vnodeSendShellSubmitRspMsg(pObj, code, numOfTotalPoints);
+    }
+  }
 
   atomic_fetch_add_32(&vnodeInsertReqNum, 1);
   return ret;
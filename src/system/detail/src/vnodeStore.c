@@ -20,6 +20,8 @@
 #include "trpc.h"
 #include "ttime.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
+#include "vnodeCompBlockCache.h"
 #include "vnodeStore.h"
 #include "vnodeUtil.h"
 #include "tstatus.h"
@@ -31,8 +33,11 @@ int        tsMaxVnode = -1;
 int        tsOpenVnodes = 0;
 SVnodeObj *vnodeList = NULL;
 
+SVnodeStartupInfo vnodeStartupInfo = {0};
+
 static int vnodeInitStoreVnode(int vnode) {
   SVnodeObj *pVnode = vnodeList + vnode;
+  int64_t    st = taosGetTimestampUs();
 
   pVnode->vnode = vnode;
   vnodeOpenMetersVnode(vnode);
@@ -40,31 +45,98 @@ static int vnodeInitStoreVnode(int vnode) {
     return TSDB_CODE_SUCCESS;
   }
 
+  // the commit thread may be started during restoring data from the commit log, it locks vmutex
+  pthread_mutex_init(&(pVnode->vmutex), NULL);
   pVnode->firstKey = taosGetTimestamp(pVnode->cfg.precision);
+  int64_t meterEt = taosGetTimestampUs();
 
   pVnode->pCachePool = vnodeOpenCachePool(vnode);
   if (pVnode->pCachePool == NULL) {
     dError("vid:%d, cache pool init failed.", pVnode->vnode);
     return -1;
   }
+  int64_t cacheEt = taosGetTimestampUs();
 
   if (vnodeInitFile(vnode) < 0) {
     dError("vid:%d, files init failed.", pVnode->vnode);
     return -1;
   }
+  int64_t fileEt = taosGetTimestampUs();
 
   if (vnodeInitCommit(vnode) < 0) {
     dError("vid:%d, commit init failed.", pVnode->vnode);
     return -1;
   }
+  int64_t logEt = taosGetTimestampUs();
 
-  pthread_mutex_init(&(pVnode->vmutex), NULL);
-  dTrace("vid:%d, storage initialized, version:%ld fileId:%d numOfFiles:%d", vnode, pVnode->version, pVnode->fileId,
-         pVnode->numOfFiles);
+  atomic_add_fetch_32(&vnodeStartupInfo.numOfVnodes, 1);
+  atomic_add_fetch_64(&vnodeStartupInfo.meterUs, meterEt - st);
+  atomic_add_fetch_64(&vnodeStartupInfo.cacheUs, cacheEt - meterEt);
+  atomic_add_fetch_64(&vnodeStartupInfo.fileUs, fileEt - cacheEt);
+  atomic_add_fetch_64(&vnodeStartupInfo.logUs, logEt - fileEt);
+
+  dTrace("vid:%d, storage initialized, version:%ld fileId:%d numOfFiles:%d, elapsed:%.2f ms, meters:%.2f ms, "
+         "cache:%.2f ms, files:%.2f ms, logs:%.2f ms", vnode, pVnode->version, pVnode->fileId, pVnode->numOfFiles,
+         (logEt - st) / 1000.0, (meterEt - st) / 1000.0, (cacheEt - meterEt) / 1000.0, (fileEt - cacheEt) / 1000.0,
+         (logEt - fileEt) / 1000.0);
 
   return 0;
 }
 
+static void vnodeInitStoreVnodeTask(SSchedMsg *pMsg) {
+  int      vnode = (int)(int64_t)pMsg->ahandle;
+  int32_t *code = (int32_t *)pMsg->msg;
+
+  if (vnodeInitStoreVnode(vnode) < 0) {
+    atomic_store_32(code, -1);
+  }
+
+  tsem_post((tsem_t *)pMsg->thandle);
+}
+
+/*
+ * the vnodes are independent of each other during startup, so they are opened by a bounded pool of threads
+ */
+static int vnodeInitStoreVnodes() {
+  vnodeStartupInfo.numOfThreads = MIN(tsNumOfStartupThreads, TSDB_MAX_VNODES);
+
+  void *qhandle = NULL;
+  if (vnodeStartupInfo.numOfThreads > 1) {
+    qhandle = taosInitScheduler(TSDB_MAX_VNODES, vnodeStartupInfo.numOfThreads, "startup");
+  }
+
+  if (qhandle == NULL) {
+    vnodeStartupInfo.numOfThreads = 1;
+    for (int vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
+      if (vnodeInitStoreVnode(vnode) < 0) return -1;
+    }
+
+    return 0;
+  }
+
+  int32_t code = 0;
+  tsem_t  sem;
+  tsem_init(&sem, 0, 0);
+
+  for (int vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp = vnodeInitStoreVnodeTask;
+    schedMsg.ahandle = (void *)(int64_t)vnode;
+    schedMsg.thandle = &sem;
+    schedMsg.msg = (char *)&code;
+    taosScheduleTask(qhandle, &schedMsg);
+  }
+
+  for (int vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
+    tsem_wait(&sem);
+  }
+
+  taosCleanUpScheduler(qhandle);
+  tsem_destroy(&sem);
+
+  return atomic_load_32(&code);
+}
+
 int vnodeOpenVnode(int vnode) {
   int32_t code = TSDB_CODE_SUCCESS;
 
@@ -270,6 +342,8 @@ int vnodeRemoveVnode(int vnode) {
       }
 
       vnodeRemoveDataFiles(vnode);
+      vnodeBlockCacheRemoveVnode(vnode);
+      vnodeCompBlockCacheRemove(vnode, -1);
     }
 
   } else {
@@ -282,7 +356,6 @@ int vnodeRemoveVnode(int vnode) {
 }
 
 int vnodeInitStore() {
-  int vnode;
   int size;
 
   size = sizeof(SVnodeObj) * TSDB_MAX_VNODES;
@@ -292,12 +365,16 @@ int vnodeInitStore() {
 
   if (vnodeInitInfo() < 0) return -1;
 
-  for (vnode = 0; vnode < TSDB_MAX_VNODES; ++vnode) {
-    if (vnodeInitStoreVnode(vnode) < 0) {
-      // one vnode is failed to recover from commit log, continue for remain
-      return -1;
-    }
-  }
+  int64_t st = taosGetTimestampUs();
+
+  // one vnode is failed to recover from commit log, abort
+  if (vnodeInitStoreVnodes() < 0) return -1;
+
+  vnodeStartupInfo.elapsedUs = taosGetTimestampUs() - st;
+  dPrint("%d vnodes are opened by %d threads, elapsed:%.2f ms, meters:%.2f ms, cache:%.2f ms, files:%.2f ms, "
+         "logs:%.2f ms", vnodeStartupInfo.numOfVnodes, vnodeStartupInfo.numOfThreads,
+         vnodeStartupInfo.elapsedUs / 1000.0, vnodeStartupInfo.meterUs / 1000.0, vnodeStartupInfo.cacheUs / 1000.0,
+         vnodeStartupInfo.fileUs / 1000.0, vnodeStartupInfo.logUs / 1000.0);
 
   return 0;
 }
@@ -19,6 +19,8 @@
 #include "tsdb.h"
 #include "tsocket.h"
 #include "vnode.h"
+#include "vnodeBlockCache.h"
+#include "vnodeCompBlockCache.h"
 #include "vnodeSystem.h"
 
 // internal global, not configurable
@@ -26,21 +28,33 @@ void *   vnodeTmrCtrl;
 void **  rpcQhandle;
 void *   dmQhandle;
 void *   queryQhandle;
+void *   commitQhandle;
 int      tsVnodePeers = TSDB_VNODES_SUPPORT - 1;
 int      tsMaxQueues;
 uint32_t tsRebootTime;
 
 void vnodeCleanUpSystem() {
   vnodeCleanUpVnodes();
+  vnodeCleanUpBlockCache();
+  vnodeCleanUpCompBlockCache();
 }
 
 bool vnodeInitQueryHandle() {
   int numOfThreads = tsRatioOfQueryThreads * tsNumOfCores * tsNumOfThreadsPerCore;
   if (numOfThreads < 1) numOfThreads = 1;
-  queryQhandle = taosInitScheduler(tsNumOfVnodesPerCore * tsNumOfCores * tsSessionsPerVnode, numOfThreads, "query");
+  queryQhandle = taosInitSchedulerWithType(tsNumOfVnodesPerCore * tsNumOfCores * tsSessionsPerVnode, numOfThreads,
+                                           "query", TAOS_SCHED_TYPE_LOCK_FREE);
   return true;
 }
 
+bool vnodeInitCommitHandle() {
+  // data blocks are compressed in the commit thread of each vnode if there is no commit thread pool
+  if (tsNumOfCommitThreads <= 0) return true;
+
+  commitQhandle = taosInitScheduler(TSDB_MAX_VNODES * tsNumOfCommitThreads, tsNumOfCommitThreads, "commit");
+  return commitQhandle != NULL;
+}
+
 bool vnodeInitTmrCtl() {
   vnodeTmrCtrl = taosTmrInit(TSDB_MAX_VNODES * (tsVnodePeers + 10) + tsSessionsPerVnode + 1000, 200, 60000, "DND-vnode");
   if (vnodeTmrCtrl == NULL) {
@@ -57,6 +71,11 @@ int vnodeInitSystem() {
     return -1;
   }
 
+  if (!vnodeInitCommitHandle()) {
+    dError("failed to init commit qhandle, exit");
+    return -1;
+  }
+
   if (!vnodeInitTmrCtl()) {
     dError("failed to init timer, exit");
     return -1;
@@ -67,6 +86,16 @@ int vnodeInitSystem() {
     return -1;
   }
 
+  if (vnodeInitBlockCache((int64_t)tsBlockCacheSize * 1024 * 1024) < 0) {
+    dError("failed to init block cache");
+    return -1;
+  }
+
+  if (vnodeInitCompBlockCache((int64_t)tsCompBlockCacheSize * 1024 * 1024) < 0) {
+    dError("failed to init comp block cache");
+    return -1;
+  }
+
   int numOfThreads = (1.0 - tsRatioOfQueryThreads) * tsNumOfCores * tsNumOfThreadsPerCore / 2.0;
   if (numOfThreads < 1) numOfThreads = 1;
   if (vnodeInitPeer(numOfThreads) < 0) {
@@ -437,32 +437,33 @@ int32_t vnodeCreateFilterInfo(void* pQInfo, SQuery* pQuery) {
           return TSDB_CODE_INVALID_QUERY_MSG;
         }
 
+        __filter_block_func_t *rangeBlockFilterArray = vnodeGetRangeBlockFilterFuncArray(type);
+        __filter_block_func_t *blockFilterArray = vnodeGetValueBlockFilterFuncArray(type);
+
         if ((lower == TSDB_RELATION_LARGE_EQUAL || lower == TSDB_RELATION_LARGE) &&
             (upper == TSDB_RELATION_LESS_EQUAL || upper == TSDB_RELATION_LESS)) {
+          int32_t index = 0;
           if (lower == TSDB_RELATION_LARGE_EQUAL) {
-            if (upper == TSDB_RELATION_LESS_EQUAL) {
-              pSingleColFilter->fp = rangeFilterArray[4];
-            } else {
-              pSingleColFilter->fp = rangeFilterArray[2];
-            }
+            index = (upper == TSDB_RELATION_LESS_EQUAL) ? 4 : 2;
           } else {
-            if (upper == TSDB_RELATION_LESS_EQUAL) {
-              pSingleColFilter->fp = rangeFilterArray[3];
-            } else {
-              pSingleColFilter->fp = rangeFilterArray[1];
-            }
+            index = (upper == TSDB_RELATION_LESS_EQUAL) ? 3 : 1;
           }
+
+          pSingleColFilter->fp = rangeFilterArray[index];
+          pSingleColFilter->blockFp = (rangeBlockFilterArray != NULL) ? rangeBlockFilterArray[index] : NULL;
         } else {  // set callback filter function
+          int32_t index = upper;
           if (lower != TSDB_RELATION_INVALID) {
-            pSingleColFilter->fp = filterArray[lower];
+            index = lower;
 
             if (upper != TSDB_RELATION_INVALID) {
               dError("pQInfo:%p failed to get filter function, invalid filter condition", pQInfo, type);
               return TSDB_CODE_INVALID_QUERY_MSG;
             }
-          } else {
-            pSingleColFilter->fp = filterArray[upper];
           }
+
+          pSingleColFilter->fp = filterArray[index];
+          pSingleColFilter->blockFp = (blockFilterArray != NULL) ? blockFilterArray[index] : NULL;
         }
         assert (pSingleColFilter->fp != NULL);
         pSingleColFilter->bytes = bytes;
@@ -502,6 +503,32 @@ bool vnodeDoFilterData(SQuery* pQuery, int32_t elemPos) {
   return true;
 }
 
+int32_t vnodeFilterDataBlock(SQuery* pQuery, int32_t start, int32_t numOfRows, uint64_t* bitmap, uint64_t* colBitmap) {
+  int32_t numOfWords = FILTER_BITMAP_WORDS(numOfRows);
+
+  for (int32_t k = 0; k < pQuery->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQuery->pFilterInfo[k];
+    char* pData = pFilterInfo->pData + pFilterInfo->info.data.bytes * start;
+
+    if (k == 0) {
+      vnodeFilterColumnBlock(pFilterInfo, pData, numOfRows, bitmap);
+      continue;
+    }
+
+    vnodeFilterColumnBlock(pFilterInfo, pData, numOfRows, colBitmap);
+    for (int32_t i = 0; i < numOfWords; ++i) {
+      bitmap[i] &= colBitmap[i];
+    }
+  }
+
+  int32_t numOfQualified = 0;
+  for (int32_t i = 0; i < numOfWords; ++i) {
+    numOfQualified += __builtin_popcountll(bitmap[i]);
+  }
+
+  return numOfQualified;
+}
+
 bool vnodeFilterData(SQuery* pQuery, int32_t* numOfActualRead, int32_t index) {
   (*numOfActualRead)++;
   if (!vnodeDoFilterData(pQuery, index)) {
@@ -14,6 +14,7 @@
  */
 
 #include "os.h"
+#include "trcu.h"
 
 typedef struct _str_node_t {
   uint64_t             key;
@@ -22,14 +23,24 @@ typedef struct _str_node_t {
   char                data[];
 } IHashNode;
 
+/*
+ * Lookups do not lock, they walk the buckets in a read section of pObj->rcu. Writers of bucket i are serialized
+ * by the striped lock[i % IHASH_LOCK_STRIPES], they link or unlink a node with a single pointer store, and a
+ * deleted node is freed once the lookups that may still see it are over.
+ */
+#define IHASH_LOCK_STRIPES 16
+
 typedef struct {
   IHashNode **hashList;
   int32_t     maxSessions;
   int32_t     dataSize;
   int32_t (*hashFp)(void *, uint64_t key);
-  pthread_mutex_t mutex;
+  void *          rcu;
+  pthread_mutex_t lock[IHASH_LOCK_STRIPES];
 } IHashObj;
 
+#define IHASH_LOCK(pObj, hash) (&(pObj)->lock[(hash) % IHASH_LOCK_STRIPES])
+
 int32_t taosHashInt(void *handle, uint64_t key) {
   IHashObj *pObj = (IHashObj *)handle;
   int32_t   hash = key % pObj->maxSessions;
@@ -50,7 +61,7 @@ char *taosAddIntHash(void *handle, uint64_t key, char *pData) {
   if (pNode == NULL)
     return NULL;
   
-  pthread_mutex_lock(&pObj->mutex);
+  pthread_mutex_lock(IHASH_LOCK(pObj, hash));
 
   pNode->key = key;
   if (pData != NULL) {
@@ -60,9 +71,9 @@ char *taosAddIntHash(void *handle, uint64_t key, char *pData) {
   pNode->next = pObj->hashList[hash];
 
   if (pObj->hashList[hash] != 0) (pObj->hashList[hash])->prev = pNode;
-  pObj->hashList[hash] = pNode;
+  atomic_store_ptr(&pObj->hashList[hash], pNode);
 
-  pthread_mutex_unlock(&pObj->mutex);
+  pthread_mutex_unlock(IHASH_LOCK(pObj, hash));
 
   return (char *)pNode->data;
 }
@@ -77,7 +88,7 @@ void taosDeleteIntHash(void *handle, uint64_t key) {
 
   hash = (*(pObj->hashFp))(pObj, key);
 
-  pthread_mutex_lock(&pObj->mutex);
+  pthread_mutex_lock(IHASH_LOCK(pObj, hash));
 
   pNode = pObj->hashList[hash];
   while (pNode) {
@@ -87,20 +98,21 @@ void taosDeleteIntHash(void *handle, uint64_t key) {
   }
 
   if (pNode) {
+    // the next pointer of the node is kept, lookups on this node still move forward
     if (pNode->prev) {
-      pNode->prev->next = pNode->next;
+      atomic_store_ptr(&pNode->prev->next, pNode->next);
     } else {
-      pObj->hashList[hash] = pNode->next;
+      atomic_store_ptr(&pObj->hashList[hash], pNode->next);
     }
 
     if (pNode->next) {
       pNode->next->prev = pNode->prev;
     }
-
-    free(pNode);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  pthread_mutex_unlock(IHASH_LOCK(pObj, hash));
+
+  if (pNode) taosRcuRetire(pObj->rcu, pNode);
 }
 
 char *taosGetIntHashData(void *handle, uint64_t key) {
@@ -113,19 +125,19 @@ char *taosGetIntHashData(void *handle, uint64_t key) {
 
   hash = (*pObj->hashFp)(pObj, key);
 
-  pthread_mutex_lock(&pObj->mutex);
+  int32_t token = taosRcuReadLock(pObj->rcu);
 
-  pNode = pObj->hashList[hash];
+  pNode = atomic_load_ptr(&pObj->hashList[hash]);
 
   while (pNode) {
     if (pNode->key == key) {
       break;
     }
 
-    pNode = pNode->next;
+    pNode = atomic_load_ptr(&pNode->next);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  taosRcuReadUnlock(pObj->rcu, token);
 
   if (pNode) return pNode->data;
 
@@ -152,7 +164,16 @@ void *taosInitIntHash(int32_t maxSessions, int32_t dataSize, int32_t (*fp)(void
   }
   memset(pObj->hashList, 0, sizeof(IHashNode *) * (size_t)maxSessions);
 
-  pthread_mutex_init(&pObj->mutex, NULL);
+  pObj->rcu = taosInitRcu(NULL, NULL);
+  if (pObj->rcu == NULL) {
+    free(pObj->hashList);
+    free(pObj);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < IHASH_LOCK_STRIPES; ++i) {
+    pthread_mutex_init(&pObj->lock[i], NULL);
+  }
 
   return pObj;
 }
@@ -164,8 +185,6 @@ void taosCleanUpIntHash(void *handle) {
   pObj = (IHashObj *)handle;
   if (pObj == NULL || pObj->maxSessions <= 0) return;
 
-  pthread_mutex_lock(&pObj->mutex);
-
   if (pObj->hashList) {
     for (int32_t i = 0; i < pObj->maxSessions; ++i) {
       pNode = pObj->hashList[i];
@@ -179,9 +198,11 @@ void taosCleanUpIntHash(void *handle) {
     free(pObj->hashList);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  taosCleanUpRcu(pObj->rcu);
 
-  pthread_mutex_destroy(&pObj->mutex);
+  for (int32_t i = 0; i < IHASH_LOCK_STRIPES; ++i) {
+    pthread_mutex_destroy(&pObj->lock[i]);
+  }
 
   memset(pObj, 0, sizeof(IHashObj));
   free(pObj);
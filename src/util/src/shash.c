@@ -19,8 +19,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "os.h"
 #include "shash.h"
 #include "tlog.h"
+#include "trcu.h"
 
 typedef struct _str_node_t {
   char *              string;
@@ -29,14 +31,22 @@ typedef struct _str_node_t {
   char                data[];
 } SHashNode;
 
+/*
+ * lookups are lock free and writers are serialized by striped locks, the same as ihash.c
+ */
+#define SHASH_LOCK_STRIPES 16
+
 typedef struct {
   SHashNode **hashList;
   uint32_t    maxSessions;
   uint32_t    dataSize;
   uint32_t (*hashFp)(void *, char *string);
-  pthread_mutex_t mutex;
+  void *          rcu;
+  pthread_mutex_t lock[SHASH_LOCK_STRIPES];
 } SHashObj;
 
+#define SHASH_LOCK(pObj, hash) (&(pObj)->lock[(hash) % SHASH_LOCK_STRIPES])
+
 uint32_t taosHashString(void *handle, char *string) {
   SHashObj *pObj = (SHashObj *)handle;
   uint32_t  hash = 0, hashv;
@@ -82,7 +92,7 @@ void *taosAddStrHashWithSize(void *handle, char *string, char *pData, int dataSi
 
   hash = (*pObj->hashFp)(pObj, string);
 
-  pthread_mutex_lock(&pObj->mutex);
+  pthread_mutex_lock(SHASH_LOCK(pObj, hash));
 
   pNode = (SHashNode *)malloc(sizeof(SHashNode) + (size_t)dataSize + strlen(string) + 1);
   memcpy(pNode->data, pData, (size_t)dataSize);
@@ -92,9 +102,9 @@ void *taosAddStrHashWithSize(void *handle, char *string, char *pData, int dataSi
   strcpy(pNode->string, string);
 
   if (pObj->hashList[hash] != 0) (pObj->hashList[hash])->prev = pNode;
-  pObj->hashList[hash] = pNode;
+  atomic_store_ptr(&pObj->hashList[hash], pNode);
 
-  pthread_mutex_unlock(&pObj->mutex);
+  pthread_mutex_unlock(SHASH_LOCK(pObj, hash));
 
   pTrace("hash:%d:%s is added", hash, string);
 
@@ -120,13 +130,12 @@ void taosDeleteStrHashNode(void *handle, char *string, void *pDeleteNode) {
 
   hash = (*(pObj->hashFp))(pObj, string);
 
-  pthread_mutex_lock(&pObj->mutex);
+  pthread_mutex_lock(SHASH_LOCK(pObj, hash));
 
   pNode = pObj->hashList[hash];
 
   while (pNode) {
-    if (strcmp(pNode->string, string) != 0) continue;
-    if (pNode->data == pDeleteNode) {
+    if (pNode->data == pDeleteNode && strcmp(pNode->string, string) == 0) {
       find = true;
       break;
     }
@@ -136,9 +145,9 @@ void taosDeleteStrHashNode(void *handle, char *string, void *pDeleteNode) {
 
   if (find) {
     if (pNode->prev) {
-      pNode->prev->next = pNode->next;
+      atomic_store_ptr(&pNode->prev->next, pNode->next);
     } else {
-      pObj->hashList[hash] = pNode->next;
+      atomic_store_ptr(&pObj->hashList[hash], pNode->next);
     }
 
     if (pNode->next) {
@@ -146,11 +155,11 @@ void taosDeleteStrHashNode(void *handle, char *string, void *pDeleteNode) {
     }
 
     pTrace("hash:%d:%s:%p is removed", hash, string, pNode);
-
-    free(pNode);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  pthread_mutex_unlock(SHASH_LOCK(pObj, hash));
+
+  if (find) taosRcuRetire(pObj->rcu, pNode);
 }
 
 void taosDeleteStrHash(void *handle, char *string) {
@@ -164,7 +173,7 @@ void taosDeleteStrHash(void *handle, char *string) {
 
   hash = (*(pObj->hashFp))(pObj, string);
 
-  pthread_mutex_lock(&pObj->mutex);
+  pthread_mutex_lock(SHASH_LOCK(pObj, hash));
 
   pNode = pObj->hashList[hash];
   while (pNode) {
@@ -175,9 +184,9 @@ void taosDeleteStrHash(void *handle, char *string) {
 
   if (pNode) {
     if (pNode->prev) {
-      pNode->prev->next = pNode->next;
+      atomic_store_ptr(&pNode->prev->next, pNode->next);
     } else {
-      pObj->hashList[hash] = pNode->next;
+      atomic_store_ptr(&pObj->hashList[hash], pNode->next);
     }
 
     if (pNode->next) {
@@ -185,11 +194,11 @@ void taosDeleteStrHash(void *handle, char *string) {
     }
 
     pTrace("hash:%d:%s:%p is removed", hash, string, pNode);
-
-    free(pNode);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  pthread_mutex_unlock(SHASH_LOCK(pObj, hash));
+
+  if (pNode) taosRcuRetire(pObj->rcu, pNode);
 }
 
 void *taosGetStrHashData(void *handle, char *string) {
@@ -203,9 +212,9 @@ void *taosGetStrHashData(void *handle, char *string) {
 
   hash = (*pObj->hashFp)(pObj, string);
 
-  pthread_mutex_lock(&pObj->mutex);
+  int32_t token = taosRcuReadLock(pObj->rcu);
 
-  pNode = pObj->hashList[hash];
+  pNode = atomic_load_ptr(&pObj->hashList[hash]);
 
   while (pNode) {
     if (strcmp(pNode->string, string) == 0) {
@@ -213,10 +222,10 @@ void *taosGetStrHashData(void *handle, char *string) {
       break;
     }
 
-    pNode = pNode->next;
+    pNode = atomic_load_ptr(&pNode->next);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  taosRcuReadUnlock(pObj->rcu, token);
 
   if (pNode) return pNode->data;
 
@@ -243,7 +252,16 @@ void *taosInitStrHash(uint32_t maxSessions, uint32_t dataSize, uint32_t (*fp)(vo
   }
   memset(pObj->hashList, 0, sizeof(SHashNode *) * (size_t)maxSessions);
 
-  pthread_mutex_init(&pObj->mutex, NULL);
+  pObj->rcu = taosInitRcu(NULL, NULL);
+  if (pObj->rcu == NULL) {
+    free(pObj->hashList);
+    free(pObj);
+    return NULL;
+  }
+
+  for (int i = 0; i < SHASH_LOCK_STRIPES; ++i) {
+    pthread_mutex_init(&pObj->lock[i], NULL);
+  }
 
   return pObj;
 }
@@ -255,8 +273,6 @@ void taosCleanUpStrHashWithFp(void *handle, void (*fp)(char *)) {
   pObj = (SHashObj *)handle;
   if (pObj == NULL || pObj->maxSessions <= 0) return;
 
-  pthread_mutex_lock(&pObj->mutex);
-
   if (pObj->hashList) {
     for (int i = 0; i < pObj->maxSessions; ++i) {
       pNode = pObj->hashList[i];
@@ -271,9 +287,11 @@ void taosCleanUpStrHashWithFp(void *handle, void (*fp)(char *)) {
     free(pObj->hashList);
   }
 
-  pthread_mutex_unlock(&pObj->mutex);
+  taosCleanUpRcu(pObj->rcu);
 
-  pthread_mutex_destroy(&pObj->mutex);
+  for (int i = 0; i < SHASH_LOCK_STRIPES; ++i) {
+    pthread_mutex_destroy(&pObj->lock[i]);
+  }
 
   memset(pObj, 0, sizeof(SHashObj));
   free(pObj);
@@ -289,26 +307,25 @@ char *taosVisitStrHashWithFp(void *handle, int (*fp)(char *)) {
   pObj = (SHashObj *)handle;
   if (pObj == NULL || pObj->maxSessions <= 0) return NULL;
 
-  pthread_mutex_lock(&pObj->mutex);
-
   if (pObj->hashList) {
-    for (int i = 0; i < pObj->maxSessions; ++i) {
-      pNode = pObj->hashList[i];
+    for (int i = 0; i < pObj->maxSessions && pData == NULL; ++i) {
+      int32_t token = taosRcuReadLock(pObj->rcu);
+
+      pNode = atomic_load_ptr(&pObj->hashList[i]);
       while (pNode) {
-        pNext = pNode->next;
+        pNext = atomic_load_ptr(&pNode->next);
         int flag = fp(pNode->data);
         if (flag) {
           pData = pNode->data;
-          goto VisitEnd;
+          break;
         }
 
         pNode = pNext;
       }
+
+      taosRcuReadUnlock(pObj->rcu, token);
     }
   }
 
-VisitEnd:
-
-  pthread_mutex_unlock(&pObj->mutex);
   return pData;
 }
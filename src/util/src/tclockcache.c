@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tclockcache.h"
+#include "tutil.h"
+
+#define CLOCK_CACHE_STRIPES 16
+
+typedef struct SClockCacheNode {
+  struct SClockCacheNode *hnext;       // next node in the same hash bucket
+  struct SClockCacheNode *prev, *next;  // clock ring of the stripe
+  int8_t                  referenced;
+  int32_t                 size;        // size of the payload
+  char                    data[];      // the key, followed by the payload at keyOffset
+} SClockCacheNode;
+
+typedef struct {
+  pthread_mutex_t   mutex;
+  SClockCacheNode **buckets;
+  SClockCacheNode * hand;
+  int64_t           size;
+  int64_t           capacity;
+} SClockCacheStripe;
+
+typedef struct {
+  int32_t           numOfBuckets;
+  int32_t           keySize;
+  int32_t           keyOffset;  // the payload is 8 bytes aligned after the key
+  uint32_t          (*hashFp)(const void *key);
+  bool              (*equalFp)(const void *key1, const void *key2);
+  int32_t           hits;
+  int32_t           misses;
+  int32_t           evictions;
+  SClockCacheStripe stripes[CLOCK_CACHE_STRIPES];
+} SClockCache;
+
+static SClockCacheNode **taosClockCacheBucket(SClockCache *pCache, SClockCacheStripe *pStripe, uint32_t hash) {
+  return &pStripe->buckets[(hash / CLOCK_CACHE_STRIPES) % pCache->numOfBuckets];
+}
+
+static int64_t taosClockCacheNodeSize(SClockCache *pCache, int32_t size) {
+  return sizeof(SClockCacheNode) + pCache->keyOffset + (int64_t)size;
+}
+
+static SClockCacheNode *taosClockCacheFind(SClockCache *pCache, SClockCacheNode **ppBucket, const void *key) {
+  SClockCacheNode *pNode = *ppBucket;
+  while (pNode != NULL && !(*pCache->equalFp)(pNode->data, key)) pNode = pNode->hnext;
+
+  return pNode;
+}
+
+static void taosClockCacheUnlink(SClockCache *pCache, SClockCacheStripe *pStripe, SClockCacheNode *pNode) {
+  SClockCacheNode **ppNode = taosClockCacheBucket(pCache, pStripe, (*pCache->hashFp)(pNode->data));
+  while (*ppNode != pNode) ppNode = &(*ppNode)->hnext;
+  *ppNode = pNode->hnext;
+
+  if (pNode->next == pNode) {
+    pStripe->hand = NULL;
+  } else {
+    pNode->prev->next = pNode->next;
+    pNode->next->prev = pNode->prev;
+    if (pStripe->hand == pNode) pStripe->hand = pNode->next;
+  }
+
+  pStripe->size -= taosClockCacheNodeSize(pCache, pNode->size);
+  free(pNode);
+}
+
+static void taosClockCacheEvict(SClockCache *pCache, SClockCacheStripe *pStripe, int64_t size) {
+  while (pStripe->hand != NULL && pStripe->size + size > pStripe->capacity) {
+    SClockCacheNode *pNode = pStripe->hand;
+    if (pNode->referenced) {
+      pNode->referenced = 0;
+      pStripe->hand = pNode->next;
+    } else {
+      taosClockCacheUnlink(pCache, pStripe, pNode);
+      atomic_add_fetch_32(&pCache->evictions, 1);
+    }
+  }
+}
+
+void *taosInitClockCache(int64_t size, int32_t numOfBuckets, int32_t keySize, uint32_t (*hashFp)(const void *key),
+                         bool (*equalFp)(const void *key1, const void *key2)) {
+  SClockCache *pCache = calloc(1, sizeof(SClockCache));
+  if (pCache == NULL) return NULL;
+
+  pCache->numOfBuckets = numOfBuckets;
+  pCache->keySize = keySize;
+  pCache->keyOffset = (keySize + 7) & ~7;
+  pCache->hashFp = hashFp;
+  pCache->equalFp = equalFp;
+
+  for (int32_t i = 0; i < CLOCK_CACHE_STRIPES; ++i) {
+    SClockCacheStripe *pStripe = &pCache->stripes[i];
+
+    pStripe->buckets = calloc((size_t)numOfBuckets, sizeof(SClockCacheNode *));
+    if (pStripe->buckets == NULL) {
+      for (int32_t j = 0; j < i; ++j) free(pCache->stripes[j].buckets);
+      free(pCache);
+      return NULL;
+    }
+
+    pStripe->capacity = size / CLOCK_CACHE_STRIPES;
+    pthread_mutex_init(&pStripe->mutex, NULL);
+  }
+
+  return pCache;
+}
+
+void taosCleanUpClockCache(void *handle) {
+  SClockCache *pCache = (SClockCache *)handle;
+  if (pCache == NULL) return;
+
+  for (int32_t i = 0; i < CLOCK_CACHE_STRIPES; ++i) {
+    SClockCacheStripe *pStripe = &pCache->stripes[i];
+    while (pStripe->hand != NULL) taosClockCacheUnlink(pCache, pStripe, pStripe->hand);
+    free(pStripe->buckets);
+    pthread_mutex_destroy(&pStripe->mutex);
+  }
+
+  free(pCache);
+}
+
+int32_t taosGetFromClockCache(void *handle, const void *key,
+                              int32_t (*fp)(const void *cachedKey, const char *data, int32_t size, void *param),
+                              void *param) {
+  SClockCache *      pCache = (SClockCache *)handle;
+  uint32_t           hash = (*pCache->hashFp)(key);
+  SClockCacheStripe *pStripe = &pCache->stripes[hash % CLOCK_CACHE_STRIPES];
+  int32_t            code = TAOS_CLOCK_CACHE_MISS;
+
+  pthread_mutex_lock(&pStripe->mutex);
+
+  SClockCacheNode *pNode = taosClockCacheFind(pCache, taosClockCacheBucket(pCache, pStripe, hash), key);
+  if (pNode != NULL) {
+    code = (*fp)(pNode->data, pNode->data + pCache->keyOffset, pNode->size, param);
+    if (code == TAOS_CLOCK_CACHE_HIT) {
+      pNode->referenced = 1;
+    } else if (code == TAOS_CLOCK_CACHE_DROP) {
+      taosClockCacheUnlink(pCache, pStripe, pNode);
+    }
+  }
+
+  pthread_mutex_unlock(&pStripe->mutex);
+
+  atomic_add_fetch_32((code == TAOS_CLOCK_CACHE_HIT) ? &pCache->hits : &pCache->misses, 1);
+  return code;
+}
+
+void taosPutIntoClockCache(void *handle, const void *key, const char *data, int32_t size,
+                           bool (*replaceFp)(const void *cachedKey, const void *key)) {
+  SClockCache *      pCache = (SClockCache *)handle;
+  uint32_t           hash = (*pCache->hashFp)(key);
+  SClockCacheStripe *pStripe = &pCache->stripes[hash % CLOCK_CACHE_STRIPES];
+  int64_t            nodeSize = taosClockCacheNodeSize(pCache, size);
+
+  // an entry that would flush a large part of the stripe is not worth caching
+  if (nodeSize > pStripe->capacity / 8) return;
+
+  SClockCacheNode *pNew = malloc((size_t)nodeSize);
+  if (pNew == NULL) return;
+
+  pNew->referenced = 0;
+  pNew->size = size;
+  memcpy(pNew->data, key, (size_t)pCache->keySize);
+  if (size > 0) memcpy(pNew->data + pCache->keyOffset, data, (size_t)size);
+
+  pthread_mutex_lock(&pStripe->mutex);
+
+  SClockCacheNode **ppBucket = taosClockCacheBucket(pCache, pStripe, hash);
+  SClockCacheNode * pNode = taosClockCacheFind(pCache, ppBucket, key);
+
+  if (pNode != NULL) {  // put by another thread at the same time, or the cached one is out of date
+    if (replaceFp != NULL && !(*replaceFp)(pNode->data, key)) {
+      pthread_mutex_unlock(&pStripe->mutex);
+      free(pNew);
+      return;
+    }
+
+    taosClockCacheUnlink(pCache, pStripe, pNode);
+  }
+
+  taosClockCacheEvict(pCache, pStripe, nodeSize);
+
+  pNew->hnext = *ppBucket;
+  *ppBucket = pNew;
+
+  // insert before the hand, so it is the last one to be checked
+  if (pStripe->hand == NULL) {
+    pNew->prev = pNew->next = pNew;
+    pStripe->hand = pNew;
+  } else {
+    pNew->next = pStripe->hand;
+    pNew->prev = pStripe->hand->prev;
+    pNew->prev->next = pNew;
+    pStripe->hand->prev = pNew;
+  }
+
+  pStripe->size += nodeSize;
+
+  pthread_mutex_unlock(&pStripe->mutex);
+}
+
+void taosRemoveFromClockCache(void *handle, bool (*fp)(const void *cachedKey, void *param), void *param) {
+  SClockCache *pCache = (SClockCache *)handle;
+
+  for (int32_t i = 0; i < CLOCK_CACHE_STRIPES; ++i) {
+    SClockCacheStripe *pStripe = &pCache->stripes[i];
+    pthread_mutex_lock(&pStripe->mutex);
+
+    for (int32_t j = 0; j < pCache->numOfBuckets; ++j) {
+      SClockCacheNode *pNode = pStripe->buckets[j];
+      while (pNode != NULL) {
+        SClockCacheNode *pNext = pNode->hnext;
+        if ((*fp)(pNode->data, param)) taosClockCacheUnlink(pCache, pStripe, pNode);
+        pNode = pNext;
+      }
+    }
+
+    pthread_mutex_unlock(&pStripe->mutex);
+  }
+}
+
+void taosGetClockCacheStatis(void *handle, int32_t *hits, int32_t *misses, int32_t *evictions) {
+  SClockCache *pCache = (SClockCache *)handle;
+
+  *hits = atomic_exchange_32(&pCache->hits, 0);
+  *misses = atomic_exchange_32(&pCache->misses, 0);
+  *evictions = atomic_exchange_32(&pCache->evictions, 0);
+}
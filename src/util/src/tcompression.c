@@ -45,12 +45,23 @@
  *   of leading zeros are larger than the trailing zeros, then record the last serveral bytes
  *   of the XORed value with informations. If not, record the first corresponding bytes.
  *
+ * BIT LEVEL Compression Algorithm (BIT_LEVEL_COMP):
+ *   Float and double types are compressed by the Gorilla method, which works on bits instead of bytes.
+ *   A zero XORed value is recorded with one bit. Otherwise, the meaningful bits of the XORed value
+ *   are recorded in the window of leading and trailing zeros of the previous one if they fit in it,
+ *   or are recorded with a new window of 5 bits leading zeros and 6 bits length.
+ *   Timestamps are compressed by delta-of-delta as well, but the zig-zag encoded values are bit-packed
+ *   with a fixed width in miniblocks of 128 values, so that they are unpacked by SIMD instructions.
+ *   Integers are bit-packed in the same miniblocks, after the zig-zag encoded deltas of each miniblock
+ *   are reduced by their minimum value (frame of reference).
+ *
  */
 
 #include "os.h"
 #include "lz4.h"
 #include "tscompression.h"
 #include "tsdb.h"
+#include "tsimd.h"
 #include "ttypes.h"
 
 const int TEST_NUMBER = 1;
@@ -70,6 +81,12 @@ int tsCompressDoubleImp(const char *const input, const int nelements, char *cons
 int tsDecompressDoubleImp(const char *const input, const int nelements, char *const output);
 int tsCompressFloatImp(const char *const input, const int nelements, char *const output);
 int tsDecompressFloatImp(const char *const input, const int nelements, char *const output);
+int tsCompressTimestampBitPackImp(const char *const input, const int nelements, char *const output);
+int tsDecompressTimestampBitPackImp(const char *const input, const int nelements, char *const output);
+int tsCompressXORImp(const char *const input, const int nelements, char *const output, const int bytes);
+int tsDecompressXORImp(const char *const input, const int nelements, char *const output, const int bytes);
+int tsCompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type);
+int tsDecompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type);
 
 /* ----------------------------------------------Compression function used by
  * others ---------------------------------------------- */
@@ -77,6 +94,8 @@ int tsCompressTinyint(const char *const input, int inputSize, const int nelement
                       char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_TINYINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
@@ -89,6 +108,8 @@ int tsDecompressTinyint(const char *const input, int compressedSize, const int n
                         int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_TINYINT);
@@ -101,6 +122,8 @@ int tsCompressSmallint(const char *const input, int inputSize, const int nelemen
                        char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_SMALLINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
@@ -113,6 +136,8 @@ int tsDecompressSmallint(const char *const input, int compressedSize, const int
                          int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_SMALLINT);
@@ -125,6 +150,8 @@ int tsCompressInt(const char *const input, int inputSize, const int nelements, c
                   char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_INT);
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_INT);
     return tsCompressStringImp(buffer, len, output, outputSize);
@@ -137,6 +164,8 @@ int tsDecompressInt(const char *const input, int compressedSize, const int nelem
                     int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_INT);
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_INT);
@@ -149,6 +178,8 @@ int tsCompressBigint(const char *const input, int inputSize, const int nelements
                      char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_BIGINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
@@ -161,6 +192,8 @@ int tsDecompressBigint(const char *const input, int compressedSize, const int ne
                        int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressINTBitPackImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_BIGINT);
@@ -171,7 +204,7 @@ int tsDecompressBigint(const char *const input, int compressedSize, const int ne
 
 int tsCompressBool(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, 
                    char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (algorithm == ONE_STAGE_COMP || algorithm == BIT_LEVEL_COMP) {
     return tsCompressBoolImp(input, nelements, output);
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressBoolImp(input, nelements, buffer);
@@ -183,7 +216,7 @@ int tsCompressBool(const char *const input, int inputSize, const int nelements,
 
 int tsDecompressBool(const char *const input, int compressedSize, const int nelements, char *const output,
                      int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (algorithm == ONE_STAGE_COMP || algorithm == BIT_LEVEL_COMP) {
     return tsDecompressBoolImp(input, nelements, output);
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
@@ -210,6 +243,8 @@ int tsCompressFloat(const char *const input, int inputSize, const int nelements,
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressFloatImp(input, nelements, buffer);
     return tsCompressStringImp(buffer, len, output, outputSize);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressXORImp(input, nelements, output, FLOAT_BYTES);
   } else {
     assert(0);
   }
@@ -222,6 +257,8 @@ int tsDecompressFloat(const char *const input, int compressedSize, const int nel
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressFloatImp(buffer, nelements, output);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressXORImp(input, nelements, output, FLOAT_BYTES);
   } else {
     assert(0);
   }
@@ -233,6 +270,8 @@ int tsCompressDouble(const char *const input, int inputSize, const int nelements
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressDoubleImp(input, nelements, buffer);
     return tsCompressStringImp(buffer, len, output, outputSize);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressXORImp(input, nelements, output, DOUBLE_BYTES);
   } else {
     assert(0);
   }
@@ -245,6 +284,8 @@ int tsDecompressDouble(const char *const input, int compressedSize, const int ne
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressDoubleImp(buffer, nelements, output);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressXORImp(input, nelements, output, DOUBLE_BYTES);
   } else {
     assert(0);
   }
@@ -257,6 +298,8 @@ int tsCompressTimestamp(const char *const input, int inputSize, const int neleme
   } else if (algorithm == TWO_STAGE_COMP) {
     int len = tsCompressTimestampImp(input, nelements, buffer);
     return tsCompressStringImp(buffer, len, output, outputSize);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsCompressTimestampBitPackImp(input, nelements, output);
   } else {
     assert(0);
   }
@@ -269,6 +312,8 @@ int tsDecompressTimestamp(const char *const input, int compressedSize, const int
   } else if (algorithm == TWO_STAGE_COMP) {
     tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
     return tsDecompressTimestampImp(buffer, nelements, output);
+  } else if (algorithm == BIT_LEVEL_COMP) {
+    return tsDecompressTimestampBitPackImp(input, nelements, output);
   } else {
     assert(0);
   }
@@ -1105,3 +1150,426 @@ int tsDecompressFloatImp(const char *const input, const int nelements, char *con
 
   return nelements * FLOAT_BYTES;
 }
+
+/* --------------------------------------------Bit Level Compression
+ * ---------------------------------------------- */
+// bits are written from the least significant bit of each byte
+typedef struct {
+  char *   buf;
+  int      pos;    // number of bytes written
+  uint64_t acc;    // bits not written yet
+  int      nbits;  // number of bits in acc, always less than 8 between two writes
+} SBitWriter;
+
+typedef struct {
+  const char *buf;
+  int         pos;
+  uint64_t    acc;
+  int         nbits;
+} SBitReader;
+
+static void writeBits(SBitWriter *pWriter, uint64_t val, int width) {
+  if (width > 56) {
+    writeBits(pWriter, val, 32);
+    val >>= 32;
+    width -= 32;
+  }
+
+  if (width == 0) return;
+
+  pWriter->acc |= (val & INT64MASK(width)) << pWriter->nbits;
+  pWriter->nbits += width;
+
+  while (pWriter->nbits >= BITS_PER_BYTE) {
+    pWriter->buf[pWriter->pos++] = (char)(pWriter->acc & INT64MASK(8));
+    pWriter->acc >>= BITS_PER_BYTE;
+    pWriter->nbits -= BITS_PER_BYTE;
+  }
+}
+
+static void flushBits(SBitWriter *pWriter) {
+  if (pWriter->nbits > 0) {
+    pWriter->buf[pWriter->pos++] = (char)(pWriter->acc & INT64MASK(8));
+    pWriter->acc = 0;
+    pWriter->nbits = 0;
+  }
+}
+
+static uint64_t readBits(SBitReader *pReader, int width) {
+  if (width > 56) {
+    uint64_t low = readBits(pReader, 32);
+    return low | (readBits(pReader, width - 32) << 32);
+  }
+
+  while (pReader->nbits < width) {
+    pReader->acc |= (uint64_t)(uint8_t)pReader->buf[pReader->pos++] << pReader->nbits;
+    pReader->nbits += BITS_PER_BYTE;
+  }
+
+  uint64_t val = pReader->acc & INT64MASK(width);
+  pReader->acc >>= width;
+  pReader->nbits -= width;
+
+  return val;
+}
+
+#define BITPACK_MINIBLOCK_SIZE 128
+
+// pack num values of width bits, return the number of bytes written, i.e., (num * width + 7) / 8
+static int packBits(const uint64_t *values, int num, int width, char *const output) {
+  SBitWriter writer = {.buf = output, .pos = 0};
+  for (int i = 0; i < num; i++) {
+    writeBits(&writer, values[i], width);
+  }
+
+  flushBits(&writer);
+  return writer.pos;
+}
+
+/*
+ * The first timestamp is kept in 8 bytes, followed by the zig-zag encoded delta-of-delta values of others,
+ * which are bit-packed in miniblocks of BITPACK_MINIBLOCK_SIZE values. Each miniblock starts with one byte of
+ * the bit width of its values.
+ */
+int tsCompressTimestampBitPackImp(const char *const input, const int nelements, char *const output) {
+  assert(nelements >= 0);
+  if (nelements == 0) return 0;
+
+  int64_t *istream = (int64_t *)input;
+  int      byte_limit = nelements * LONG_BYTES + 1;
+  int      opos = 1 + LONG_BYTES;
+
+  uint64_t zigzag[BITPACK_MINIBLOCK_SIZE];
+  int64_t  prev_value = istream[0];
+  int64_t  prev_delta = 0;
+
+  memcpy(output + 1, &prev_value, LONG_BYTES);
+
+  for (int start = 1; start < nelements; start += BITPACK_MINIBLOCK_SIZE) {
+    int      num = MIN(BITPACK_MINIBLOCK_SIZE, nelements - start);
+    uint64_t bits = 0;
+
+    for (int i = 0; i < num; i++) {
+      int64_t curr_value = istream[start + i];
+      if (!safeInt64Add(curr_value, -prev_value)) goto _exit_over;
+      int64_t curr_delta = curr_value - prev_value;
+      if (!safeInt64Add(curr_delta, -prev_delta)) goto _exit_over;
+      int64_t delta_of_delta = curr_delta - prev_delta;
+
+      zigzag[i] = (delta_of_delta >> (LONG_BYTES * BITS_PER_BYTE - 1)) ^ (delta_of_delta << 1);
+      bits |= zigzag[i];
+
+      prev_value = curr_value;
+      prev_delta = curr_delta;
+    }
+
+    int width = (bits == 0) ? 0 : LONG_BYTES * BITS_PER_BYTE - BUILDIN_CLZL(bits);
+    if (opos + 1 + (num * width + BITS_PER_BYTE - 1) / BITS_PER_BYTE > byte_limit) goto _exit_over;
+
+    output[opos++] = (char)width;
+
+    opos += packBits(zigzag, num, width, output + opos);
+  }
+
+  output[0] = 1;  // Means the string is compressed
+  return opos;
+
+_exit_over:
+  output[0] = 0;  // Means the string is not compressed
+  memcpy(output + 1, input, nelements * LONG_BYTES);
+  return byte_limit;
+}
+
+int tsDecompressTimestampBitPackImp(const char *const input, const int nelements, char *const output) {
+  assert(nelements >= 0);
+  if (nelements == 0) return 0;
+
+  if (input[0] == 0) {
+    memcpy(output, input + 1, nelements * LONG_BYTES);
+    return nelements * LONG_BYTES;
+  }
+
+  assert(input[0] == 1);
+
+  int64_t *ostream = (int64_t *)output;
+  int      ipos = 1 + LONG_BYTES;
+
+  uint64_t zigzag[BITPACK_MINIBLOCK_SIZE];
+  int64_t  prev_value = 0;
+  int64_t  prev_delta = 0;
+
+  memcpy(&prev_value, input + 1, LONG_BYTES);
+  ostream[0] = prev_value;
+
+  for (int start = 1; start < nelements; start += BITPACK_MINIBLOCK_SIZE) {
+    int num = MIN(BITPACK_MINIBLOCK_SIZE, nelements - start);
+    int width = (uint8_t)input[ipos++];
+
+    taosBitUnpack64(input + ipos, width, num, zigzag);
+    ipos += (num * width + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+
+    for (int i = 0; i < num; i++) {
+      int64_t delta_of_delta = (zigzag[i] >> 1) ^ -(zigzag[i] & 1);
+      prev_delta += delta_of_delta;
+      prev_value += prev_delta;
+      ostream[start + i] = prev_value;
+    }
+  }
+
+  return nelements * LONG_BYTES;
+}
+
+/*
+ * Gorilla compression of float (bytes is FLOAT_BYTES) and double (bytes is DOUBLE_BYTES) values. The first
+ * value is kept in full, and the control bits of others are:
+ *   0  - same as the previous value
+ *   10 - the meaningful bits are in the window of previous leading and trailing zeros
+ *   11 - 5 bits of leading zeros and 6 bits of the meaningful bits length(minus 1) follow
+ */
+int tsCompressXORImp(const char *const input, const int nelements, char *const output, const int bytes) {
+  int nbits = bytes * BITS_PER_BYTE;
+  int byte_limit = nelements * bytes + 1;
+
+  SBitWriter writer = {.buf = output, .pos = 1};
+
+  uint64_t prev_value = 0;
+  int      prev_leading = -1;
+  int      prev_trailing = 0;
+
+  for (int i = 0; i < nelements; i++) {
+    // a value takes at most (bytes + 2) bytes, together with the bits left by the previous one
+    if (writer.pos + bytes + 3 > byte_limit) {
+      output[0] = 1;
+      memcpy(output + 1, input, nelements * bytes);
+      return byte_limit;
+    }
+
+    uint64_t curr = (bytes == DOUBLE_BYTES) ? ((uint64_t *)input)[i] : ((uint32_t *)input)[i];
+    if (i == 0) {
+      writeBits(&writer, curr, nbits);
+      prev_value = curr;
+      continue;
+    }
+
+    uint64_t diff = curr ^ prev_value;
+    prev_value = curr;
+
+    if (diff == 0) {
+      writeBits(&writer, 0, 1);
+      continue;
+    }
+
+    int leading = BUILDIN_CLZL(diff) - (LONG_BYTES * BITS_PER_BYTE - nbits);
+    int trailing = BUILDIN_CTZL(diff);
+    if (leading > 31) leading = 31;
+
+    if (prev_leading >= 0 && leading >= prev_leading && trailing >= prev_trailing) {
+      writeBits(&writer, 1, 2);
+      writeBits(&writer, diff >> prev_trailing, nbits - prev_leading - prev_trailing);
+    } else {
+      int len = nbits - leading - trailing;
+
+      writeBits(&writer, 3, 2);
+      writeBits(&writer, leading, 5);
+      writeBits(&writer, len - 1, 6);
+      writeBits(&writer, diff >> trailing, len);
+
+      prev_leading = leading;
+      prev_trailing = trailing;
+    }
+  }
+
+  flushBits(&writer);
+
+  output[0] = 0;
+  return writer.pos;
+}
+
+int tsDecompressXORImp(const char *const input, const int nelements, char *const output, const int bytes) {
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * bytes);
+    return nelements * bytes;
+  }
+
+  int        nbits = bytes * BITS_PER_BYTE;
+  SBitReader reader = {.buf = input, .pos = 1};
+
+  uint64_t prev_value = 0;
+  int      leading = 0;
+  int      trailing = 0;
+
+  for (int i = 0; i < nelements; i++) {
+    if (i == 0) {
+      prev_value = readBits(&reader, nbits);
+    } else if (readBits(&reader, 1)) {
+      if (readBits(&reader, 1)) {
+        leading = (int)readBits(&reader, 5);
+        trailing = nbits - leading - ((int)readBits(&reader, 6) + 1);
+      }
+
+      prev_value ^= readBits(&reader, nbits - leading - trailing) << trailing;
+    }
+
+    if (bytes == DOUBLE_BYTES) {
+      ((uint64_t *)output)[i] = prev_value;
+    } else {
+      ((uint32_t *)output)[i] = (uint32_t)prev_value;
+    }
+  }
+
+  return nelements * bytes;
+}
+
+static int putVarint(char *const output, uint64_t val) {
+  int len = 0;
+  while (val >= 0x80) {
+    output[len++] = (char)((val & INT64MASK(7)) | 0x80);
+    val >>= 7;
+  }
+
+  output[len++] = (char)val;
+  return len;
+}
+
+static uint64_t getVarint(const char *const input, int *const ipos) {
+  uint64_t val = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = (uint8_t)input[(*ipos)++];
+    val |= (uint64_t)(byte & INT8MASK(7)) << shift;
+    if ((byte & 0x80) == 0) break;
+  }
+
+  return val;
+}
+
+static int getIntegerBytes(const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      return LONG_BYTES;
+    case TSDB_DATA_TYPE_INT:
+      return INT_BYTES;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return SHORT_BYTES;
+    case TSDB_DATA_TYPE_TINYINT:
+      return CHAR_BYTES;
+    default:
+      perror("Wrong integer types.\n");
+      exit(1);
+  }
+}
+
+/*
+ * The deltas of integers are zig-zag encoded, and bit-packed in miniblocks of BITPACK_MINIBLOCK_SIZE values.
+ * Each miniblock starts with one byte of the bit width and a varint of the minimum encoded delta, which is
+ * subtracted from all encoded deltas of the miniblock before packing. The deltas are computed with
+ * wraparound, so no overflow of bigint needs to be taken care of.
+ */
+int tsCompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type) {
+  int word_length = getIntegerBytes(type);
+  int byte_limit = nelements * word_length + 1;
+  int opos = 1;
+
+  uint64_t zigzag[BITPACK_MINIBLOCK_SIZE];
+  uint64_t prev_value = 0;
+
+  for (int start = 0; start < nelements; start += BITPACK_MINIBLOCK_SIZE) {
+    int      num = MIN(BITPACK_MINIBLOCK_SIZE, nelements - start);
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    for (int i = 0; i < num; i++) {
+      int64_t curr_value = 0;
+      switch (type) {
+        case TSDB_DATA_TYPE_BIGINT:
+          curr_value = ((int64_t *)input)[start + i];
+          break;
+        case TSDB_DATA_TYPE_INT:
+          curr_value = ((int32_t *)input)[start + i];
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          curr_value = ((int16_t *)input)[start + i];
+          break;
+        default:
+          curr_value = ((int8_t *)input)[start + i];
+          break;
+      }
+
+      int64_t delta = (int64_t)((uint64_t)curr_value - prev_value);
+      zigzag[i] = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> (LONG_BYTES * BITS_PER_BYTE - 1));
+      prev_value = (uint64_t)curr_value;
+
+      if (zigzag[i] < min) min = zigzag[i];
+      if (zigzag[i] > max) max = zigzag[i];
+    }
+
+    int width = (max == min) ? 0 : LONG_BYTES * BITS_PER_BYTE - BUILDIN_CLZL(max - min);
+
+    // one byte of width and at most 10 bytes of varint
+    if (opos + 11 + (num * width + BITS_PER_BYTE - 1) / BITS_PER_BYTE > byte_limit) {
+      output[0] = 1;
+      memcpy(output + 1, input, nelements * word_length);
+      return byte_limit;
+    }
+
+    for (int i = 0; i < num; i++) {
+      zigzag[i] -= min;
+    }
+
+    output[opos++] = (char)width;
+    opos += putVarint(output + opos, min);
+    opos += packBits(zigzag, num, width, output + opos);
+  }
+
+  output[0] = 0;
+  return opos;
+}
+
+// add the reference back, and restore the value from zig-zag encoded delta
+#define INT_BITPACK_DECODE(_type)                      \
+  do {                                                 \
+    _type *ostream = (_type *)output + start;          \
+    for (int i = 0; i < num; i++) {                    \
+      uint64_t zigzag = values[i] + min;               \
+      prev_value += (zigzag >> 1) ^ -(zigzag & 1);     \
+      ostream[i] = (_type)prev_value;                  \
+    }                                                  \
+  } while (0)
+
+int tsDecompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type) {
+  int word_length = getIntegerBytes(type);
+
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * word_length);
+    return nelements * word_length;
+  }
+
+  int      ipos = 1;
+  uint64_t values[BITPACK_MINIBLOCK_SIZE];
+  uint64_t prev_value = 0;
+
+  for (int start = 0; start < nelements; start += BITPACK_MINIBLOCK_SIZE) {
+    int num = MIN(BITPACK_MINIBLOCK_SIZE, nelements - start);
+    int width = (uint8_t)input[ipos++];
+
+    uint64_t min = getVarint(input, &ipos);
+    taosBitUnpack64(input + ipos, width, num, values);
+    ipos += (num * width + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        INT_BITPACK_DECODE(int64_t);
+        break;
+      case TSDB_DATA_TYPE_INT:
+        INT_BITPACK_DECODE(int32_t);
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        INT_BITPACK_DECODE(int16_t);
+        break;
+      default:
+        INT_BITPACK_DECODE(int8_t);
+        break;
+    }
+  }
+
+  return nelements * word_length;
+}
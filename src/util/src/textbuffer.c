@@ -99,6 +99,8 @@ void tExtMemBufferDestroy(tExtMemBuffer **pMemBuffer) {
     tfree(pTmp);
   }
 
+  tfree((*pMemBuffer)->pPagesInMem);
+
   // close temp file
   if ((*pMemBuffer)->dataFile != 0) {
     int32_t ret = fclose((*pMemBuffer)->dataFile);
@@ -130,15 +132,80 @@ static bool allocFlushoutInfoEntries(tFileMeta *pFileMeta) {
   return true;
 }
 
+/*
+ * the number of pages, both in disk and in memory, that belong to the closed flush out records
+ */
+static uint32_t tExtMemBufferNumOfSealedPages(tExtMemBuffer *pMemBuffer) {
+  tFlushoutData *pFlushoutData = &pMemBuffer->fileMeta.flushoutData;
+  if (pFlushoutData->nLength == 0) {
+    return 0;
+  }
+
+  tFlushoutInfo *pLast = &pFlushoutData->pFlushoutInfo[pFlushoutData->nLength - 1];
+  return pLast->startPageId + pLast->numOfPages;
+}
+
+/*
+ * write all in-memory pages to the end of the file, the flush out info is not touched
+ */
+static bool tExtMemBufferWritePages(tExtMemBuffer *pMemBuffer) {
+  if (pMemBuffer->dataFile == NULL) {
+    if ((pMemBuffer->dataFile = fopen(pMemBuffer->dataFilePath, "wb+")) == NULL) {
+      return false;
+    }
+  }
+
+  bool            ret = true;
+  tFilePagesItem *first = pMemBuffer->pHead;
+
+  while (first != NULL) {
+    size_t retVal = fwrite((char *)&(first->item), pMemBuffer->nPageSize, 1, pMemBuffer->dataFile);
+    if (retVal <= 0) {  // failed to write to buffer, may be not enough space
+      ret = false;
+    }
+
+    pMemBuffer->fileMeta.numOfElemsInFile += first->item.numOfElems;
+    pMemBuffer->fileMeta.nFileSize += 1;
+
+    tFilePagesItem *ptmp = first;
+    first = first->pNext;
+
+    tfree(ptmp);  // release all data in memory buffer
+  }
+
+  fflush(pMemBuffer->dataFile);  // flush to disk
+
+  pMemBuffer->numOfElemsInBuffer = 0;
+  pMemBuffer->numOfPagesInMem = 0;
+  pMemBuffer->pHead = NULL;
+  pMemBuffer->pTail = NULL;
+
+  return ret;
+}
+
 bool tExtMemBufferAlloc(tExtMemBuffer *pMemBuffer) {
   if (pMemBuffer->numOfPagesInMem > 0 && pMemBuffer->numOfPagesInMem == pMemBuffer->nMaxSizeInPages) {
     /*
      * the in-mem buffer is full.
-     * To flush data to disk to accommodate more data
+     * To flush data to disk to accommodate more data. In MULTIPLE_APPEND_MODEL, the data being put still belongs
+     * to current flush out record, which is closed by tExtMemBufferSeal or tExtMemBufferFlush.
      */
-    if (!tExtMemBufferFlush(pMemBuffer)) {
+    bool ret = (pMemBuffer->flushModel == MULTIPLE_APPEND_MODEL) ? tExtMemBufferWritePages(pMemBuffer)
+                                                                  : tExtMemBufferFlush(pMemBuffer);
+    if (!ret) {
+      return false;
+    }
+  }
+
+  if (pMemBuffer->numOfPagesInMem == pMemBuffer->nAllocPagesInMem) {
+    int32_t          nAlloc = (pMemBuffer->nAllocPagesInMem == 0) ? 4 : (pMemBuffer->nAllocPagesInMem << 1);
+    tFilePagesItem **tmp = (tFilePagesItem **)realloc(pMemBuffer->pPagesInMem, POINTER_BYTES * nAlloc);
+    if (tmp == NULL) {
       return false;
     }
+
+    pMemBuffer->pPagesInMem = tmp;
+    pMemBuffer->nAllocPagesInMem = nAlloc;
   }
 
   /*
@@ -164,6 +231,7 @@ bool tExtMemBufferAlloc(tExtMemBuffer *pMemBuffer) {
     pMemBuffer->pHead = item;
   }
 
+  pMemBuffer->pPagesInMem[pMemBuffer->numOfPagesInMem] = item;
   pMemBuffer->numOfPagesInMem += 1;
 
   return true;
@@ -172,13 +240,15 @@ bool tExtMemBufferAlloc(tExtMemBuffer *pMemBuffer) {
 /*
  * put elements into buffer
  */
-int16_t tExtMemBufferPut(tExtMemBuffer *pMemBuffer, void *data, int32_t numOfRows) {
+int32_t tExtMemBufferPut(tExtMemBuffer *pMemBuffer, void *data, int32_t numOfRows) {
   if (numOfRows == 0) {
     return pMemBuffer->numOfPagesInMem;
   }
 
+  // the last page of a sealed flush out record is not appended any more
   tFilePagesItem *pLast = pMemBuffer->pTail;
-  if (pLast == NULL) {
+  if (pLast == NULL ||
+      tExtMemBufferNumOfSealedPages(pMemBuffer) == pMemBuffer->fileMeta.nFileSize + pMemBuffer->numOfPagesInMem) {
     if (!tExtMemBufferAlloc(pMemBuffer)) {
       return -1;
     }
@@ -232,6 +302,11 @@ static bool tExtMemBufferUpdateFlushoutInfo(tExtMemBuffer *pMemBuffer) {
   tFileMeta *pFileMeta = &pMemBuffer->fileMeta;
 
   if (pMemBuffer->flushModel == MULTIPLE_APPEND_MODEL) {
+    // no data since the last flush out record
+    if (tExtMemBufferNumOfSealedPages(pMemBuffer) == pFileMeta->nFileSize + pMemBuffer->numOfPagesInMem) {
+      return true;
+    }
+
     if (pFileMeta->flushoutData.nLength == pFileMeta->flushoutData.nAllocSize && !allocFlushoutInfoEntries(pFileMeta)) {
       return false;
     }
@@ -245,8 +320,8 @@ static bool tExtMemBufferUpdateFlushoutInfo(tExtMemBuffer *pMemBuffer) {
           pFileMeta->flushoutData.pFlushoutInfo[pFileMeta->flushoutData.nLength - 1].numOfPages;
     }
 
-    // only the page still in buffer is flushed out to disk
-    pFlushoutInfo->numOfPages = pMemBuffer->numOfPagesInMem;
+    // only the pages that are not sealed yet, in disk or in buffer, are belonged to the new flush out record
+    pFlushoutInfo->numOfPages = pFileMeta->nFileSize + pMemBuffer->numOfPagesInMem - pFlushoutInfo->startPageId;
     pFileMeta->flushoutData.nLength += 1;
   } else {
     // always update the first flushout array in single_flush_model
@@ -281,34 +356,20 @@ bool tExtMemBufferFlush(tExtMemBuffer *pMemBuffer) {
     return true;
   }
 
-  bool            ret = true;
-  tFilePagesItem *first = pMemBuffer->pHead;
-
-  while (first != NULL) {
-    size_t retVal = fwrite((char *)&(first->item), pMemBuffer->nPageSize, 1, pMemBuffer->dataFile);
-    if (retVal <= 0) {  // failed to write to buffer, may be not enough space
-      ret = false;
-    }
-
-    pMemBuffer->fileMeta.numOfElemsInFile += first->item.numOfElems;
-    pMemBuffer->fileMeta.nFileSize += 1;
-
-    tFilePagesItem *ptmp = first;
-    first = first->pNext;
-
-    tfree(ptmp);  // release all data in memory buffer
+  if (!tExtMemBufferUpdateFlushoutInfo(pMemBuffer)) {
+    return false;
   }
 
-  fflush(pMemBuffer->dataFile);  // flush to disk
-
-  tExtMemBufferUpdateFlushoutInfo(pMemBuffer);
+  return tExtMemBufferWritePages(pMemBuffer);
+}
 
-  pMemBuffer->numOfElemsInBuffer = 0;
-  pMemBuffer->numOfPagesInMem = 0;
-  pMemBuffer->pHead = NULL;
-  pMemBuffer->pTail = NULL;
+bool tExtMemBufferSeal(tExtMemBuffer *pMemBuffer) {
+  // all data belong to the only flush out record in SINGLE_APPEND_MODEL, which is updated when flushing to disk
+  if (pMemBuffer->flushModel == SINGLE_APPEND_MODEL) {
+    return true;
+  }
 
-  return ret;
+  return tExtMemBufferUpdateFlushoutInfo(pMemBuffer);
 }
 
 void tExtMemBufferClear(tExtMemBuffer *pMemBuffer) {
@@ -346,11 +407,19 @@ bool tExtMemBufferLoadData(tExtMemBuffer *pMemBuffer, tFilePage *pFilePage, int3
   }
 
   tFlushoutInfo *pInfo = &(pMemBuffer->fileMeta.flushoutData.pFlushoutInfo[flushoutId]);
-  if (pageIdx > (int32_t)pInfo->numOfPages) {
+  if (pageIdx >= (int32_t)pInfo->numOfPages) {
     return false;
   }
 
-  size_t ret = fseek(pMemBuffer->dataFile, (pInfo->startPageId + pageIdx) * pMemBuffer->nPageSize, SEEK_SET);
+  // the page has not been flushed to disk yet
+  uint32_t pageId = pInfo->startPageId + pageIdx;
+  if (pageId >= pMemBuffer->fileMeta.nFileSize) {
+    tFilePagesItem *pItem = pMemBuffer->pPagesInMem[pageId - pMemBuffer->fileMeta.nFileSize];
+    memcpy(pFilePage, &pItem->item, pMemBuffer->nPageSize);
+    return true;
+  }
+
+  size_t ret = fseek(pMemBuffer->dataFile, pageId * pMemBuffer->nPageSize, SEEK_SET);
   ret = fread(pFilePage, pMemBuffer->nPageSize, 1, pMemBuffer->dataFile);
 
   return (ret > 0);
@@ -793,9 +862,9 @@ void tMemBucketPut(tMemBucket *pBucket, void *data, int32_t numOfRows) {
                pBucket, cseg, cslot);
       }
     }
-    int16_t consumedPgs = pSeg->pBuffer[slotIdx]->numOfPagesInMem;
+    int32_t consumedPgs = pSeg->pBuffer[slotIdx]->numOfPagesInMem;
 
-    int16_t newPgs = tExtMemBufferPut(pSeg->pBuffer[slotIdx], d, 1);
+    int32_t newPgs = tExtMemBufferPut(pSeg->pBuffer[slotIdx], d, 1);
     /*
      * trigger 1. page re-allocation, to reduce the available pages
      *         2. page flushout, to increase the available pages
@@ -74,6 +74,13 @@ int tsMetricMetaKeepTimer = 600;  // second
 
 float tsNumOfThreadsPerCore = 1.0;
 float tsRatioOfQueryThreads = 0.5;
+int   tsQueryParallelism = 4;  // max number of query threads that scan the meters of one super table query
+int   tsMergeBufferSize = 64;  // MB, in-memory buffer of the client to merge the results of one super table query
+int   tsMaxConcurrentSubqueries = 64;  // max number of vnodes that one super table query retrieves from at the same time
+int   tsBlockCacheSize = 64;  // MB, cache of decompressed data blocks shared by all queries of the dnode, 0 is disabled
+int   tsCompBlockCacheSize = 16;  // MB, cache of comp block info of meters shared by all queries of the dnode, 0 is disabled
+int   tsNumOfPrefetchBlocks = 4;  // number of following data blocks read by kernel in advance during query, 0 is disabled
+int   tsNumOfStartupThreads = 4;  // threads to open vnodes and restore data from commit logs at startup
 char  tsPublicIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsInternalIp[TSDB_IPv4ADDR_LEN] = {0};
 char  tsPrivateIp[TSDB_IPv4ADDR_LEN] = {0};
@@ -92,6 +99,9 @@ float tsFileBlockMinPercent = 0.05;
 short tsNumOfBlocksPerMeter = 100;
 short tsCommitTime = 3600;  // seconds
 short tsCommitLog = 1;
+int   tsCommitLogSyncTime = 10;           // ms, group commit window of the commit log in sync mode
+int   tsCommitLogSyncBytes = 1024 * 1024;  // the commit log is synced at once if so many bytes are not synced
+int   tsNumOfCommitThreads = 4;            // threads shared by vnodes to compress data blocks during commit
 short tsCompression = 2;
 short tsDaysPerFile = 10;
 int   tsDaysToKeep = 3650;
@@ -502,6 +512,27 @@ static void doInitGlobalConfig() {
   tsInitConfigOption(cfg++, "ratioOfQueryThreads", &tsRatioOfQueryThreads, TSDB_CFG_VTYPE_FLOAT,
                      TSDB_CFG_CTYPE_B_CONFIG,
                      0.1, 0.9, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "queryParallelism", &tsQueryParallelism, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG,
+                     1, 64, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "mergeBufferSize", &tsMergeBufferSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 512, 0, TSDB_CFG_UTYPE_MB);
+  tsInitConfigOption(cfg++, "maxConcurrentSubqueries", &tsMaxConcurrentSubqueries, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT,
+                     1, 4096, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "blockCacheSize", &tsBlockCacheSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 65536, 0, TSDB_CFG_UTYPE_MB);
+  tsInitConfigOption(cfg++, "compBlockCacheSize", &tsCompBlockCacheSize, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 65536, 0, TSDB_CFG_UTYPE_MB);
+  tsInitConfigOption(cfg++, "numOfPrefetchBlocks", &tsNumOfPrefetchBlocks, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 256, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "numOfStartupThreads", &tsNumOfStartupThreads, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     1, 64, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "numOfVnodesPerCore", &tsNumOfVnodesPerCore, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
                      1, 64, 0, TSDB_CFG_UTYPE_NONE);
@@ -618,10 +649,19 @@ static void doInitGlobalConfig() {
 
   tsInitConfigOption(cfg++, "clog", &tsCommitLog, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
-                     0, 1, 0, TSDB_CFG_UTYPE_NONE);
+                     0, 2, 0, TSDB_CFG_UTYPE_NONE);
+  tsInitConfigOption(cfg++, "clogSyncTime", &tsCommitLogSyncTime, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     1, 1000, 0, TSDB_CFG_UTYPE_MS);
+  tsInitConfigOption(cfg++, "clogSyncBytes", &tsCommitLogSyncBytes, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     4096, 64 * 1024 * 1024, 0, TSDB_CFG_UTYPE_BYTE);
+  tsInitConfigOption(cfg++, "numOfCommitThreads", &tsNumOfCommitThreads, TSDB_CFG_VTYPE_INT,
+                     TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
+                     0, 64, 0, TSDB_CFG_UTYPE_NONE);
   tsInitConfigOption(cfg++, "comp", &tsCompression, TSDB_CFG_VTYPE_SHORT,
                      TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW,
-                     0, 2, 0, TSDB_CFG_UTYPE_NONE);
+                     0, 3, 0, TSDB_CFG_UTYPE_NONE);
 
   // database configs
   tsInitConfigOption(cfg++, "days", &tsDaysPerFile, TSDB_CFG_VTYPE_SHORT,
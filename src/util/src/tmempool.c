@@ -22,16 +22,48 @@
 #include "tmempool.h"
 #include "tutil.h"
 
+/*
+ * Each thread keeps a magazine of free slots for a pool, which holds up to 2 * magazineSize slots. A thread takes
+ * magazineSize slots from the shared free list when its magazine is empty, and gives magazineSize slots back when
+ * it is full, so the pool mutex is only locked once per magazineSize allocations or frees in the common case.
+ * The slots in magazines are not visible to other threads, so the pool allocates extra blocks to cover all that
+ * can be cached, and the number of magazines is capped. A pool sized to its number of users never runs out because
+ * of the magazines. Threads beyond the cap lock the pool mutex for each call.
+ */
+#define MPOOL_MAX_MAGAZINE_SIZE 32
+#define MPOOL_MAX_MAGAZINES     16
+
+static char taosMemPoolNoMagazine;  // the thread specific value of threads beyond the cap
+
+typedef struct _mpool_magazine {
+  void *                  pool;
+  int                     numOfCached; /* number of cached slots */
+  int64_t                 allocCount;
+  int64_t                 freeCount;
+  struct _mpool_magazine *prev;
+  struct _mpool_magazine *next;
+  int                     cached[];
+} mpool_magazine_t;
+
 typedef struct {
-  int             numOfFree;  /* number of free slots */
-  int             first;      /* the first free slot  */
-  int             numOfBlock; /* the number of blocks */
-  int             blockSize;  /* block size in bytes  */
-  int *           freeList;   /* the index list       */
-  char *          pool;       /* the actual mem block */
-  pthread_mutex_t mutex;
+  int               numOfFree;    /* number of free slots */
+  int               first;        /* the first free slot  */
+  int               numOfBlock;   /* the number of blocks, including the extra ones for magazines */
+  int               blockSize;    /* block size in bytes  */
+  int *             freeList;     /* the index list       */
+  char *            pool;         /* the actual mem block */
+  int               magazineSize; /* 0 if magazines are not used */
+  int               numOfMagazines;
+  pthread_key_t     magazineKey;
+  mpool_magazine_t *pMagazines;   /* magazines of all threads */
+  int64_t           allocCount;   /* allocations, including those of exited threads */
+  int64_t           freeCount;
+  int64_t           failedCount;
+  pthread_mutex_t   mutex;
 } pool_t;
 
+static void taosMemPoolReleaseMagazine(void *param);
+
 mpool_h taosMemPoolInit(int numOfBlock, int blockSize) {
   int     i;
   pool_t *pool_p;
@@ -49,6 +81,16 @@ mpool_h taosMemPoolInit(int numOfBlock, int blockSize) {
     memset(pool_p, 0, sizeof(pool_t));
   }
 
+  // small pools are not split into magazines, otherwise the extra blocks would outnumber the blocks asked for
+  pool_p->magazineSize = MIN(numOfBlock / 64, MPOOL_MAX_MAGAZINE_SIZE);
+  if (pool_p->magazineSize > 0 && pthread_key_create(&pool_p->magazineKey, taosMemPoolReleaseMagazine) != 0) {
+    pool_p->magazineSize = 0;
+  }
+
+  if (pool_p->magazineSize > 0) {
+    numOfBlock += MPOOL_MAX_MAGAZINES * 2 * pool_p->magazineSize;
+  }
+
   pool_p->blockSize = blockSize;
   pool_p->numOfBlock = numOfBlock;
   pool_p->pool = (char *)malloc((size_t)(blockSize * numOfBlock));
@@ -56,6 +98,7 @@ mpool_h taosMemPoolInit(int numOfBlock, int blockSize) {
 
   if (pool_p->pool == NULL || pool_p->freeList == NULL) {
     pError("failed to allocate memory\n");
+    if (pool_p->magazineSize > 0) pthread_key_delete(pool_p->magazineKey);
     tfree(pool_p->freeList);
     tfree(pool_p->pool);
     tfree(pool_p);
@@ -73,20 +116,121 @@ mpool_h taosMemPoolInit(int numOfBlock, int blockSize) {
   return (mpool_h)pool_p;
 }
 
+// the following two functions are called with the pool mutex locked
+static int taosMemPoolTakeSlots(pool_t *pool_p, int *slots, int num) {
+  num = MIN(num, pool_p->numOfFree);
+  for (int i = 0; i < num; ++i) {
+    slots[i] = pool_p->freeList[pool_p->first];
+    pool_p->first = (pool_p->first + 1) % pool_p->numOfBlock;
+  }
+
+  pool_p->numOfFree -= num;
+  return num;
+}
+
+static void taosMemPoolPutSlots(pool_t *pool_p, int *slots, int num) {
+  for (int i = 0; i < num; ++i) {
+    pool_p->freeList[(pool_p->first + pool_p->numOfFree) % pool_p->numOfBlock] = slots[i];
+    pool_p->numOfFree++;
+  }
+}
+
+static mpool_magazine_t *taosMemPoolGetMagazine(pool_t *pool_p) {
+  if (pool_p->magazineSize == 0) return NULL;
+
+  void *param = pthread_getspecific(pool_p->magazineKey);
+  if (param == &taosMemPoolNoMagazine) return NULL;
+
+  mpool_magazine_t *pMagazine = (mpool_magazine_t *)param;
+  if (pMagazine != NULL && pMagazine->pool == pool_p) return pMagazine;
+
+  pthread_mutex_lock(&pool_p->mutex);
+  if (pool_p->numOfMagazines >= MPOOL_MAX_MAGAZINES) {
+    pthread_mutex_unlock(&pool_p->mutex);
+    pthread_setspecific(pool_p->magazineKey, &taosMemPoolNoMagazine);
+    return NULL;
+  }
+
+  pool_p->numOfMagazines++;
+  pthread_mutex_unlock(&pool_p->mutex);
+
+  pMagazine = (mpool_magazine_t *)calloc(1, sizeof(mpool_magazine_t) + sizeof(int) * 2 * pool_p->magazineSize);
+  if (pMagazine != NULL) {
+    pMagazine->pool = pool_p;
+    if (pthread_setspecific(pool_p->magazineKey, pMagazine) != 0) tfree(pMagazine);
+  }
+
+  pthread_mutex_lock(&pool_p->mutex);
+  if (pMagazine != NULL) {
+    pMagazine->next = pool_p->pMagazines;
+    if (pool_p->pMagazines) pool_p->pMagazines->prev = pMagazine;
+    pool_p->pMagazines = pMagazine;
+  } else {
+    pool_p->numOfMagazines--;
+  }
+  pthread_mutex_unlock(&pool_p->mutex);
+
+  return pMagazine;
+}
+
+// called when the thread exits, the cached slots are given back to the pool
+static void taosMemPoolReleaseMagazine(void *param) {
+  if (param == &taosMemPoolNoMagazine) return;
+
+  mpool_magazine_t *pMagazine = (mpool_magazine_t *)param;
+  pool_t *          pool_p = (pool_t *)pMagazine->pool;
+
+  pthread_mutex_lock(&pool_p->mutex);
+
+  pool_p->numOfMagazines--;
+  taosMemPoolPutSlots(pool_p, pMagazine->cached, pMagazine->numOfCached);
+  pool_p->allocCount += pMagazine->allocCount;
+  pool_p->freeCount += pMagazine->freeCount;
+
+  if (pMagazine->prev) {
+    pMagazine->prev->next = pMagazine->next;
+  } else {
+    pool_p->pMagazines = pMagazine->next;
+  }
+
+  if (pMagazine->next) pMagazine->next->prev = pMagazine->prev;
+
+  pthread_mutex_unlock(&pool_p->mutex);
+
+  free(pMagazine);
+}
+
 char *taosMemPoolMalloc(mpool_h handle) {
   char *  pos = NULL;
   pool_t *pool_p = (pool_t *)handle;
 
-  pthread_mutex_lock(&(pool_p->mutex));
+  mpool_magazine_t *pMagazine = taosMemPoolGetMagazine(pool_p);
+  if (pMagazine != NULL) {
+    if (pMagazine->numOfCached == 0) {
+      pthread_mutex_lock(&(pool_p->mutex));
+      pMagazine->numOfCached = taosMemPoolTakeSlots(pool_p, pMagazine->cached, pool_p->magazineSize);
+      if (pMagazine->numOfCached == 0) pool_p->failedCount++;
+      pthread_mutex_unlock(&(pool_p->mutex));
+    }
 
-  if (pool_p->numOfFree > 0) {
-    pos = pool_p->pool + pool_p->blockSize * (pool_p->freeList[pool_p->first]);
-    pool_p->first++;
-    pool_p->first = pool_p->first % pool_p->numOfBlock;
-    pool_p->numOfFree--;
-  }
+    if (pMagazine->numOfCached > 0) {
+      pos = pool_p->pool + pool_p->blockSize * pMagazine->cached[--pMagazine->numOfCached];
+      pMagazine->allocCount++;
+    }
+  } else {
+    int index = 0;
+
+    pthread_mutex_lock(&(pool_p->mutex));
+
+    if (taosMemPoolTakeSlots(pool_p, &index, 1) > 0) {
+      pos = pool_p->pool + pool_p->blockSize * index;
+      pool_p->allocCount++;
+    } else {
+      pool_p->failedCount++;
+    }
 
-  pthread_mutex_unlock(&(pool_p->mutex));
+    pthread_mutex_unlock(&(pool_p->mutex));
+  }
 
   if (pos == NULL) pTrace("mempool: out of memory");
   return pos;
@@ -112,17 +256,49 @@ void taosMemPoolFree(mpool_h handle, char *pMem) {
 
   memset(pMem, 0, (size_t)pool_p->blockSize);
 
-  pthread_mutex_lock(&pool_p->mutex);
+  mpool_magazine_t *pMagazine = taosMemPoolGetMagazine(pool_p);
+  if (pMagazine != NULL) {
+    if (pMagazine->numOfCached == 2 * pool_p->magazineSize) {
+      // give back the earlier freed half, the recently freed slots are more likely in CPU cache
+      pthread_mutex_lock(&pool_p->mutex);
+      taosMemPoolPutSlots(pool_p, pMagazine->cached, pool_p->magazineSize);
+      pthread_mutex_unlock(&pool_p->mutex);
 
-  pool_p->freeList[(pool_p->first + pool_p->numOfFree) % pool_p->numOfBlock] = index;
-  pool_p->numOfFree++;
+      memmove(pMagazine->cached, pMagazine->cached + pool_p->magazineSize, sizeof(int) * pool_p->magazineSize);
+      pMagazine->numOfCached = pool_p->magazineSize;
+    }
 
-  pthread_mutex_unlock(&pool_p->mutex);
+    pMagazine->cached[pMagazine->numOfCached++] = index;
+    pMagazine->freeCount++;
+  } else {
+    pthread_mutex_lock(&pool_p->mutex);
+
+    taosMemPoolPutSlots(pool_p, &index, 1);
+    pool_p->freeCount++;
+
+    pthread_mutex_unlock(&pool_p->mutex);
+  }
 }
 
 void taosMemPoolCleanUp(mpool_h handle) {
   pool_t *pool_p = (pool_t *)handle;
 
+  if (pool_p->magazineSize > 0) {
+    pthread_key_delete(pool_p->magazineKey);
+  }
+
+  mpool_magazine_t *pMagazine = pool_p->pMagazines;
+  while (pMagazine) {
+    mpool_magazine_t *pNext = pMagazine->next;
+    pool_p->allocCount += pMagazine->allocCount;
+    pool_p->freeCount += pMagazine->freeCount;
+    free(pMagazine);
+    pMagazine = pNext;
+  }
+
+  pTrace("mempool:%p is cleaned up, blocks:%d size:%d, alloc:%ld free:%ld failed:%ld", pool_p,
+         pool_p->numOfBlock, pool_p->blockSize, pool_p->allocCount, pool_p->freeCount, pool_p->failedCount);
+
   pthread_mutex_destroy(&pool_p->mutex);
   if (pool_p->pool) free(pool_p->pool);
   if (pool_p->freeList) free(pool_p->freeList);
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "trcu.h"
+
+/*
+ * Readers count themselves in one of the two generations, in a slot picked by the thread id to spread the
+ * counters over cache lines. To wait for the readers, the writer flips the generation and waits until the
+ * counters of the previous one drop to zero. A reader that counted itself in the previous generation after the
+ * flip sees the new generation and enters again, so it never reads a node unlinked before the flip.
+ */
+#define TAOS_RCU_SLOTS 16
+
+typedef struct {
+  int32_t count;
+  char    padding[60];
+} SRcuSlot;
+
+typedef struct {
+  SRcuSlot readers[2][TAOS_RCU_SLOTS];
+  int32_t  gen;
+  int32_t  numOfRetired;
+  void *   retired[TAOS_RCU_RETIRE_BATCH];
+  void (*freeFp)(void *param, void *p);
+  void *          param;
+  pthread_mutex_t mutex;  // guards the retired nodes, and serializes the writers waiting for readers
+} SRcuObj;
+
+static int32_t taosRcuSlot() {
+  uint64_t id = (uint64_t)taosGetPthreadId();
+  return (int32_t)((id * 0x9E3779B97F4A7C15UL) >> 60) % TAOS_RCU_SLOTS;
+}
+
+void *taosInitRcu(void (*freeFp)(void *param, void *p), void *param) {
+  SRcuObj *pRcu = (SRcuObj *)calloc(1, sizeof(SRcuObj));
+  if (pRcu == NULL) return NULL;
+
+  pRcu->freeFp = freeFp;
+  pRcu->param = param;
+  pthread_mutex_init(&pRcu->mutex, NULL);
+
+  return pRcu;
+}
+
+/*
+ * returns the token to leave the read section, nodes reached in the read section stay valid until it is left
+ */
+int32_t taosRcuReadLock(void *handle) {
+  SRcuObj *pRcu = (SRcuObj *)handle;
+  int32_t  slot = taosRcuSlot();
+
+  while (1) {
+    int32_t gen = atomic_load_32(&pRcu->gen);
+    atomic_add_fetch_32(&pRcu->readers[gen][slot].count, 1);
+    if (atomic_load_32(&pRcu->gen) == gen) return gen * TAOS_RCU_SLOTS + slot;
+
+    atomic_sub_fetch_32(&pRcu->readers[gen][slot].count, 1);
+  }
+}
+
+void taosRcuReadUnlock(void *handle, int32_t token) {
+  SRcuObj *pRcu = (SRcuObj *)handle;
+  atomic_sub_fetch_32(&pRcu->readers[token / TAOS_RCU_SLOTS][token % TAOS_RCU_SLOTS].count, 1);
+}
+
+// called with the mutex locked
+static void taosRcuWaitForReaders(SRcuObj *pRcu) {
+  int32_t gen = pRcu->gen;
+  atomic_store_32(&pRcu->gen, 1 - gen);
+
+  for (int32_t i = 0; i < TAOS_RCU_SLOTS; ++i) {
+    while (atomic_load_32(&pRcu->readers[gen][i].count) != 0) sched_yield();
+  }
+}
+
+static void taosRcuFreeRetired(SRcuObj *pRcu) {
+  for (int32_t i = 0; i < pRcu->numOfRetired; ++i) {
+    if (pRcu->freeFp) {
+      (*pRcu->freeFp)(pRcu->param, pRcu->retired[i]);
+    } else {
+      free(pRcu->retired[i]);
+    }
+  }
+
+  pRcu->numOfRetired = 0;
+}
+
+/*
+ * the node must have been unlinked, so that no read section entered from now on can reach it. It must not be
+ * called inside a read section.
+ */
+void taosRcuRetire(void *handle, void *p) {
+  SRcuObj *pRcu = (SRcuObj *)handle;
+
+  pthread_mutex_lock(&pRcu->mutex);
+
+  pRcu->retired[pRcu->numOfRetired++] = p;
+  if (pRcu->numOfRetired == TAOS_RCU_RETIRE_BATCH) {
+    taosRcuWaitForReaders(pRcu);
+    taosRcuFreeRetired(pRcu);
+  }
+
+  pthread_mutex_unlock(&pRcu->mutex);
+}
+
+/*
+ * wait for the read sections entered before, and free all retired nodes
+ */
+void taosRcuSynchronize(void *handle) {
+  SRcuObj *pRcu = (SRcuObj *)handle;
+
+  pthread_mutex_lock(&pRcu->mutex);
+
+  taosRcuWaitForReaders(pRcu);
+  taosRcuFreeRetired(pRcu);
+
+  pthread_mutex_unlock(&pRcu->mutex);
+}
+
+void taosCleanUpRcu(void *handle) {
+  SRcuObj *pRcu = (SRcuObj *)handle;
+  if (pRcu == NULL) return;
+
+  taosRcuSynchronize(pRcu);
+
+  pthread_mutex_destroy(&pRcu->mutex);
+  free(pRcu);
+}
@@ -17,7 +17,15 @@
 #include "tlog.h"
 #include "tsched.h"
 
+#define TAOS_SCHED_SPIN_NUM 128
+
+typedef struct {
+  int64_t   seq;
+  SSchedMsg msg;
+} SSchedCell;
+
 typedef struct {
+  int             type;
   char            label[16];
   tsem_t          emptySem;
   tsem_t          fullSem;
@@ -28,48 +36,159 @@ typedef struct {
   int             numOfThreads;
   pthread_t *     qthread;
   SSchedMsg *     queue;
+
+  // lock free ring, only used by TAOS_SCHED_TYPE_LOCK_FREE
+  SSchedCell *    cells;
+  int64_t         mask;
+  int32_t         stop;
+  char            pad0[64];
+  int64_t         enqueuePos;
+  char            pad1[64];
+  int64_t         dequeuePos;
+  char            pad2[64];
+  int32_t         consumerEvent;  // futex word for the idle worker threads
+  int32_t         idleConsumers;
+  int32_t         producerEvent;  // futex word for the producers waiting for a free cell
+  int32_t         idleProducers;
 } SSchedQueue;
 
 void *taosProcessSchedQueue(void *param);
+void *taosProcessLockFreeSchedQueue(void *param);
 void taosCleanUpScheduler(void *param);
 
-void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
-  pthread_attr_t attr;
-  SSchedQueue *  pSched = (SSchedQueue *)malloc(sizeof(SSchedQueue));
-  if (pSched == NULL) {
-    pError("%s: no enough memory for pSched, reason: %s", label, strerror(errno));
-    goto _error;
-  }
-
-  memset(pSched, 0, sizeof(SSchedQueue));
-  pSched->queueSize = queueSize;
-  strncpy(pSched->label, label, sizeof(pSched->label)); // fix buffer overflow
-  pSched->label[sizeof(pSched->label)-1] = '\0';
-
+static int taosInitMutexQueue(SSchedQueue *pSched) {
   if (pthread_mutex_init(&pSched->queueMutex, NULL) < 0) {
     pError("init %s:queueMutex failed, reason:%s", pSched->label, strerror(errno));
-    goto _error;
+    return -1;
   }
 
   if (tsem_init(&pSched->emptySem, 0, (unsigned int)pSched->queueSize) != 0) {
     pError("init %s:empty semaphore failed, reason:%s", pSched->label, strerror(errno));
-    goto _error;
+    return -1;
   }
 
   if (tsem_init(&pSched->fullSem, 0, 0) != 0) {
     pError("init %s:full semaphore failed, reason:%s", pSched->label, strerror(errno));
-    goto _error;
+    return -1;
   }
 
   if ((pSched->queue = (SSchedMsg *)malloc((size_t)pSched->queueSize * sizeof(SSchedMsg))) == NULL) {
     pError("%s: no enough memory for queue, reason:%s", pSched->label, strerror(errno));
-    goto _error;
+    return -1;
   }
 
   memset(pSched->queue, 0, (size_t)pSched->queueSize * sizeof(SSchedMsg));
   pSched->fullSlot = 0;
   pSched->emptySlot = 0;
 
+  return 0;
+}
+
+static int taosInitLockFreeQueue(SSchedQueue *pSched) {
+  int64_t size = 1;
+  while (size < pSched->queueSize) size <<= 1;
+
+  pSched->cells = (SSchedCell *)malloc((size_t)size * sizeof(SSchedCell));
+  if (pSched->cells == NULL) {
+    pError("%s: no enough memory for cells, reason:%s", pSched->label, strerror(errno));
+    return -1;
+  }
+
+  memset(pSched->cells, 0, (size_t)size * sizeof(SSchedCell));
+  for (int64_t i = 0; i < size; ++i) pSched->cells[i].seq = i;
+
+  pSched->mask = size - 1;
+  pSched->enqueuePos = 0;
+  pSched->dequeuePos = 0;
+
+  return 0;
+}
+
+/*
+ * bounded MPMC ring: a cell can be written when its seq equals to the enqueue position, and it can be read when
+ * its seq equals to the dequeue position plus 1. The position is claimed by CAS, so no lock is required.
+ */
+static bool taosLockFreeEnqueue(SSchedQueue *pSched, SSchedMsg *pMsg) {
+  int64_t pos = atomic_load_64(&pSched->enqueuePos);
+
+  while (1) {
+    SSchedCell *pCell = pSched->cells + (pos & pSched->mask);
+    int64_t     diff = atomic_load_64(&pCell->seq) - pos;
+
+    if (diff == 0) {
+      int64_t cur = atomic_val_compare_exchange_64(&pSched->enqueuePos, pos, pos + 1);
+      if (cur == pos) {
+        pCell->msg = *pMsg;
+        atomic_store_64(&pCell->seq, pos + 1);
+        return true;
+      }
+      pos = cur;
+    } else if (diff < 0) {
+      return false;  // queue is full
+    } else {
+      pos = atomic_load_64(&pSched->enqueuePos);
+    }
+  }
+}
+
+static bool taosLockFreeDequeue(SSchedQueue *pSched, SSchedMsg *pMsg) {
+  int64_t pos = atomic_load_64(&pSched->dequeuePos);
+
+  while (1) {
+    SSchedCell *pCell = pSched->cells + (pos & pSched->mask);
+    int64_t     diff = atomic_load_64(&pCell->seq) - (pos + 1);
+
+    if (diff == 0) {
+      int64_t cur = atomic_val_compare_exchange_64(&pSched->dequeuePos, pos, pos + 1);
+      if (cur == pos) {
+        *pMsg = pCell->msg;
+        atomic_store_64(&pCell->seq, pos + pSched->mask + 1);
+        return true;
+      }
+      pos = cur;
+    } else if (diff < 0) {
+      return false;  // queue is empty
+    } else {
+      pos = atomic_load_64(&pSched->dequeuePos);
+    }
+  }
+}
+
+/*
+ * the waiter registers itself as idle, then checks the queue again before it sleeps on the event. The other side
+ * changes the queue first and then checks the idle counter, so a wakeup can not be lost.
+ */
+static void taosWakeUpIdleThreads(int32_t *event, int32_t *idle, int32_t num) {
+  if (atomic_load_32(idle) > 0) {
+    atomic_add_fetch_32(event, 1);
+    taosFutexWake(event, num);
+  }
+}
+
+void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
+  return taosInitSchedulerWithType(queueSize, numOfThreads, label, TAOS_SCHED_TYPE_MUTEX);
+}
+
+void *taosInitSchedulerWithType(int queueSize, int numOfThreads, const char *label, int type) {
+  pthread_attr_t attr;
+  SSchedQueue *  pSched = (SSchedQueue *)malloc(sizeof(SSchedQueue));
+  if (pSched == NULL) {
+    pError("%s: no enough memory for pSched, reason: %s", label, strerror(errno));
+    goto _error;
+  }
+
+  memset(pSched, 0, sizeof(SSchedQueue));
+  pSched->type = type;
+  pSched->queueSize = queueSize;
+  strncpy(pSched->label, label, sizeof(pSched->label)); // fix buffer overflow
+  pSched->label[sizeof(pSched->label)-1] = '\0';
+
+  if (pSched->type == TAOS_SCHED_TYPE_LOCK_FREE) {
+    if (taosInitLockFreeQueue(pSched) != 0) goto _error;
+  } else {
+    if (taosInitMutexQueue(pSched) != 0) goto _error;
+  }
+
   pSched->qthread = malloc(sizeof(pthread_t) * (size_t)numOfThreads);
   if (pSched->qthread == NULL) {
     pError("%s: no enough memory for qthread, reason: %s", pSched->label, strerror(errno));
@@ -80,14 +199,16 @@ void *taosInitScheduler(int queueSize, int numOfThreads, const char *label) {
   pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 
   for (int i = 0; i < numOfThreads; ++i) {
-    if (pthread_create(pSched->qthread + i, &attr, taosProcessSchedQueue, (void *)pSched) != 0) {
+    void *(*fp)(void *) =
+        (pSched->type == TAOS_SCHED_TYPE_LOCK_FREE) ? taosProcessLockFreeSchedQueue : taosProcessSchedQueue;
+    if (pthread_create(pSched->qthread + i, &attr, fp, (void *)pSched) != 0) {
       pError("%s: failed to create rpc thread, reason:%s", pSched->label, strerror(errno));
       goto _error;
     }
     ++pSched->numOfThreads;
   }
 
-  pTrace("%s scheduler is initialized, numOfThreads:%d", pSched->label, pSched->numOfThreads);
+  pTrace("%s scheduler is initialized, numOfThreads:%d type:%d", pSched->label, pSched->numOfThreads, pSched->type);
 
   return (void *)pSched;
 
@@ -130,6 +251,50 @@ void *taosProcessSchedQueue(void *param) {
   }
 }
 
+void *taosProcessLockFreeSchedQueue(void *param) {
+  SSchedMsg    msg;
+  SSchedQueue *pSched = (SSchedQueue *)param;
+
+  while (!atomic_load_32(&pSched->stop)) {
+    bool found = false;
+    for (int i = 0; i < TAOS_SCHED_SPIN_NUM && !found; ++i) {
+      found = taosLockFreeDequeue(pSched, &msg);
+    }
+
+    if (!found) {
+      int32_t event = atomic_load_32(&pSched->consumerEvent);
+      atomic_add_fetch_32(&pSched->idleConsumers, 1);
+      found = taosLockFreeDequeue(pSched, &msg);
+      if (!found && !atomic_load_32(&pSched->stop)) taosFutexWait(&pSched->consumerEvent, event);
+      atomic_sub_fetch_32(&pSched->idleConsumers, 1);
+      if (!found) continue;
+    }
+
+    taosWakeUpIdleThreads(&pSched->producerEvent, &pSched->idleProducers, 1);
+
+    if (msg.fp)
+      (*(msg.fp))(&msg);
+    else if (msg.tfp)
+      (*(msg.tfp))(msg.ahandle, msg.thandle);
+  }
+
+  return NULL;
+}
+
+static int taosScheduleLockFreeTask(SSchedQueue *pSched, SSchedMsg *pMsg) {
+  while (!taosLockFreeEnqueue(pSched, pMsg)) {
+    int32_t event = atomic_load_32(&pSched->producerEvent);
+    atomic_add_fetch_32(&pSched->idleProducers, 1);
+    bool done = taosLockFreeEnqueue(pSched, pMsg);
+    if (!done) taosFutexWait(&pSched->producerEvent, event);
+    atomic_sub_fetch_32(&pSched->idleProducers, 1);
+    if (done) break;
+  }
+
+  taosWakeUpIdleThreads(&pSched->consumerEvent, &pSched->idleConsumers, 1);
+  return 0;
+}
+
 int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
   SSchedQueue *pSched = (SSchedQueue *)qhandle;
   if (pSched == NULL) {
@@ -137,6 +302,8 @@ int taosScheduleTask(void *qhandle, SSchedMsg *pMsg) {
     return 0;
   }
 
+  if (pSched->type == TAOS_SCHED_TYPE_LOCK_FREE) return taosScheduleLockFreeTask(pSched, pMsg);
+
   while (tsem_wait(&pSched->emptySem) != 0) {
     if (errno != EINTR) {
       pError("wait %s emptySem failed, reason:%s", pSched->label, strerror(errno));
@@ -163,6 +330,21 @@ void taosCleanUpScheduler(void *param) {
   SSchedQueue *pSched = (SSchedQueue *)param;
   if (pSched == NULL) return;
 
+  if (pSched->type == TAOS_SCHED_TYPE_LOCK_FREE) {
+    atomic_store_32(&pSched->stop, 1);
+    atomic_add_fetch_32(&pSched->consumerEvent, 1);
+    taosFutexWake(&pSched->consumerEvent, INT32_MAX);
+
+    for (int i = 0; i < pSched->numOfThreads; ++i) {
+      pthread_join(pSched->qthread[i], NULL);
+    }
+
+    free(pSched->cells);
+    free(pSched->qthread);
+    free(pSched);
+    return;
+  }
+
   for (int i = 0; i < pSched->numOfThreads; ++i) {
     pthread_cancel(pSched->qthread[i]);
   }
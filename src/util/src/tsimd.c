@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tsdb.h"
+#include "tsimd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(_TD_ARM_)
+#define _TD_AVX2_KERNEL_
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+typedef int32_t (*__block_agg_fn_t)(const char *data, int32_t numOfElems, void *result);
+typedef int32_t (*__block_count_fn_t)(const char *data, int32_t numOfElems);
+
+typedef struct SBlockAggFunc {
+  __block_agg_fn_t   sumFn[TSDB_DATA_TYPE_NCHAR + 1];
+  __block_agg_fn_t   minFn[TSDB_DATA_TYPE_NCHAR + 1];
+  __block_agg_fn_t   maxFn[TSDB_DATA_TYPE_NCHAR + 1];
+  __block_count_fn_t countFn[TSDB_DATA_TYPE_NCHAR + 1];
+} SBlockAggFunc;
+
+/*
+ * The scalar version checks null values without branch, so the loops can be vectorized by compiler
+ * with the instruction set of the build.
+ */
+#define SCALAR_SUM_IMPL(name, type, utype, nullVal, sumType)                  \
+  static int32_t name(const char *data, int32_t numOfElems, void *result) {   \
+    const type * pData = (const type *)data;                                  \
+    const utype *pBits = (const utype *)data;                                 \
+    sumType      sum = 0;                                                     \
+    int32_t      notNullElems = 0;                                            \
+    for (int32_t i = 0; i < numOfElems; ++i) {                                \
+      int32_t notNull = (pBits[i] != (utype)(nullVal));                       \
+      sum += notNull ? pData[i] : 0;                                          \
+      notNullElems += notNull;                                                \
+    }                                                                         \
+    *(sumType *)result = sum;                                                 \
+    return notNullElems;                                                      \
+  }
+
+#define SCALAR_MINMAX_IMPL(name, type, utype, nullVal, initVal, op)         \
+  static int32_t name(const char *data, int32_t numOfElems, void *result) { \
+    const type * pData = (const type *)data;                                \
+    const utype *pBits = (const utype *)data;                               \
+    type         val = (initVal);                                           \
+    int32_t      notNullElems = 0;                                          \
+    for (int32_t i = 0; i < numOfElems; ++i) {                              \
+      if (pBits[i] == (utype)(nullVal)) {                                   \
+        continue;                                                           \
+      }                                                                     \
+      if (pData[i] op val) {                                                \
+        val = pData[i];                                                     \
+      }                                                                     \
+      notNullElems += 1;                                                    \
+    }                                                                       \
+    if (notNullElems > 0) {                                                 \
+      *(type *)result = val;                                                \
+    }                                                                       \
+    return notNullElems;                                                    \
+  }
+
+#define SCALAR_COUNT_IMPL(name, utype, nullVal)                \
+  static int32_t name(const char *data, int32_t numOfElems) {  \
+    const utype *pBits = (const utype *)data;                  \
+    int32_t      notNullElems = 0;                             \
+    for (int32_t i = 0; i < numOfElems; ++i) {                 \
+      notNullElems += (pBits[i] != (utype)(nullVal));          \
+    }                                                          \
+    return notNullElems;                                       \
+  }
+
+SCALAR_SUM_IMPL(sumInt8, int8_t, uint8_t, TSDB_DATA_TINYINT_NULL, int64_t)
+SCALAR_SUM_IMPL(sumInt16, int16_t, uint16_t, TSDB_DATA_SMALLINT_NULL, int64_t)
+SCALAR_SUM_IMPL(sumInt32, int32_t, uint32_t, TSDB_DATA_INT_NULL, int64_t)
+SCALAR_SUM_IMPL(sumInt64, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL, int64_t)
+SCALAR_SUM_IMPL(sumFloat, float, uint32_t, TSDB_DATA_FLOAT_NULL, double)
+SCALAR_SUM_IMPL(sumDouble, double, uint64_t, TSDB_DATA_DOUBLE_NULL, double)
+
+SCALAR_MINMAX_IMPL(minInt8, int8_t, uint8_t, TSDB_DATA_TINYINT_NULL, INT8_MAX, <)
+SCALAR_MINMAX_IMPL(minInt16, int16_t, uint16_t, TSDB_DATA_SMALLINT_NULL, INT16_MAX, <)
+SCALAR_MINMAX_IMPL(minInt32, int32_t, uint32_t, TSDB_DATA_INT_NULL, INT32_MAX, <)
+SCALAR_MINMAX_IMPL(minInt64, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL, INT64_MAX, <)
+SCALAR_MINMAX_IMPL(minFloat, float, uint32_t, TSDB_DATA_FLOAT_NULL, INFINITY, <)
+SCALAR_MINMAX_IMPL(minDouble, double, uint64_t, TSDB_DATA_DOUBLE_NULL, INFINITY, <)
+
+SCALAR_MINMAX_IMPL(maxInt8, int8_t, uint8_t, TSDB_DATA_TINYINT_NULL, INT8_MIN, >)
+SCALAR_MINMAX_IMPL(maxInt16, int16_t, uint16_t, TSDB_DATA_SMALLINT_NULL, INT16_MIN, >)
+SCALAR_MINMAX_IMPL(maxInt32, int32_t, uint32_t, TSDB_DATA_INT_NULL, INT32_MIN, >)
+SCALAR_MINMAX_IMPL(maxInt64, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL, INT64_MIN, >)
+SCALAR_MINMAX_IMPL(maxFloat, float, uint32_t, TSDB_DATA_FLOAT_NULL, -INFINITY, >)
+SCALAR_MINMAX_IMPL(maxDouble, double, uint64_t, TSDB_DATA_DOUBLE_NULL, -INFINITY, >)
+
+SCALAR_COUNT_IMPL(countBool, uint8_t, TSDB_DATA_BOOL_NULL)
+SCALAR_COUNT_IMPL(countInt8, uint8_t, TSDB_DATA_TINYINT_NULL)
+SCALAR_COUNT_IMPL(countInt16, uint16_t, TSDB_DATA_SMALLINT_NULL)
+SCALAR_COUNT_IMPL(countInt32, uint32_t, TSDB_DATA_INT_NULL)
+SCALAR_COUNT_IMPL(countInt64, uint64_t, TSDB_DATA_BIGINT_NULL)
+SCALAR_COUNT_IMPL(countFloat, uint32_t, TSDB_DATA_FLOAT_NULL)
+SCALAR_COUNT_IMPL(countDouble, uint64_t, TSDB_DATA_DOUBLE_NULL)
+
+static const SBlockAggFunc scalarAggFunc = {
+    .sumFn = {[TSDB_DATA_TYPE_TINYINT] = sumInt8,
+              [TSDB_DATA_TYPE_SMALLINT] = sumInt16,
+              [TSDB_DATA_TYPE_INT] = sumInt32,
+              [TSDB_DATA_TYPE_BIGINT] = sumInt64,
+              [TSDB_DATA_TYPE_FLOAT] = sumFloat,
+              [TSDB_DATA_TYPE_DOUBLE] = sumDouble},
+    .minFn = {[TSDB_DATA_TYPE_TINYINT] = minInt8,
+              [TSDB_DATA_TYPE_SMALLINT] = minInt16,
+              [TSDB_DATA_TYPE_INT] = minInt32,
+              [TSDB_DATA_TYPE_BIGINT] = minInt64,
+              [TSDB_DATA_TYPE_FLOAT] = minFloat,
+              [TSDB_DATA_TYPE_DOUBLE] = minDouble},
+    .maxFn = {[TSDB_DATA_TYPE_TINYINT] = maxInt8,
+              [TSDB_DATA_TYPE_SMALLINT] = maxInt16,
+              [TSDB_DATA_TYPE_INT] = maxInt32,
+              [TSDB_DATA_TYPE_BIGINT] = maxInt64,
+              [TSDB_DATA_TYPE_FLOAT] = maxFloat,
+              [TSDB_DATA_TYPE_DOUBLE] = maxDouble},
+    .countFn = {[TSDB_DATA_TYPE_BOOL] = countBool,
+                [TSDB_DATA_TYPE_TINYINT] = countInt8,
+                [TSDB_DATA_TYPE_SMALLINT] = countInt16,
+                [TSDB_DATA_TYPE_INT] = countInt32,
+                [TSDB_DATA_TYPE_BIGINT] = countInt64,
+                [TSDB_DATA_TYPE_FLOAT] = countFloat,
+                [TSDB_DATA_TYPE_DOUBLE] = countDouble,
+                [TSDB_DATA_TYPE_TIMESTAMP] = countInt64},
+};
+
+typedef void (*__bit_unpack_fn_t)(const char *input, int32_t width, int32_t numOfElems, uint64_t *output);
+
+// read the width bits starting from bitOffset, byte by byte, without touching any byte beyond them
+static uint64_t readPackedBits(const uint8_t *input, uint64_t bitOffset, int32_t width) {
+  uint64_t val = 0;
+  int32_t  got = 0;
+
+  while (got < width) {
+    int32_t shift = bitOffset & 7;
+    int32_t take = MIN(8 - shift, width - got);
+
+    val |= (uint64_t)((input[bitOffset >> 3] >> shift) & ((1u << take) - 1)) << got;
+    got += take;
+    bitOffset += take;
+  }
+
+  return val;
+}
+
+static void bitUnpackRange(const char *input, int32_t width, int32_t start, int32_t numOfElems, uint64_t *output) {
+  const uint8_t *p = (const uint8_t *)input;
+  uint64_t       packedBytes = ((uint64_t)numOfElems * width + 7) >> 3;
+  uint64_t       mask = (width == 64) ? UINT64_MAX : (((uint64_t)1 << width) - 1);
+
+  for (int32_t i = start; i < numOfElems; ++i) {
+    uint64_t bitOffset = (uint64_t)i * width;
+    uint64_t byteOffset = bitOffset >> 3;
+
+    // load the 8 bytes covering the value at once, if they are all within the packed data
+    if (width <= 57 && byteOffset + 8 <= packedBytes) {
+      uint64_t val = 0;
+      memcpy(&val, p + byteOffset, sizeof(val));
+      output[i] = (val >> (bitOffset & 7)) & mask;
+    } else {
+      output[i] = readPackedBits(p, bitOffset, width);
+    }
+  }
+}
+
+static void bitUnpackScalar(const char *input, int32_t width, int32_t numOfElems, uint64_t *output) {
+  if (width == 0) {
+    memset(output, 0, sizeof(uint64_t) * numOfElems);
+    return;
+  }
+
+  bitUnpackRange(input, width, 0, numOfElems, output);
+}
+
+#ifdef _TD_AVX2_KERNEL_
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// number of null elements in one vector, according to the mask generated by the compare on each element
+#define NULL_ELEMS_IN_MASK(mask, bytes) (__builtin_popcount((uint32_t)_mm256_movemask_epi8(mask)) / (bytes))
+
+/*
+ * The null value of tinyint is -128, which becomes 0 after flipping the sign bit, while other values
+ * v become v + 128. So the sum of absolute differences against zero is used to widen and add 32 values.
+ */
+AVX2_TARGET static int32_t sumInt8Avx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i signBit = _mm256_set1_epi8((char)0x80);
+  const __m256i zero = _mm256_setzero_si256();
+
+  __m256i acc = zero;
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 32 <= numOfElems; i += 32) {
+    __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(data + i)), signBit);
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+    numOfNull += NULL_ELEMS_IN_MASK(_mm256_cmpeq_epi8(v, zero), 1);
+  }
+
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+
+  int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3] - 128 * (int64_t)(i - numOfNull);
+  int64_t tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumInt8(data + i, numOfElems - i, &tail);
+
+  *(int64_t *)result = sum + tail;
+  return notNullElems;
+}
+
+AVX2_TARGET static int32_t sumInt16Avx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i nullVal = _mm256_set1_epi16((int16_t)TSDB_DATA_SMALLINT_NULL);
+  const __m256i one = _mm256_set1_epi16(1);
+
+  __m256i acc = _mm256_setzero_si256();
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 16 <= numOfElems; i += 16) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(int16_t)));
+    __m256i mask = _mm256_cmpeq_epi16(v, nullVal);
+
+    // add the adjacent values into 32 bits, then widen to 64 bits
+    __m256i s = _mm256_madd_epi16(_mm256_andnot_si256(mask, v), one);
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(s)));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(s, 1)));
+    numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(int16_t));
+  }
+
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+
+  int64_t tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumInt16(data + i * sizeof(int16_t), numOfElems - i, &tail);
+
+  *(int64_t *)result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+  return notNullElems;
+}
+
+AVX2_TARGET static int32_t sumInt32Avx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i nullVal = _mm256_set1_epi32((int32_t)TSDB_DATA_INT_NULL);
+
+  __m256i acc = _mm256_setzero_si256();
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 8 <= numOfElems; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(int32_t)));
+    __m256i mask = _mm256_cmpeq_epi32(v, nullVal);
+
+    v = _mm256_andnot_si256(mask, v);
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(int32_t));
+  }
+
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+
+  int64_t tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumInt32(data + i * sizeof(int32_t), numOfElems - i, &tail);
+
+  *(int64_t *)result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+  return notNullElems;
+}
+
+AVX2_TARGET static int32_t sumInt64Avx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i nullVal = _mm256_set1_epi64x((int64_t)TSDB_DATA_BIGINT_NULL);
+
+  __m256i acc = _mm256_setzero_si256();
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 4 <= numOfElems; i += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(int64_t)));
+    __m256i mask = _mm256_cmpeq_epi64(v, nullVal);
+
+    acc = _mm256_add_epi64(acc, _mm256_andnot_si256(mask, v));
+    numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(int64_t));
+  }
+
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, acc);
+
+  int64_t tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumInt64(data + i * sizeof(int64_t), numOfElems - i, &tail);
+
+  *(int64_t *)result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+  return notNullElems;
+}
+
+AVX2_TARGET static int32_t sumFloatAvx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i nullVal = _mm256_set1_epi32((int32_t)TSDB_DATA_FLOAT_NULL);
+
+  __m256d acc = _mm256_setzero_pd();
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 8 <= numOfElems; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(float)));
+    __m256i mask = _mm256_cmpeq_epi32(v, nullVal);
+    __m256  f = _mm256_castsi256_ps(_mm256_andnot_si256(mask, v));
+
+    // float values are summed in double, the same as the sum function
+    acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+    acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+    numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(float));
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+
+  double  tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumFloat(data + i * sizeof(float), numOfElems - i, &tail);
+
+  *(double *)result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+  return notNullElems;
+}
+
+AVX2_TARGET static int32_t sumDoubleAvx2(const char *data, int32_t numOfElems, void *result) {
+  const __m256i nullVal = _mm256_set1_epi64x((int64_t)TSDB_DATA_DOUBLE_NULL);
+
+  __m256d acc = _mm256_setzero_pd();
+  int32_t numOfNull = 0;
+  int32_t i = 0;
+
+  for (; i + 4 <= numOfElems; i += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(double)));
+    __m256i mask = _mm256_cmpeq_epi64(v, nullVal);
+
+    acc = _mm256_add_pd(acc, _mm256_castsi256_pd(_mm256_andnot_si256(mask, v)));
+    numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(double));
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+
+  double  tail = 0;
+  int32_t notNullElems = (i - numOfNull) + sumDouble(data + i * sizeof(double), numOfElems - i, &tail);
+
+  *(double *)result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail;
+  return notNullElems;
+}
+
+/*
+ * null values are replaced by the initial value before compared, and the remain elements that can not fill
+ * a vector are handled by the scalar version.
+ */
+#define AVX2_MINMAX_REDUCE(type, acc, val, op, scalarFn)                                   \
+  do {                                                                                     \
+    type lanes[sizeof(__m256i) / sizeof(type)];                                            \
+    _mm256_storeu_si256((__m256i *)lanes, (acc));                                          \
+    for (int32_t k = 0; k < (int32_t)(sizeof(__m256i) / sizeof(type)); ++k) {                         \
+      if (lanes[k] op(val)) {                                                              \
+        (val) = lanes[k];                                                                  \
+      }                                                                                    \
+    }                                                                                      \
+    type    tailVal = (val);                                                               \
+    int32_t tailElems = scalarFn(data + i * sizeof(type), numOfElems - i, &tailVal);       \
+    if (tailElems > 0 && tailVal op(val)) {                                                \
+      (val) = tailVal;                                                                     \
+    }                                                                                      \
+    notNullElems = (i - numOfNull) + tailElems;                                            \
+  } while (0)
+
+#define AVX2_INT_MINMAX_IMPL(name, type, bits, nullVal, initVal, func, op, scalarFn)      \
+  AVX2_TARGET static int32_t name(const char *data, int32_t numOfElems, void *result) {   \
+    const int32_t numOfLanes = sizeof(__m256i) / sizeof(type);                            \
+    const __m256i nullv = _mm256_set1_epi##bits((type)(nullVal));                         \
+    const __m256i init = _mm256_set1_epi##bits(initVal);                                  \
+    __m256i       acc = init;                                                             \
+    int32_t       numOfNull = 0;                                                          \
+    int32_t       notNullElems = 0;                                                       \
+    int32_t       i = 0;                                                                  \
+    for (; i + numOfLanes <= numOfElems; i += numOfLanes) {                               \
+      __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(type)));         \
+      __m256i mask = _mm256_cmpeq_epi##bits(v, nullv);                                    \
+      acc = _mm256_##func##_epi##bits(acc, _mm256_blendv_epi8(v, init, mask));            \
+      numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(type));                                \
+    }                                                                                     \
+    type val = (initVal);                                                                 \
+    AVX2_MINMAX_REDUCE(type, acc, val, op, scalarFn);                                     \
+    if (notNullElems > 0) {                                                               \
+      *(type *)result = val;                                                              \
+    }                                                                                     \
+    return notNullElems;                                                                  \
+  }
+
+AVX2_INT_MINMAX_IMPL(minInt8Avx2, int8_t, 8, TSDB_DATA_TINYINT_NULL, INT8_MAX, min, <, minInt8)
+AVX2_INT_MINMAX_IMPL(minInt16Avx2, int16_t, 16, TSDB_DATA_SMALLINT_NULL, INT16_MAX, min, <, minInt16)
+AVX2_INT_MINMAX_IMPL(minInt32Avx2, int32_t, 32, TSDB_DATA_INT_NULL, INT32_MAX, min, <, minInt32)
+AVX2_INT_MINMAX_IMPL(maxInt8Avx2, int8_t, 8, TSDB_DATA_TINYINT_NULL, INT8_MIN, max, >, maxInt8)
+AVX2_INT_MINMAX_IMPL(maxInt16Avx2, int16_t, 16, TSDB_DATA_SMALLINT_NULL, INT16_MIN, max, >, maxInt16)
+AVX2_INT_MINMAX_IMPL(maxInt32Avx2, int32_t, 32, TSDB_DATA_INT_NULL, INT32_MIN, max, >, maxInt32)
+
+// there is no 64 bits min/max instruction in AVX2, so compare and blend instead
+#define AVX2_INT64_MINMAX_IMPL(name, initVal, isMin, op, scalarFn)                                 \
+  AVX2_TARGET static int32_t name(const char *data, int32_t numOfElems, void *result) {            \
+    const __m256i nullv = _mm256_set1_epi64x((int64_t)TSDB_DATA_BIGINT_NULL);                      \
+    const __m256i init = _mm256_set1_epi64x(initVal);                                              \
+    __m256i       acc = init;                                                                      \
+    int32_t       numOfNull = 0;                                                                   \
+    int32_t       notNullElems = 0;                                                                \
+    int32_t       i = 0;                                                                           \
+    for (; i + 4 <= numOfElems; i += 4) {                                                          \
+      __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(int64_t)));               \
+      __m256i mask = _mm256_cmpeq_epi64(v, nullv);                                                 \
+      v = _mm256_blendv_epi8(v, init, mask);                                                       \
+      __m256i gt = (isMin) ? _mm256_cmpgt_epi64(acc, v) : _mm256_cmpgt_epi64(v, acc);              \
+      acc = _mm256_blendv_epi8(acc, v, gt);                                                        \
+      numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(int64_t));                                      \
+    }                                                                                              \
+    int64_t val = (initVal);                                                                       \
+    AVX2_MINMAX_REDUCE(int64_t, acc, val, op, scalarFn);                                           \
+    if (notNullElems > 0) {                                                                        \
+      *(int64_t *)result = val;                                                                    \
+    }                                                                                              \
+    return notNullElems;                                                                           \
+  }
+
+AVX2_INT64_MINMAX_IMPL(minInt64Avx2, INT64_MAX, 1, <, minInt64)
+AVX2_INT64_MINMAX_IMPL(maxInt64Avx2, INT64_MIN, 0, >, maxInt64)
+
+/*
+ * min/max_ps/pd return the second operand if either one is NaN, so the running value is passed as the second
+ * operand to keep it, the same as the scalar version which never takes a NaN
+ */
+#define AVX2_FLOAT_MINMAX_IMPL(name, type, bits, nullVal, initVal, set1, func, op, scalarFn)     \
+  AVX2_TARGET static int32_t name(const char *data, int32_t numOfElems, void *result) {          \
+    const int32_t numOfLanes = sizeof(__m256i) / sizeof(type);                                   \
+    const __m256i nullv = SET1_EPI##bits(nullVal);                                    \
+    const __m256i init = set1(initVal);                                                          \
+    __m256i       acc = init;                                                                    \
+    int32_t       numOfNull = 0;                                                                 \
+    int32_t       notNullElems = 0;                                                              \
+    int32_t       i = 0;                                                                         \
+    for (; i + numOfLanes <= numOfElems; i += numOfLanes) {                                      \
+      __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * sizeof(type)));                \
+      __m256i mask = _mm256_cmpeq_epi##bits(v, nullv);                                           \
+      acc = func(_mm256_blendv_epi8(v, init, mask), acc);                                        \
+      numOfNull += NULL_ELEMS_IN_MASK(mask, sizeof(type));                                       \
+    }                                                                                            \
+    type val = (initVal);                                                                        \
+    AVX2_MINMAX_REDUCE(type, acc, val, op, scalarFn);                                            \
+    if (notNullElems > 0) {                                                                      \
+      *(type *)result = val;                                                                     \
+    }                                                                                            \
+    return notNullElems;                                                                         \
+  }
+
+#define SET1_EPI32(v) _mm256_set1_epi32((int32_t)(v))
+#define SET1_EPI64(v) _mm256_set1_epi64x((int64_t)(v))
+#define SET1_PS(v) _mm256_castps_si256(_mm256_set1_ps(v))
+#define SET1_PD(v) _mm256_castpd_si256(_mm256_set1_pd(v))
+
+#define MIN_PS(a, b) _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)))
+#define MAX_PS(a, b) _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)))
+#define MIN_PD(a, b) _mm256_castpd_si256(_mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)))
+#define MAX_PD(a, b) _mm256_castpd_si256(_mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)))
+
+AVX2_FLOAT_MINMAX_IMPL(minFloatAvx2, float, 32, TSDB_DATA_FLOAT_NULL, INFINITY, SET1_PS, MIN_PS, <, minFloat)
+AVX2_FLOAT_MINMAX_IMPL(maxFloatAvx2, float, 32, TSDB_DATA_FLOAT_NULL, -INFINITY, SET1_PS, MAX_PS, >, maxFloat)
+AVX2_FLOAT_MINMAX_IMPL(minDoubleAvx2, double, 64, TSDB_DATA_DOUBLE_NULL, INFINITY, SET1_PD, MIN_PD, <, minDouble)
+AVX2_FLOAT_MINMAX_IMPL(maxDoubleAvx2, double, 64, TSDB_DATA_DOUBLE_NULL, -INFINITY, SET1_PD, MAX_PD, >, maxDouble)
+
+#define AVX2_COUNT_IMPL(name, bits, nullVal, set1, scalarFn)                                 \
+  AVX2_TARGET static int32_t name(const char *data, int32_t numOfElems) {                    \
+    const int32_t numOfLanes = sizeof(__m256i) * 8 / (bits);                                 \
+    const __m256i nullv = set1(nullVal);                                                     \
+    int32_t       numOfNull = 0;                                                             \
+    int32_t       i = 0;                                                                     \
+    for (; i + numOfLanes <= numOfElems; i += numOfLanes) {                                  \
+      __m256i v = _mm256_loadu_si256((const __m256i *)(data + i * ((bits) / 8)));            \
+      numOfNull += NULL_ELEMS_IN_MASK(_mm256_cmpeq_epi##bits(v, nullv), (bits) / 8);         \
+    }                                                                                        \
+    return (i - numOfNull) + scalarFn(data + i * ((bits) / 8), numOfElems - i);              \
+  }
+
+AVX2_COUNT_IMPL(countBoolAvx2, 8, (char)TSDB_DATA_BOOL_NULL, _mm256_set1_epi8, countBool)
+AVX2_COUNT_IMPL(countInt8Avx2, 8, (char)TSDB_DATA_TINYINT_NULL, _mm256_set1_epi8, countInt8)
+AVX2_COUNT_IMPL(countInt16Avx2, 16, (int16_t)TSDB_DATA_SMALLINT_NULL, _mm256_set1_epi16, countInt16)
+AVX2_COUNT_IMPL(countInt32Avx2, 32, (int32_t)TSDB_DATA_INT_NULL, _mm256_set1_epi32, countInt32)
+AVX2_COUNT_IMPL(countInt64Avx2, 64, (int64_t)TSDB_DATA_BIGINT_NULL, _mm256_set1_epi64x, countInt64)
+AVX2_COUNT_IMPL(countFloatAvx2, 32, (int32_t)TSDB_DATA_FLOAT_NULL, _mm256_set1_epi32, countFloat)
+AVX2_COUNT_IMPL(countDoubleAvx2, 64, (int64_t)TSDB_DATA_DOUBLE_NULL, _mm256_set1_epi64x, countDouble)
+
+/*
+ * Four values are unpacked at a time, by gathering the 8 bytes that cover each of them and shifting
+ * them by their own bit offset. Values wider than 57 bits may span 9 bytes, so they are left to the
+ * scalar version.
+ */
+AVX2_TARGET static void bitUnpackAvx2(const char *input, int32_t width, int32_t numOfElems, uint64_t *output) {
+  if (width == 0 || width > 57) {
+    bitUnpackScalar(input, width, numOfElems, output);
+    return;
+  }
+
+  const __m256i mask = _mm256_set1_epi64x((int64_t)(((uint64_t)1 << width) - 1));
+  const __m256i seven = _mm256_set1_epi64x(7);
+  const __m256i step = _mm256_set1_epi64x(4 * (int64_t)width);
+
+  __m256i  offset = _mm256_set_epi64x(3 * (int64_t)width, 2 * (int64_t)width, width, 0);
+  uint64_t packedBytes = ((uint64_t)numOfElems * width + 7) >> 3;
+
+  int32_t i = 0;
+  for (; i + 4 <= numOfElems && ((((uint64_t)i + 3) * width) >> 3) + 8 <= packedBytes; i += 4) {
+    __m256i val = _mm256_i64gather_epi64((const long long *)input, _mm256_srli_epi64(offset, 3), 1);
+    val = _mm256_srlv_epi64(val, _mm256_and_si256(offset, seven));
+    _mm256_storeu_si256((__m256i *)(output + i), _mm256_and_si256(val, mask));
+
+    offset = _mm256_add_epi64(offset, step);
+  }
+
+  bitUnpackRange(input, width, i, numOfElems, output);
+}
+
+static const SBlockAggFunc avx2AggFunc = {
+    .sumFn = {[TSDB_DATA_TYPE_TINYINT] = sumInt8Avx2,
+              [TSDB_DATA_TYPE_SMALLINT] = sumInt16Avx2,
+              [TSDB_DATA_TYPE_INT] = sumInt32Avx2,
+              [TSDB_DATA_TYPE_BIGINT] = sumInt64Avx2,
+              [TSDB_DATA_TYPE_FLOAT] = sumFloatAvx2,
+              [TSDB_DATA_TYPE_DOUBLE] = sumDoubleAvx2},
+    .minFn = {[TSDB_DATA_TYPE_TINYINT] = minInt8Avx2,
+              [TSDB_DATA_TYPE_SMALLINT] = minInt16Avx2,
+              [TSDB_DATA_TYPE_INT] = minInt32Avx2,
+              [TSDB_DATA_TYPE_BIGINT] = minInt64Avx2,
+              [TSDB_DATA_TYPE_FLOAT] = minFloatAvx2,
+              [TSDB_DATA_TYPE_DOUBLE] = minDoubleAvx2},
+    .maxFn = {[TSDB_DATA_TYPE_TINYINT] = maxInt8Avx2,
+              [TSDB_DATA_TYPE_SMALLINT] = maxInt16Avx2,
+              [TSDB_DATA_TYPE_INT] = maxInt32Avx2,
+              [TSDB_DATA_TYPE_BIGINT] = maxInt64Avx2,
+              [TSDB_DATA_TYPE_FLOAT] = maxFloatAvx2,
+              [TSDB_DATA_TYPE_DOUBLE] = maxDoubleAvx2},
+    .countFn = {[TSDB_DATA_TYPE_BOOL] = countBoolAvx2,
+                [TSDB_DATA_TYPE_TINYINT] = countInt8Avx2,
+                [TSDB_DATA_TYPE_SMALLINT] = countInt16Avx2,
+                [TSDB_DATA_TYPE_INT] = countInt32Avx2,
+                [TSDB_DATA_TYPE_BIGINT] = countInt64Avx2,
+                [TSDB_DATA_TYPE_FLOAT] = countFloatAvx2,
+                [TSDB_DATA_TYPE_DOUBLE] = countDoubleAvx2,
+                [TSDB_DATA_TYPE_TIMESTAMP] = countInt64Avx2},
+};
+
+// AVX2 is available only if the OS saves the YMM registers during context switch
+static bool taosSupportAVX2() {
+  uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+    return false;
+  }
+
+  uint32_t xcr0 = 0, xcr0High = 0;
+  __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+  if ((xcr0 & 6) != 6) {
+    return false;
+  }
+
+  if (__get_cpuid_max(0, NULL) < 7) {
+    return false;
+  }
+
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx & bit_AVX2) != 0;
+}
+
+#endif  // _TD_AVX2_KERNEL_
+
+static const SBlockAggFunc *pAggFunc = &scalarAggFunc;
+static __bit_unpack_fn_t    bitUnpackFn = bitUnpackScalar;
+
+void taosResolveSIMD() {
+#ifdef _TD_AVX2_KERNEL_
+  bool avx2 = taosSupportAVX2();
+  pAggFunc = avx2 ? &avx2AggFunc : &scalarAggFunc;
+  bitUnpackFn = avx2 ? bitUnpackAvx2 : bitUnpackScalar;
+#else
+  pAggFunc = &scalarAggFunc;
+  bitUnpackFn = bitUnpackScalar;
+#endif
+}
+
+int32_t taosSumBlock(const char *data, int32_t numOfElems, int32_t type, void *sum) {
+  assert(type >= TSDB_DATA_TYPE_TINYINT && type <= TSDB_DATA_TYPE_DOUBLE);
+  return pAggFunc->sumFn[type](data, numOfElems, sum);
+}
+
+int32_t taosMinBlock(const char *data, int32_t numOfElems, int32_t type, void *min) {
+  assert(type >= TSDB_DATA_TYPE_TINYINT && type <= TSDB_DATA_TYPE_DOUBLE);
+  return pAggFunc->minFn[type](data, numOfElems, min);
+}
+
+int32_t taosMaxBlock(const char *data, int32_t numOfElems, int32_t type, void *max) {
+  assert(type >= TSDB_DATA_TYPE_TINYINT && type <= TSDB_DATA_TYPE_DOUBLE);
+  return pAggFunc->maxFn[type](data, numOfElems, max);
+}
+
+int32_t taosCountNotNullBlock(const char *data, int32_t numOfElems, int32_t type) {
+  if (type < 0 || type > TSDB_DATA_TYPE_NCHAR || pAggFunc->countFn[type] == NULL) {
+    return -1;
+  }
+
+  return pAggFunc->countFn[type](data, numOfElems);
+}
+
+void taosBitUnpack64(const char *input, int32_t width, int32_t numOfElems, uint64_t *output) {
+  assert(width >= 0 && width <= 64);
+  bitUnpackFn(input, width, numOfElems, output);
+}
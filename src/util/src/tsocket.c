@@ -154,6 +154,36 @@ int taosWriteMsg(int fd, void *buf, int nbytes) {
   return (nbytes - nleft);
 }
 
+int taosWriteMsgV(int fd, struct iovec *iov, int iovcnt) {
+  int nbytes = 0, nwritten;
+
+  while (iovcnt > 0) {
+    nwritten = (int)taosWriteSocketV(fd, iov, iovcnt);
+    if (nwritten <= 0) {
+      if (errno == EINTR)
+        continue;
+      else
+        return -1;
+    }
+
+    nbytes += nwritten;
+
+    // skip the buffers that are completely written
+    while (iovcnt > 0 && (size_t)nwritten >= iov->iov_len) {
+      nwritten -= (int)iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+
+    if (iovcnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + nwritten;
+      iov->iov_len -= nwritten;
+    }
+  }
+
+  return nbytes;
+}
+
 int taosReadMsg(int fd, void *buf, int nbytes) {
   int   nleft, nread;
   char *ptr = (char *)buf;
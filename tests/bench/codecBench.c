@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// compression ratio and speed of comp 1/2/3 for the timestamp, integer, float and double codecs, on blocks of
+// data generated like taosdemo does, and on slowly changing sensor-like values.
+// The blocks are decompressed and compared with the input first, and so are blocks of a few odd sizes around
+// the 128 values miniblock of the bit-packed integers. The bit unpacking of comp 3 uses the AVX2 kernel if the CPU
+// supports it, -scalar keeps the scalar one.
+// to compile: make, and run: ./codecBench [-rows 4096] [-blocks 256] [-rounds 5] [-scalar]
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tscompression.h"
+#include "tsdb.h"
+#include "tsimd.h"
+
+#define BENCH_EXTRA_BYTES 2  // see EXTRA_BYTES in vnodeUtil.h
+
+typedef int (*__compress_fn_t)(const char *const input, int inputSize, const int nelements, char *const output,
+                               int outputSize, char algorithm, char *const buffer, int bufferSize);
+
+typedef struct {
+  const char *    name;
+  int             bytes;
+  __compress_fn_t compFp;
+  __compress_fn_t decompFp;
+  void (*genFp)(char *data, int rows, int64_t blockId);
+} SCodecData;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// taosdemo writes one row per millisecond
+static void genTsDemo(char *data, int rows, int64_t blockId) {
+  int64_t *p = (int64_t *)data;
+  int64_t  start = 1500000000000L + blockId * rows;
+  for (int i = 0; i < rows; ++i) p[i] = start + i;
+}
+
+// one row per second, with a jitter of up to 10ms
+static void genTsJitter(char *data, int rows, int64_t blockId) {
+  int64_t *p = (int64_t *)data;
+  int64_t  start = 1500000000000L + blockId * rows * 1000L;
+  for (int i = 0; i < rows; ++i) p[i] = start + i * 1000L + rand() % 10;
+}
+
+static void genFloatDemo(char *data, int rows, int64_t blockId) {
+  float *p = (float *)data;
+  for (int i = 0; i < rows; ++i) p[i] = (float)(rand() / 1000);
+}
+
+static void genDoubleDemo(char *data, int rows, int64_t blockId) {
+  double *p = (double *)data;
+  for (int i = 0; i < rows; ++i) p[i] = (double)(rand() / 1000000);
+}
+
+// a random walk of 0.01 steps around 20, kept in two decimals
+static void genFloatSensor(char *data, int rows, int64_t blockId) {
+  float *p = (float *)data;
+  int    v = 2000;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 3 - 1;
+    p[i] = v / 100.0f;
+  }
+}
+
+static void genDoubleSensor(char *data, int rows, int64_t blockId) {
+  double *p = (double *)data;
+  int     v = 2000;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 3 - 1;
+    p[i] = v / 100.0;
+  }
+}
+
+// a random walk in a small range, as the readings of a sensor stored in tinyint
+static void genTinyintSensor(char *data, int rows, int64_t blockId) {
+  int8_t *p = (int8_t *)data;
+  int     v = 20;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 3 - 1;
+    if (v > 100 || v < -100) v = 20;
+    p[i] = (int8_t)v;
+  }
+}
+
+static void genSmallintSensor(char *data, int rows, int64_t blockId) {
+  int16_t *p = (int16_t *)data;
+  int      v = 2000;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 21 - 10;
+    p[i] = (int16_t)v;
+  }
+}
+
+// taosdemo writes random values in [0, 10)
+static void genIntDemo(char *data, int rows, int64_t blockId) {
+  int32_t *p = (int32_t *)data;
+  for (int i = 0; i < rows; ++i) p[i] = rand() % 10;
+}
+
+static void genIntSensor(char *data, int rows, int64_t blockId) {
+  int32_t *p = (int32_t *)data;
+  int32_t  v = 100000;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 201 - 100;
+    p[i] = v;
+  }
+}
+
+// a meter counter, which increases by a varying amount
+static void genBigintCounter(char *data, int rows, int64_t blockId) {
+  int64_t *p = (int64_t *)data;
+  int64_t  v = blockId * rows * 1000L;
+  for (int i = 0; i < rows; ++i) {
+    v += rand() % 1000;
+    p[i] = v;
+  }
+}
+
+// values of the full 64 bits range, so the deltas need all the bits and wrap around
+static void genBigintRandom(char *data, int rows, int64_t blockId) {
+  int64_t *p = (int64_t *)data;
+  for (int i = 0; i < rows; ++i) {
+    p[i] = (int64_t)(((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand());
+  }
+}
+
+static SCodecData codecData[] = {
+    {"ts(demo)", 8, tsCompressTimestamp, tsDecompressTimestamp, genTsDemo},
+    {"ts(jitter)", 8, tsCompressTimestamp, tsDecompressTimestamp, genTsJitter},
+    {"float(demo)", 4, tsCompressFloat, tsDecompressFloat, genFloatDemo},
+    {"float(sensor)", 4, tsCompressFloat, tsDecompressFloat, genFloatSensor},
+    {"double(demo)", 8, tsCompressDouble, tsDecompressDouble, genDoubleDemo},
+    {"double(sensor)", 8, tsCompressDouble, tsDecompressDouble, genDoubleSensor},
+    {"tinyint(sensor)", 1, tsCompressTinyint, tsDecompressTinyint, genTinyintSensor},
+    {"smallint(sensor)", 2, tsCompressSmallint, tsDecompressSmallint, genSmallintSensor},
+    {"int(demo)", 4, tsCompressInt, tsDecompressInt, genIntDemo},
+    {"int(sensor)", 4, tsCompressInt, tsDecompressInt, genIntSensor},
+    {"bigint(counter)", 8, tsCompressBigint, tsDecompressBigint, genBigintCounter},
+    {"bigint(random)", 8, tsCompressBigint, tsDecompressBigint, genBigintRandom},
+};
+
+// compress and decompress a block of the given rows, and compare the result with the input
+static bool checkRoundTrip(SCodecData *pData, int rows, int algorithm, char *input, char *output, char *result,
+                           char *buffer, int maxSize) {
+  int rawSize = rows * pData->bytes;
+  pData->genFp(input, rows, 0);
+
+  int compSize = pData->compFp(input, rawSize, rows, output, maxSize, algorithm, buffer, maxSize);
+  int size = pData->decompFp(output, compSize, rows, result, maxSize, algorithm, buffer, maxSize);
+
+  return size == rawSize && memcmp(input, result, rawSize) == 0;
+}
+
+int main(int argc, char *argv[]) {
+  int rows = 4096;
+  int blocks = 256;
+  int  rounds = 5;
+  bool scalar = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-rows") == 0) {
+      rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-blocks") == 0) {
+      blocks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rounds") == 0) {
+      rounds = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-scalar") == 0) {
+      scalar = true;
+    }
+  }
+
+  // the scalar kernels are used until the SIMD ones are resolved
+  if (!scalar) taosResolveSIMD();
+
+  int   maxSize = rows * sizeof(int64_t) + BENCH_EXTRA_BYTES;
+  char *input = malloc((size_t)maxSize * blocks);
+  char *output = malloc((size_t)maxSize * blocks);
+  char *result = malloc(maxSize);
+  char *buffer = malloc(maxSize);
+  int * compSize = malloc(sizeof(int) * blocks);
+
+  printf("%d blocks of %d rows, compress/decompress speed in MB/s of raw data, %s bit unpacking\n", blocks, rows,
+         scalar ? "scalar" : "resolved");
+
+  for (int d = 0; d < sizeof(codecData) / sizeof(codecData[0]); ++d) {
+    SCodecData *pData = &codecData[d];
+    int         rawSize = rows * pData->bytes;
+
+    srand(d);
+    for (int b = 0; b < blocks; ++b) pData->genFp(input + (size_t)b * maxSize, rows, b);
+
+    for (int algorithm = ONE_STAGE_COMP; algorithm <= BIT_LEVEL_COMP; ++algorithm) {
+      int64_t total = 0;
+      bool    match = true;
+
+      int oddRows[] = {1, 2, 127, 128, 129, 255, 257, rows - 1};
+      for (int i = 0; i < sizeof(oddRows) / sizeof(oddRows[0]); ++i) {
+        if (oddRows[i] <= 0 || oddRows[i] > rows) continue;
+        if (!checkRoundTrip(pData, oddRows[i], algorithm, input, output, result, buffer, maxSize)) {
+          printf("%-16s comp %d  MISMATCH of %d rows\n", pData->name, algorithm, oddRows[i]);
+        }
+      }
+
+      for (int b = 0; b < blocks; ++b) {
+        char *in = input + (size_t)b * maxSize;
+        char *out = output + (size_t)b * maxSize;
+        compSize[b] = pData->compFp(in, rawSize, rows, out, maxSize, algorithm, buffer, maxSize);
+        total += compSize[b];
+
+        pData->decompFp(out, compSize[b], rows, result, maxSize, algorithm, buffer, maxSize);
+        if (memcmp(in, result, rawSize) != 0) match = false;
+      }
+
+      int64_t st = benchGetNanoTime();
+      for (int r = 0; r < rounds; ++r) {
+        for (int b = 0; b < blocks; ++b) {
+          pData->compFp(input + (size_t)b * maxSize, rawSize, rows, output + (size_t)b * maxSize, maxSize, algorithm,
+                        buffer, maxSize);
+        }
+      }
+      int64_t compTime = benchGetNanoTime() - st;
+
+      st = benchGetNanoTime();
+      for (int r = 0; r < rounds; ++r) {
+        for (int b = 0; b < blocks; ++b) {
+          pData->decompFp(output + (size_t)b * maxSize, compSize[b], rows, result, maxSize, algorithm, buffer, maxSize);
+        }
+      }
+      int64_t decompTime = benchGetNanoTime() - st;
+
+      double mb = (double)rawSize * blocks * rounds / (1024 * 1024);
+      printf("%-16s comp %d  ratio:%6.2f%%  compress:%8.1f  decompress:%8.1f%s\n", pData->name, algorithm,
+             total * 100.0 / ((double)rawSize * blocks), mb * 1e9 / compTime, mb * 1e9 / decompTime,
+             match ? "" : "  MISMATCH");
+    }
+  }
+
+  free(compSize);
+  free(buffer);
+  free(result);
+  free(output);
+  free(input);
+  return 0;
+}
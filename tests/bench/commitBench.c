@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// throughput of the commit of a vnode: the blocks of every meter are copied out of the cache, compressed column by
+// column, and appended to the data file in meter order, as vnodeCommitMultiToFile does. With commit threads, the
+// blocks are compressed on a scheduler while the commit thread copies the next ones, and written in order once
+// compressed; with 0 threads every block is compressed by the commit thread itself.
+// to compile: make, and run: ./commitBench [-meters 200] [-rows 4096] [-comp 2] [-threads 8] [-rounds 3]
+// [-file ./commitBench.data]
+
+#include <fcntl.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tsched.h"
+#include "tscompression.h"
+#include "tsdb.h"
+
+#define BENCH_EXTRA_BYTES 2  // see EXTRA_BYTES in vnodeUtil.h
+#define BENCH_COLS 5
+
+typedef int (*__compress_fn_t)(const char *const input, int inputSize, const int nelements, char *const output,
+                               int outputSize, char algorithm, char *const buffer, int bufferSize);
+
+// the schema of taosdemo with a double column: ts, int, int, float, double
+static const int             colBytes[BENCH_COLS] = {8, 4, 4, 4, 8};
+static const __compress_fn_t colCompFp[BENCH_COLS] = {tsCompressTimestamp, tsCompressInt, tsCompressInt,
+                                                      tsCompressFloat, tsCompressDouble};
+
+typedef struct {
+  char * data[BENCH_COLS];  // the rows copied out of the cache
+  char * cdata[BENCH_COLS];
+  int    clen[BENCH_COLS];
+  char * buffer;  // scratch buffer of two stage compression
+  int    bufferSize;
+  int    points;
+  bool   compressing;
+  sem_t  done;
+} SBenchBlock;
+
+static int   numOfMeters = 200;
+static int   rowsPerBlock = 4096;
+static int   comp = TWO_STAGE_COMP;
+static char *cache[BENCH_COLS];  // the cache of all meters, column by column
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void benchGenCache() {
+  for (int c = 0; c < BENCH_COLS; ++c) cache[c] = malloc((size_t)numOfMeters * rowsPerBlock * colBytes[c]);
+
+  for (int m = 0; m < numOfMeters; ++m) {
+    int64_t *ts = (int64_t *)cache[0] + (size_t)m * rowsPerBlock;
+    int32_t *i1 = (int32_t *)cache[1] + (size_t)m * rowsPerBlock;
+    int32_t *i2 = (int32_t *)cache[2] + (size_t)m * rowsPerBlock;
+    float *  f = (float *)cache[3] + (size_t)m * rowsPerBlock;
+    double * d = (double *)cache[4] + (size_t)m * rowsPerBlock;
+    int      v = 2000;
+
+    for (int i = 0; i < rowsPerBlock; ++i) {
+      ts[i] = 1500000000000L + i * 1000L + rand() % 10;
+      i1[i] = rand() % 100;
+      i2[i] = 20000 + i;
+      v += rand() % 3 - 1;
+      f[i] = v / 100.0f;
+      d[i] = (double)(rand() / 1000000);
+    }
+  }
+}
+
+static void benchCompressBlock(SBenchBlock *pBlock) {
+  for (int c = 0; c < BENCH_COLS; ++c) {
+    pBlock->clen[c] = (*colCompFp[c])(pBlock->data[c], pBlock->points * colBytes[c], pBlock->points, pBlock->cdata[c],
+                                      pBlock->points * colBytes[c] + BENCH_EXTRA_BYTES, comp, pBlock->buffer,
+                                      pBlock->bufferSize);
+  }
+}
+
+static void benchProcessCompressBlock(SSchedMsg *pMsg) {
+  SBenchBlock *pBlock = (SBenchBlock *)pMsg->ahandle;
+  benchCompressBlock(pBlock);
+  sem_post(&pBlock->done);
+}
+
+static int64_t benchWriteBlock(int fd, SBenchBlock *pBlock) {
+  int64_t size = 0;
+
+  if (pBlock->compressing) {
+    sem_wait(&pBlock->done);
+    pBlock->compressing = false;
+  }
+
+  for (int c = 0; c < BENCH_COLS; ++c) {
+    if (write(fd, pBlock->cdata[c], pBlock->clen[c]) != pBlock->clen[c]) {
+      printf("failed to write the data file\n");
+      exit(1);
+    }
+    size += pBlock->clen[c];
+  }
+
+  return size;
+}
+
+// returns the compressed size of one commit of all meters
+static int64_t benchCommit(const char *file, void *qhandle, SBenchBlock *pBlocks, int numOfBlocks) {
+  int64_t size = 0;
+  int     head = 0, numOfQueued = 0;
+
+  int fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    printf("failed to open %s\n", file);
+    exit(1);
+  }
+
+  for (int m = 0; m < numOfMeters; ++m) {
+    if (numOfQueued == numOfBlocks) {
+      size += benchWriteBlock(fd, &pBlocks[head]);
+      head = (head + 1) % numOfBlocks;
+      numOfQueued--;
+    }
+
+    SBenchBlock *pBlock = &pBlocks[(head + numOfQueued) % numOfBlocks];
+    for (int c = 0; c < BENCH_COLS; ++c) {
+      memcpy(pBlock->data[c], cache[c] + (size_t)m * rowsPerBlock * colBytes[c], (size_t)rowsPerBlock * colBytes[c]);
+    }
+    pBlock->points = rowsPerBlock;
+    numOfQueued++;
+
+    if (qhandle == NULL) {
+      benchCompressBlock(pBlock);
+    } else {
+      SSchedMsg schedMsg = {0};
+      schedMsg.fp = benchProcessCompressBlock;
+      schedMsg.ahandle = pBlock;
+      pBlock->compressing = true;
+      taosScheduleTask(qhandle, &schedMsg);
+    }
+  }
+
+  while (numOfQueued > 0) {
+    size += benchWriteBlock(fd, &pBlocks[head]);
+    head = (head + 1) % numOfBlocks;
+    numOfQueued--;
+  }
+
+  close(fd);
+  return size;
+}
+
+int main(int argc, char *argv[]) {
+  int   maxThreads = 8;
+  int   rounds = 3;
+  char *file = "./commitBench.data";
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-meters") == 0) {
+      numOfMeters = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rows") == 0) {
+      rowsPerBlock = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-comp") == 0) {
+      comp = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-threads") == 0) {
+      maxThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rounds") == 0) {
+      rounds = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-file") == 0) {
+      file = argv[++i];
+    }
+  }
+
+  benchGenCache();
+
+  int64_t rawSize = 0;
+  for (int c = 0; c < BENCH_COLS; ++c) rawSize += (int64_t)numOfMeters * rowsPerBlock * colBytes[c];
+
+  printf("meters:%d rows:%d comp:%d, raw size:%.1fMB\n", numOfMeters, rowsPerBlock, comp, rawSize / 1048576.0);
+  printf("threads  rows/s(M)  MB/s  ratio\n");
+
+  for (int threads = 0; threads <= maxThreads; threads = (threads == 0) ? 1 : threads * 2) {
+    void *qhandle = NULL;
+    int   numOfBlocks = 1;
+    if (threads > 0) {
+      qhandle = taosInitScheduler(threads * 4, threads, "commit");
+      numOfBlocks = threads * 2;
+    }
+
+    SBenchBlock *pBlocks = calloc(numOfBlocks, sizeof(SBenchBlock));
+    for (int b = 0; b < numOfBlocks; ++b) {
+      for (int c = 0; c < BENCH_COLS; ++c) {
+        pBlocks[b].data[c] = malloc((size_t)rowsPerBlock * colBytes[c] + BENCH_EXTRA_BYTES);
+        pBlocks[b].cdata[c] = malloc((size_t)rowsPerBlock * colBytes[c] + BENCH_EXTRA_BYTES);
+      }
+      if (comp == TWO_STAGE_COMP) {
+        pBlocks[b].bufferSize = rowsPerBlock * 8 + BENCH_EXTRA_BYTES;
+        pBlocks[b].buffer = malloc((size_t)pBlocks[b].bufferSize);
+      }
+      sem_init(&pBlocks[b].done, 0, 0);
+    }
+
+    int64_t compSize = 0;
+    int64_t st = benchGetNanoTime();
+    for (int r = 0; r < rounds; ++r) compSize = benchCommit(file, qhandle, pBlocks, numOfBlocks);
+    int64_t et = benchGetNanoTime();
+
+    double seconds = (et - st) / 1e9;
+    printf("%7d %10.2f %6.0f %6.2f\n", threads, (double)numOfMeters * rowsPerBlock * rounds / seconds / 1e6,
+           rawSize * rounds / seconds / 1048576, (double)rawSize / compSize);
+
+    if (qhandle) taosCleanUpScheduler(qhandle);
+    for (int b = 0; b < numOfBlocks; ++b) {
+      for (int c = 0; c < BENCH_COLS; ++c) {
+        free(pBlocks[b].data[c]);
+        free(pBlocks[b].cdata[c]);
+      }
+      free(pBlocks[b].buffer);
+      sem_destroy(&pBlocks[b].done);
+    }
+    free(pBlocks);
+  }
+
+  remove(file);
+  for (int c = 0; c < BENCH_COLS; ++c) free(cache[c]);
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// contention of the int and string hashes of the util library under a read mostly load, as the meter and
+// connection lookups see it. Each thread looks up random keys, and a small share of the operations deletes and
+// adds back one of its own keys. The lookups of the library are lock free, the -mutex mode wraps every call in
+// one global mutex to compare with a hash locked as a whole.
+// to compile: make, and run: ./hashBench [-keys 10000] [-ops 1000000] [-write 1] [-threads 64] [-mutex]
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ihash.h"
+#include "shash.h"
+
+typedef struct {
+  int      tid;
+  int      numOfThreads;
+  bool     str;
+  uint32_t seed;
+  int64_t  hits;
+} SBenchThread;
+
+static void *           intHash;
+static void *           strHash;
+static char (*keyStr)[24];
+static int              numOfKeys = 10000;
+static int              numOfOps = 1000000;
+static int              writePercent = 1;
+static bool             useMutex = false;
+static pthread_mutex_t  globalMutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int64_t sink;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void *benchLookup(SBenchThread *pThread, int key) {
+  void *p;
+  if (useMutex) pthread_mutex_lock(&globalMutex);
+  if (pThread->str) {
+    p = taosGetStrHashData(strHash, keyStr[key]);
+  } else {
+    p = taosGetIntHashData(intHash, (uint64_t)key);
+  }
+  if (useMutex) pthread_mutex_unlock(&globalMutex);
+
+  return p;
+}
+
+// a thread only writes the keys it owns, so that a key is never added twice
+static void benchUpdate(SBenchThread *pThread, int key) {
+  key -= key % pThread->numOfThreads;
+  key += pThread->tid;
+  if (key >= numOfKeys) return;
+
+  if (useMutex) pthread_mutex_lock(&globalMutex);
+  if (pThread->str) {
+    taosDeleteStrHash(strHash, keyStr[key]);
+    taosAddStrHash(strHash, keyStr[key], (char *)&key);
+  } else {
+    taosDeleteIntHash(intHash, (uint64_t)key);
+    taosAddIntHash(intHash, (uint64_t)key, (char *)&key);
+  }
+  if (useMutex) pthread_mutex_unlock(&globalMutex);
+}
+
+static void *benchThreadFp(void *param) {
+  SBenchThread *pThread = (SBenchThread *)param;
+  int           ops = numOfOps / pThread->numOfThreads;
+
+  for (int i = 0; i < ops; ++i) {
+    int key = rand_r(&pThread->seed) % numOfKeys;
+    if (rand_r(&pThread->seed) % 100 < writePercent) {
+      benchUpdate(pThread, key);
+    } else if (benchLookup(pThread, key) != NULL) {
+      pThread->hits++;
+    }
+  }
+
+  return NULL;
+}
+
+static double benchRun(int numOfThreads, bool str) {
+  pthread_t *   threads = malloc(sizeof(pthread_t) * numOfThreads);
+  SBenchThread *pThreads = calloc(numOfThreads, sizeof(SBenchThread));
+
+  int64_t st = benchGetNanoTime();
+  for (int i = 0; i < numOfThreads; ++i) {
+    pThreads[i].tid = i;
+    pThreads[i].numOfThreads = numOfThreads;
+    pThreads[i].str = str;
+    pThreads[i].seed = (uint32_t)(i * 7919 + 1);
+    pthread_create(threads + i, NULL, benchThreadFp, pThreads + i);
+  }
+
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_join(threads[i], NULL);
+    sink += pThreads[i].hits;
+  }
+  int64_t et = benchGetNanoTime();
+
+  int64_t ops = (int64_t)(numOfOps / numOfThreads) * numOfThreads;
+
+  free(threads);
+  free(pThreads);
+
+  return (double)ops * 1000 / (et - st);
+}
+
+int main(int argc, char *argv[]) {
+  int maxThreads = 64;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-keys") == 0) {
+      numOfKeys = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-ops") == 0) {
+      numOfOps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-write") == 0) {
+      writePercent = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-threads") == 0) {
+      maxThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-mutex") == 0) {
+      useMutex = true;
+    }
+  }
+
+  intHash = taosInitIntHash(numOfKeys, sizeof(int), taosHashInt);
+  strHash = taosInitStrHash(numOfKeys, sizeof(int), taosHashString);
+  keyStr = malloc(sizeof(*keyStr) * numOfKeys);
+  if (intHash == NULL || strHash == NULL || keyStr == NULL) {
+    printf("failed to init the hashes\n");
+    exit(1);
+  }
+
+  for (int i = 0; i < numOfKeys; ++i) {
+    snprintf(keyStr[i], sizeof(keyStr[i]), "db.meter_%d", i);
+    taosAddIntHash(intHash, (uint64_t)i, (char *)&i);
+    taosAddStrHash(strHash, keyStr[i], (char *)&i);
+  }
+
+  printf("keys:%d ops:%d write:%d%% lock:%s, million ops per second\n", numOfKeys, numOfOps, writePercent,
+         useMutex ? "global mutex" : "library");
+  printf("threads     int hash    str hash\n");
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    double intOps = benchRun(threads, false);
+    double strOps = benchRun(threads, true);
+    printf("%7d %11.2f %11.2f\n", threads, intOps, strOps);
+  }
+
+  taosCleanUpIntHash(intHash);
+  taosCleanUpStrHash(strHash);
+  free(keyStr);
+
+  return 0;
+}
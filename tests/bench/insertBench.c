@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// rows per second of inserting into one table through the client, for a range of rows per insert statement.
+// The statements are built before the clock starts, so it measures the parsing, the submit and the vnode cache
+// insert. The -copy mode measures the cache insert alone: copying a row-wise submit block into the columns of a
+// cache block row by row with a memcpy per value, as vnodeInsertPointToCache did, or a column at a time, as
+// vnodeInsertBlockToCache does.
+// to compile: make, and run: ./insertBench [-c /etc/taos] [-host 127.0.0.1] [-cols 4] [-rows 200000]
+// [-copy [-rounds 20000]]
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "taos.h"
+
+static volatile int64_t sink;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t benchGetEpochMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int benchExec(TAOS *taos, const char *sql) {
+  if (taos_query(taos, sql) != 0) {
+    printf("failed to run \"%.80s\", reason:%s\n", sql, taos_errstr(taos));
+    return -1;
+  }
+
+  return 0;
+}
+
+// rows of a timestamp and cols int columns, as the submit payload carries them
+static void benchCopyRows(int cols, int rows, int rounds) {
+  int      rowSize = 8 + cols * 4;
+  char *   payload = malloc((size_t)rowSize * rows);
+  char *   column[cols + 1];
+  int16_t  bytes[cols + 1];
+  int64_t  st, et;
+
+  bytes[0] = 8;
+  column[0] = malloc((size_t)rows * 8);
+  for (int c = 1; c <= cols; ++c) {
+    bytes[c] = 4;
+    column[c] = malloc((size_t)rows * 4);
+  }
+
+  for (int i = 0; i < rows; ++i) {
+    *(int64_t *)(payload + i * rowSize) = i;
+    for (int c = 0; c < cols; ++c) *(int32_t *)(payload + i * rowSize + 8 + c * 4) = rand();
+  }
+
+  st = benchGetNanoTime();
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < rows; ++i) {
+      char *pData = payload + i * rowSize;
+      for (int c = 0; c <= cols; ++c) {
+        memcpy(column[c] + i * bytes[c], pData, bytes[c]);
+        pData += bytes[c];
+      }
+    }
+    sink += column[cols][r % rows];
+  }
+  et = benchGetNanoTime();
+  printf("row by row:      %8.2f million rows/s\n", (double)rows * rounds * 1000 / (et - st));
+
+  st = benchGetNanoTime();
+  for (int r = 0; r < rounds; ++r) {
+    char *pCol = payload;
+    for (int c = 0; c <= cols; ++c) {
+      char *src = pCol;
+      if (bytes[c] == 8) {
+        for (int i = 0; i < rows; ++i, src += rowSize) ((int64_t *)column[c])[i] = *(int64_t *)src;
+      } else {
+        for (int i = 0; i < rows; ++i, src += rowSize) ((int32_t *)column[c])[i] = *(int32_t *)src;
+      }
+      pCol += bytes[c];
+    }
+    sink += column[cols][r % rows];
+  }
+  et = benchGetNanoTime();
+  printf("column at a time: %8.2f million rows/s\n", (double)rows * rounds * 1000 / (et - st));
+
+  for (int c = 0; c <= cols; ++c) free(column[c]);
+  free(payload);
+}
+
+static int benchInsert(TAOS *taos, int cols, int rows, int batch) {
+  int    numOfSqls = (rows + batch - 1) / batch;
+  int    sqlLen = 64 + batch * (32 + cols * 12);
+  char **sqls = malloc(sizeof(char *) * numOfSqls);
+  char   sql[256];
+
+  snprintf(sql, sizeof(sql), "create table insbench.t%d (ts timestamp", batch);
+  for (int c = 0; c < cols; ++c) snprintf(sql + strlen(sql), sizeof(sql) - strlen(sql), ", c%d int", c);
+  strcat(sql, ")");
+  if (benchExec(taos, sql) != 0) return -1;
+
+  // one row per millisecond, ending at the current time
+  int64_t ts = benchGetEpochMs() - rows;
+  for (int s = 0; s < numOfSqls; ++s) {
+    char *p = sqls[s] = malloc((size_t)sqlLen);
+    p += sprintf(p, "insert into insbench.t%d values", batch);
+    for (int i = 0; i < batch && s * batch + i < rows; ++i) {
+      p += sprintf(p, " (%ld", (long)ts++);
+      for (int c = 0; c < cols; ++c) p += sprintf(p, ",%d", rand() % 100000);
+      *p++ = ')';
+    }
+    *p = 0;
+  }
+
+  int64_t st = benchGetNanoTime();
+  for (int s = 0; s < numOfSqls; ++s) {
+    if (benchExec(taos, sqls[s]) != 0) return -1;
+  }
+  int64_t et = benchGetNanoTime();
+
+  printf("%7d %12.0f\n", batch, (double)rows * 1000000000 / (et - st));
+
+  for (int s = 0; s < numOfSqls; ++s) free(sqls[s]);
+  free(sqls);
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  char *cfgDir = NULL;
+  char *host = "127.0.0.1";
+  int   cols = 4;
+  int   rows = 200000;
+  int   rounds = 20000;
+  bool  copy = false;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-c") == 0) {
+      cfgDir = argv[++i];
+    } else if (strcmp(argv[i], "-host") == 0) {
+      host = argv[++i];
+    } else if (strcmp(argv[i], "-cols") == 0) {
+      cols = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rows") == 0) {
+      rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rounds") == 0) {
+      rounds = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-copy") == 0) {
+      copy = true;
+    }
+  }
+
+  if (copy) {
+    printf("cols:%d, copying 1000 rows of the submit block into cache columns\n", cols);
+    benchCopyRows(cols, 1000, rounds);
+    return 0;
+  }
+
+  if (cfgDir != NULL) taos_options(TSDB_OPTION_CONFIGDIR, cfgDir);
+  taos_init();
+
+  TAOS *taos = taos_connect(host, "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to %s\n", host);
+    exit(1);
+  }
+
+  taos_query(taos, "drop database if exists insbench");
+  if (benchExec(taos, "create database insbench") != 0) exit(1);
+
+  printf("cols:%d rows:%d\n", cols, rows);
+  printf("  batch   rows/s\n");
+  int batches[] = {1, 10, 100, 1000};
+  for (int i = 0; i < sizeof(batches) / sizeof(batches[0]); ++i) {
+    if (benchInsert(taos, cols, batches[i] == 1 ? rows / 10 : rows, batches[i]) != 0) break;
+  }
+
+  benchExec(taos, "drop database insbench");
+  taos_close(taos);
+
+  return 0;
+}
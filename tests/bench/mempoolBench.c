@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// allocations and frees of tmempool blocks from many threads, as the rpc and cache pools see them. Each thread
+// allocates a burst of blocks and frees them again. The library pool caches free slots in per-thread magazines,
+// the -mutex mode runs the same load on a copy of the pool that locks its mutex on every call.
+// to compile: make, and run: ./mempoolBench [-blocks 4096] [-size 64] [-burst 16] [-ops 2000000] [-threads 64]
+// [-mutex]
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tmempool.h"
+
+// the pool that locks its mutex on every call
+typedef struct {
+  int             numOfFree;
+  int             first;
+  int             numOfBlock;
+  int             blockSize;
+  int *           freeList;
+  char *          pool;
+  pthread_mutex_t mutex;
+} SLockedPool;
+
+typedef struct {
+  int     numOfThreads;
+  int64_t failed;
+} SBenchThread;
+
+static void *           pool;
+static int              numOfBlocks = 4096;
+static int              blockSize = 64;
+static int              burst = 16;
+static int              numOfOps = 2000000;
+static bool             useMutex = false;
+static volatile int64_t sink;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static SLockedPool *lockedPoolInit(int numOfBlock, int size) {
+  SLockedPool *pPool = calloc(1, sizeof(SLockedPool));
+  pPool->numOfBlock = numOfBlock;
+  pPool->blockSize = size;
+  pPool->pool = calloc(numOfBlock, size);
+  pPool->freeList = malloc(sizeof(int) * numOfBlock);
+  for (int i = 0; i < numOfBlock; ++i) pPool->freeList[i] = i;
+  pPool->numOfFree = numOfBlock;
+  pthread_mutex_init(&pPool->mutex, NULL);
+
+  return pPool;
+}
+
+static char *lockedPoolMalloc(SLockedPool *pPool) {
+  char *pos = NULL;
+
+  pthread_mutex_lock(&pPool->mutex);
+  if (pPool->numOfFree > 0) {
+    pos = pPool->pool + pPool->blockSize * pPool->freeList[pPool->first];
+    pPool->first = (pPool->first + 1) % pPool->numOfBlock;
+    pPool->numOfFree--;
+  }
+  pthread_mutex_unlock(&pPool->mutex);
+
+  return pos;
+}
+
+static void lockedPoolFree(SLockedPool *pPool, char *pMem) {
+  int index = (int)((pMem - pPool->pool) / pPool->blockSize);
+  memset(pMem, 0, (size_t)pPool->blockSize);
+
+  pthread_mutex_lock(&pPool->mutex);
+  pPool->freeList[(pPool->first + pPool->numOfFree) % pPool->numOfBlock] = index;
+  pPool->numOfFree++;
+  pthread_mutex_unlock(&pPool->mutex);
+}
+
+static void lockedPoolCleanUp(SLockedPool *pPool) {
+  pthread_mutex_destroy(&pPool->mutex);
+  free(pPool->pool);
+  free(pPool->freeList);
+  free(pPool);
+}
+
+static void *benchThreadFp(void *param) {
+  SBenchThread *pThread = (SBenchThread *)param;
+  char **       blocks = malloc(sizeof(char *) * burst);
+  int           rounds = numOfOps / pThread->numOfThreads / burst;
+
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < burst; ++i) {
+      blocks[i] = useMutex ? lockedPoolMalloc(pool) : taosMemPoolMalloc(pool);
+      if (blocks[i] == NULL) {
+        pThread->failed++;
+      } else {
+        blocks[i][0] = (char)i;
+      }
+    }
+
+    for (int i = 0; i < burst; ++i) {
+      if (blocks[i] == NULL) continue;
+      sink += blocks[i][0];
+      if (useMutex) {
+        lockedPoolFree(pool, blocks[i]);
+      } else {
+        taosMemPoolFree(pool, blocks[i]);
+      }
+    }
+  }
+
+  free(blocks);
+  return NULL;
+}
+
+// returns million allocations and frees per second
+static double benchRun(int numOfThreads, int64_t *failed) {
+  pthread_t *   threads = malloc(sizeof(pthread_t) * numOfThreads);
+  SBenchThread *pThreads = calloc(numOfThreads, sizeof(SBenchThread));
+
+  int64_t st = benchGetNanoTime();
+  for (int i = 0; i < numOfThreads; ++i) {
+    pThreads[i].numOfThreads = numOfThreads;
+    pthread_create(threads + i, NULL, benchThreadFp, pThreads + i);
+  }
+
+  *failed = 0;
+  for (int i = 0; i < numOfThreads; ++i) {
+    pthread_join(threads[i], NULL);
+    *failed += pThreads[i].failed;
+  }
+  int64_t et = benchGetNanoTime();
+
+  int64_t ops = (int64_t)(numOfOps / numOfThreads / burst) * burst * numOfThreads * 2;
+
+  free(threads);
+  free(pThreads);
+
+  return (double)ops * 1000 / (et - st);
+}
+
+int main(int argc, char *argv[]) {
+  int maxThreads = 64;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-blocks") == 0) {
+      numOfBlocks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-size") == 0) {
+      blockSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-burst") == 0) {
+      burst = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-ops") == 0) {
+      numOfOps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-threads") == 0) {
+      maxThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-mutex") == 0) {
+      useMutex = true;
+    }
+  }
+
+  pool = useMutex ? (void *)lockedPoolInit(numOfBlocks, blockSize) : taosMemPoolInit(numOfBlocks, blockSize);
+  if (pool == NULL) {
+    printf("failed to init the pool\n");
+    exit(1);
+  }
+
+  printf("blocks:%d size:%d burst:%d ops:%d pool:%s\n", numOfBlocks, blockSize, burst, numOfOps,
+         useMutex ? "mutex" : "magazines");
+  printf("threads  Mops/s  failed\n");
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    int64_t failed = 0;
+    double  ops = benchRun(threads, &failed);
+    printf("%7d %7.2f %7" PRId64 "\n", threads, ops, failed);
+  }
+
+  if (useMutex) {
+    lockedPoolCleanUp(pool);
+  } else {
+    taosMemPoolCleanUp(pool);
+  }
+
+  return 0;
+}
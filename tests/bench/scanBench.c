@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// time of a cold sequential scan over the blocks of a data file, reading block by block as moveToNextBlock does.
+// The page cache of the file is dropped before each run; the next blocks are advised to the kernel either not at
+// all, as a window re-advised on every step, or once per block by tracking the last advised block.
+// to compile: make, and run: ./scanBench [-file ./scanBench.data] [-size 256] [-block 65536] [-prefetch 4] [-cpu 0] [-rounds 3]
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+enum { PREFETCH_NONE, PREFETCH_WINDOW, PREFETCH_ONCE };
+
+static const char *modeName[] = {"none", "window", "once"};
+static volatile uint64_t sink;
+
+static int64_t benchGetMicroTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int benchCreateFile(const char *name, int64_t size, int32_t blockSize) {
+  int fd = open(name, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size == size) return fd;
+
+  char *buf = malloc(blockSize);
+  for (int32_t i = 0; i < blockSize; ++i) buf[i] = (char)rand();
+
+  if (ftruncate(fd, 0) != 0) return -1;
+  for (int64_t offset = 0; offset < size; offset += blockSize) {
+    if (write(fd, buf, blockSize) != blockSize) {
+      free(buf);
+      return -1;
+    }
+  }
+
+  fsync(fd);
+  free(buf);
+  return fd;
+}
+
+// the cpu time spent on one block, standing for the decompression and the functions applied on it
+static uint64_t benchConsumeBlock(const char *buf, int32_t len, int32_t rounds) {
+  uint64_t sum = 0;
+  for (int32_t r = 0; r <= rounds; ++r) {
+    for (int32_t i = 0; i < len; i += 8) sum = sum * 31 + *(uint64_t *)(buf + i);
+  }
+
+  return sum;
+}
+
+static void benchScan(int fd, int32_t numOfBlocks, int32_t blockSize, int32_t prefetch, int32_t cpu, int mode) {
+  char *buf = malloc(blockSize);
+
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+  int64_t  advised = 0;
+  int32_t  nextSlot = 1;
+  uint64_t sum = 0;
+  int64_t  st = benchGetMicroTime();
+
+  for (int32_t slot = 0; slot < numOfBlocks; ++slot) {
+    if (pread(fd, buf, blockSize, (int64_t)slot * blockSize) != blockSize) {
+      printf("failed to read block %d\n", slot);
+      exit(1);
+    }
+
+    if (mode == PREFETCH_WINDOW) {
+      for (int32_t i = 1; i <= prefetch && slot + i < numOfBlocks; ++i) {
+        posix_fadvise(fd, (int64_t)(slot + i) * blockSize, blockSize, POSIX_FADV_WILLNEED);
+        advised++;
+      }
+    } else if (mode == PREFETCH_ONCE) {
+      if (nextSlot <= slot) nextSlot = slot + 1;
+
+      while (nextSlot < numOfBlocks && nextSlot - slot <= prefetch) {
+        posix_fadvise(fd, (int64_t)nextSlot * blockSize, blockSize, POSIX_FADV_WILLNEED);
+        advised++;
+        nextSlot++;
+      }
+    }
+
+    sum += benchConsumeBlock(buf, blockSize, cpu);
+  }
+
+  int64_t et = benchGetMicroTime();
+  printf("%-8s %10.1f ms %10.1f MB/s %10ld fadvise calls\n", modeName[mode], (et - st) / 1000.0,
+         (double)numOfBlocks * blockSize / (et - st), advised);
+
+  sink += sum;
+
+  free(buf);
+}
+
+int main(int argc, char *argv[]) {
+  char *  name = "./scanBench.data";
+  int64_t size = 256;
+  int32_t blockSize = 65536;
+  int32_t prefetch = 4;
+  int32_t cpu = 0;
+  int32_t rounds = 3;
+
+  for (int i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-file") == 0) {
+      name = argv[i + 1];
+    } else if (strcmp(argv[i], "-size") == 0) {
+      size = atoll(argv[i + 1]);
+    } else if (strcmp(argv[i], "-block") == 0) {
+      blockSize = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-prefetch") == 0) {
+      prefetch = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-cpu") == 0) {
+      cpu = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-rounds") == 0) {
+      rounds = atoi(argv[i + 1]);
+    }
+  }
+
+  size = size * 1024 * 1024 / blockSize * blockSize;
+  int32_t numOfBlocks = (int32_t)(size / blockSize);
+
+  int fd = benchCreateFile(name, size, blockSize);
+  if (fd < 0) {
+    printf("failed to create %s\n", name);
+    return 1;
+  }
+
+  printf("file:%s size:%ldMB block:%d blocks:%d prefetch:%d cpu:%d\n", name, size >> 20, blockSize, numOfBlocks,
+         prefetch, cpu);
+
+  for (int round = 0; round < rounds; ++round) {
+    for (int mode = PREFETCH_NONE; mode <= PREFETCH_ONCE; ++mode) {
+      benchScan(fd, numOfBlocks, blockSize, prefetch, cpu, mode);
+    }
+  }
+
+  close(fd);
+  return 0;
+}
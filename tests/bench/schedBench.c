@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// throughput and latency of the scheduler queues, the mutex one and the lock free one
+// to compile: make, and run: ./schedBench [-msgs 1000000] [-queue 10000]
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tsched.h"
+
+typedef struct {
+  void *  qhandle;
+  int64_t start;
+  int     num;
+} SProducer;
+
+static int64_t *latency;
+static int32_t  numOfDone;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void benchProcessMsg(SSchedMsg *pMsg) {
+  int64_t *pTime = (int64_t *)pMsg->ahandle;
+  *pTime = benchGetNanoTime() - *pTime;
+  __atomic_add_fetch(&numOfDone, 1, __ATOMIC_RELEASE);
+}
+
+static void *benchProduce(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+  SSchedMsg  msg = {.fp = benchProcessMsg};
+
+  for (int i = 0; i < pProducer->num; ++i) {
+    int64_t *pTime = latency + pProducer->start + i;
+    *pTime = benchGetNanoTime();
+    msg.ahandle = pTime;
+    taosScheduleTask(pProducer->qhandle, &msg);
+  }
+
+  return NULL;
+}
+
+static int benchCompareInt64(const void *p1, const void *p2) {
+  int64_t v1 = *(int64_t *)p1, v2 = *(int64_t *)p2;
+  return (v1 < v2) ? -1 : (v1 > v2);
+}
+
+static void benchSchedQueue(int type, int numOfThreads, int numOfMsgs, int queueSize) {
+  void *qhandle = taosInitSchedulerWithType(queueSize, numOfThreads, "bench", type);
+  if (qhandle == NULL) {
+    printf("failed to init scheduler\n");
+    exit(EXIT_FAILURE);
+  }
+
+  pthread_t *threads = malloc(sizeof(pthread_t) * numOfThreads);
+  SProducer *producers = malloc(sizeof(SProducer) * numOfThreads);
+  numOfDone = 0;
+
+  int64_t st = benchGetNanoTime();
+  for (int i = 0; i < numOfThreads; ++i) {
+    producers[i].qhandle = qhandle;
+    producers[i].start = (int64_t)numOfMsgs / numOfThreads * i;
+    producers[i].num = numOfMsgs / numOfThreads;
+    pthread_create(threads + i, NULL, benchProduce, producers + i);
+  }
+
+  for (int i = 0; i < numOfThreads; ++i) pthread_join(threads[i], NULL);
+
+  int total = numOfMsgs / numOfThreads * numOfThreads;
+  while (__atomic_load_n(&numOfDone, __ATOMIC_ACQUIRE) < total) {
+    sched_yield();
+  }
+  int64_t elapsed = benchGetNanoTime() - st;
+
+  qsort(latency, total, sizeof(int64_t), benchCompareInt64);
+  printf("%-10s threads:%2d  msgs/s:%10.0f  p50:%8.1fus  p99:%8.1fus  p999:%8.1fus\n",
+         type == TAOS_SCHED_TYPE_LOCK_FREE ? "lock-free" : "mutex", numOfThreads, total * 1e9 / elapsed,
+         latency[total / 2] / 1000.0, latency[(int64_t)total * 99 / 100] / 1000.0,
+         latency[(int64_t)total * 999 / 1000] / 1000.0);
+
+  taosCleanUpScheduler(qhandle);
+  free(producers);
+  free(threads);
+}
+
+int main(int argc, char *argv[]) {
+  int numOfMsgs = 1000000;
+  int queueSize = 10000;
+
+  for (int i = 1; i < argc - 1; ++i) {
+    if (strcmp(argv[i], "-msgs") == 0) {
+      numOfMsgs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-queue") == 0) {
+      queueSize = atoi(argv[++i]);
+    }
+  }
+
+  latency = malloc(sizeof(int64_t) * numOfMsgs);
+
+  // the same number of producers and scheduler threads
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    benchSchedQueue(TAOS_SCHED_TYPE_MUTEX, threads, numOfMsgs, queueSize);
+    benchSchedQueue(TAOS_SCHED_TYPE_LOCK_FREE, threads, numOfMsgs, queueSize);
+  }
+
+  free(latency);
+  return 0;
+}
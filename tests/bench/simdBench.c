@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// the block kernels of sum/min/max/count against the element-wise loops with isNull, on 1M-row blocks.
+// The results are checked first, including float/double blocks containing NaN values.
+// to compile: make, and run: ./simdBench [-rows 1048576] [-rounds 20]
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tsdb.h"
+#include "tsimd.h"
+#include "ttypes.h"
+
+typedef union {
+  int64_t i;
+  double  d;
+} SBenchVal;
+
+static const char *typeName[] = {"", "", "tinyint", "smallint", "int", "bigint", "float", "double"};
+static const int   typeBytes[] = {0, 0, 1, 2, 4, 8, 4, 8};
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double benchGetValue(const char *p, int type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:  return *(int8_t *)p;
+    case TSDB_DATA_TYPE_SMALLINT: return *(int16_t *)p;
+    case TSDB_DATA_TYPE_INT:      return *(int32_t *)p;
+    case TSDB_DATA_TYPE_BIGINT:   return (double)*(int64_t *)p;
+    case TSDB_DATA_TYPE_FLOAT:    return *(float *)p;
+    default:                      return *(double *)p;
+  }
+}
+
+// one tenth of the rows are null, and 1% of the float/double rows are NaN
+static char *benchGenerateBlock(int type, int rows) {
+  char *data = malloc((size_t)rows * typeBytes[type]);
+  for (int i = 0; i < rows; ++i) {
+    char *p = data + (size_t)i * typeBytes[type];
+    int   r = rand();
+    if (r % 10 == 0) {
+      setNull(p, type, typeBytes[type]);
+      continue;
+    }
+
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:  *(int8_t *)p = (int8_t)(r % 200 - 100); break;
+      case TSDB_DATA_TYPE_SMALLINT: *(int16_t *)p = (int16_t)(r % 60000 - 30000); break;
+      case TSDB_DATA_TYPE_INT:      *(int32_t *)p = r - RAND_MAX / 2; break;
+      case TSDB_DATA_TYPE_BIGINT:   *(int64_t *)p = ((int64_t)r << 20) - ((int64_t)RAND_MAX << 19); break;
+      case TSDB_DATA_TYPE_FLOAT:    *(float *)p = (r % 100 == 1) ? NAN : (float)(r % 100000) / 7 - 5000; break;
+      default:                      *(double *)p = (r % 100 == 1) ? NAN : (double)r / 7 - RAND_MAX / 14.0; break;
+    }
+  }
+
+  return data;
+}
+
+// the element-wise loops, as the aggregate functions did before the block kernels, a NaN is never taken by min/max
+static int benchLoopMin(const char *data, int rows, int type, double *min) {
+  int notNull = 0;
+  *min = INFINITY;
+  for (int i = 0; i < rows; ++i) {
+    const char *p = data + (size_t)i * typeBytes[type];
+    if (isNull(p, type)) continue;
+    double v = benchGetValue(p, type);
+    if (v < *min) *min = v;
+    notNull++;
+  }
+  return notNull;
+}
+
+static int benchLoopMax(const char *data, int rows, int type, double *max) {
+  int notNull = 0;
+  *max = -INFINITY;
+  for (int i = 0; i < rows; ++i) {
+    const char *p = data + (size_t)i * typeBytes[type];
+    if (isNull(p, type)) continue;
+    double v = benchGetValue(p, type);
+    if (v > *max) *max = v;
+    notNull++;
+  }
+  return notNull;
+}
+
+static int benchLoopSum(const char *data, int rows, int type, SBenchVal *sum) {
+  int notNull = 0;
+  sum->i = 0;
+  sum->d = (type >= TSDB_DATA_TYPE_FLOAT) ? 0 : sum->d;
+  for (int i = 0; i < rows; ++i) {
+    const char *p = data + (size_t)i * typeBytes[type];
+    if (isNull(p, type)) continue;
+    if (type >= TSDB_DATA_TYPE_FLOAT) {
+      sum->d += benchGetValue(p, type);
+    } else {
+      sum->i += (int64_t)benchGetValue(p, type);
+    }
+    notNull++;
+  }
+  return notNull;
+}
+
+static bool benchCheck(const char *data, int rows, int type) {
+  double    loopMin = 0, loopMax = 0;
+  SBenchVal loopSum, sum;
+  char      min[8] = {0}, max[8] = {0};
+
+  int n1 = benchLoopMin(data, rows, type, &loopMin);
+  int n2 = taosMinBlock(data, rows, type, min);
+  benchLoopMax(data, rows, type, &loopMax);
+  taosMaxBlock(data, rows, type, max);
+  benchLoopSum(data, rows, type, &loopSum);
+  taosSumBlock(data, rows, type, &sum);
+  int count = taosCountNotNullBlock(data, rows, type);
+
+  bool ok = (n1 == n2) && (count == n1) && (benchGetValue(min, type) == loopMin) &&
+            (benchGetValue(max, type) == loopMax);
+  if (type >= TSDB_DATA_TYPE_FLOAT) {
+    // NaN makes the sum NaN, otherwise the vector sum differs from the loop only in rounding
+    ok = ok && ((isnan(loopSum.d) && isnan(sum.d)) || fabs(sum.d - loopSum.d) <= fabs(loopSum.d) * 1e-6 + 1e-6);
+  } else {
+    ok = ok && (sum.i == loopSum.i);
+  }
+
+  if (!ok) {
+    printf("%-8s mismatch, notNull:%d/%d/%d, min:%g/%g, max:%g/%g\n", typeName[type], n1, n2, count, loopMin,
+           benchGetValue(min, type), loopMax, benchGetValue(max, type));
+  }
+
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  int rows = 1048576;
+  int rounds = 20;
+
+  for (int i = 1; i < argc - 1; ++i) {
+    if (strcmp(argv[i], "-rows") == 0) {
+      rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-rounds") == 0) {
+      rounds = atoi(argv[++i]);
+    }
+  }
+
+  taosResolveSIMD();
+
+  int failed = 0;
+  for (int type = TSDB_DATA_TYPE_TINYINT; type <= TSDB_DATA_TYPE_DOUBLE; ++type) {
+    char *data = benchGenerateBlock(type, rows);
+
+    // odd lengths leave a scalar tail, and a block full of NaN has no vector lane that can be taken
+    for (int len = rows - 7; len <= rows; len += 7) {
+      failed += !benchCheck(data, len, type);
+    }
+
+    double    min;
+    SBenchVal sum;
+    char      res[8];
+    int64_t   loopNs = 0, blockNs = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+      int64_t st = benchGetNanoTime();
+      benchLoopMin(data, rows, type, &min);
+      benchLoopSum(data, rows, type, &sum);
+      int64_t mid = benchGetNanoTime();
+      taosMinBlock(data, rows, type, res);
+      taosSumBlock(data, rows, type, &sum);
+      blockNs += benchGetNanoTime() - mid;
+      loopNs += mid - st;
+    }
+
+    printf("%-8s rows:%d  loop:%8.2fms  block:%8.2fms  speedup:%6.2f\n", typeName[type], rows,
+           loopNs / 1e6 / rounds, blockNs / 1e6 / rounds, (double)loopNs / blockNs);
+    free(data);
+  }
+
+  float nanBlock[33];
+  for (int i = 0; i < 33; ++i) nanBlock[i] = NAN;
+  nanBlock[3] = 1.5f;
+  nanBlock[20] = -2.5f;
+  failed += !benchCheck((char *)nanBlock, 33, TSDB_DATA_TYPE_FLOAT);
+
+  printf("%s\n", failed ? "FAILED" : "all results are matched");
+  return failed ? EXIT_FAILURE : 0;
+}
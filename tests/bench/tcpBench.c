@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// messages per second and round trip latency of the TCP server of the rpc module on loopback.
+// The server echoes every message back; each client connection sends one message and waits for its echo.
+// to compile: make, and run: ./tcpBench [-conns 64] [-threads 4] [-serverThreads 2] [-size 256] [-seconds 5]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "taosmsg.h"
+#include "ttcpserver.h"
+
+#define BENCH_PORT 16030
+#define BENCH_MAX_SAMPLES (1 << 20)
+
+typedef struct {
+  int      numOfConns;
+  int      size;
+  int *    fds;
+  int64_t  count;
+  int64_t *latency;  // sampled round trip time in us
+  int      numOfSamples;
+} SClientObj;
+
+static volatile bool stop = false;
+
+static int64_t benchGetMicroTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *benchProcessMsg(char *data, int dataLen, unsigned int ip, uint16_t port, void *shandle, void *thandle,
+                             void *chandle) {
+  if (data == NULL) return NULL;  // connection is closed
+
+  taosSendTcpServerData(ip, port, data, dataLen, chandle);
+  free(data);
+
+  return shandle;
+}
+
+static int benchRecvAll(int fd, char *buf, int len) {
+  int recvLen = 0;
+  while (recvLen < len) {
+    int ret = (int)recv(fd, buf + recvLen, (size_t)(len - recvLen), 0);
+    if (ret <= 0) return -1;
+    recvLen += ret;
+  }
+  return recvLen;
+}
+
+static int benchConnect() {
+  struct sockaddr_in addr;
+  int                fd = socket(AF_INET, SOCK_STREAM, 0);
+  int                on = 1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(BENCH_PORT);
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+  // the listening socket is opened by the accept thread of the server, so retry for a while
+  for (int i = 0; connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0; ++i) {
+    if (i == 100) {
+      close(fd);
+      return -1;
+    }
+    usleep(10000);
+  }
+
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  return fd;
+}
+
+// sends one message on each connection, then waits for all echoes, so the server sees many active connections
+static void *benchClient(void *param) {
+  SClientObj *pClient = (SClientObj *)param;
+  char *      msg = calloc(1, (size_t)pClient->size);
+  char *      buf = malloc((size_t)pClient->size);
+  int64_t *   sendTime = malloc(sizeof(int64_t) * pClient->numOfConns);
+
+  ((STaosHeader *)msg)->msgLen = (int32_t)htonl((uint32_t)pClient->size);
+
+  while (!stop) {
+    for (int i = 0; i < pClient->numOfConns; ++i) {
+      sendTime[i] = benchGetMicroTime();
+      send(pClient->fds[i], msg, (size_t)pClient->size, 0);
+    }
+
+    for (int i = 0; i < pClient->numOfConns; ++i) {
+      if (benchRecvAll(pClient->fds[i], buf, pClient->size) < 0) {
+        printf("failed to receive the echo\n");
+        exit(1);
+      }
+
+      if (pClient->numOfSamples < BENCH_MAX_SAMPLES) {
+        pClient->latency[pClient->numOfSamples++] = benchGetMicroTime() - sendTime[i];
+      }
+      pClient->count++;
+    }
+  }
+
+  free(sendTime);
+  free(buf);
+  free(msg);
+  return NULL;
+}
+
+static int benchCompare(const void *p1, const void *p2) {
+  int64_t v1 = *(int64_t *)p1, v2 = *(int64_t *)p2;
+  return (v1 < v2) ? -1 : (v1 > v2);
+}
+
+int main(int argc, char *argv[]) {
+  int numOfConns = 64;
+  int numOfThreads = 4;
+  int numOfServerThreads = 2;
+  int size = 256;
+  int seconds = 5;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-conns") == 0) {
+      numOfConns = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-threads") == 0) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-serverThreads") == 0) {
+      numOfServerThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-size") == 0) {
+      size = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-seconds") == 0) {
+      seconds = atoi(argv[++i]);
+    }
+  }
+
+  if (size < (int)sizeof(STaosHeader)) size = sizeof(STaosHeader);
+  if (numOfThreads > numOfConns) numOfThreads = numOfConns;
+
+  static int dummy;
+  void *     pServer = taosInitTcpServer("127.0.0.1", BENCH_PORT, "bench", numOfServerThreads, benchProcessMsg, &dummy);
+  if (pServer == NULL) {
+    printf("failed to start the TCP server\n");
+    return 1;
+  }
+
+  SClientObj *clients = calloc((size_t)numOfThreads, sizeof(SClientObj));
+  pthread_t * threads = malloc(sizeof(pthread_t) * numOfThreads);
+
+  for (int t = 0; t < numOfThreads; ++t) {
+    SClientObj *pClient = clients + t;
+    pClient->numOfConns = numOfConns / numOfThreads + (t < numOfConns % numOfThreads);
+    pClient->size = size;
+    pClient->fds = malloc(sizeof(int) * pClient->numOfConns);
+    pClient->latency = malloc(sizeof(int64_t) * BENCH_MAX_SAMPLES);
+    for (int i = 0; i < pClient->numOfConns; ++i) {
+      pClient->fds[i] = benchConnect();
+      if (pClient->fds[i] < 0) {
+        printf("failed to connect to the TCP server\n");
+        return 1;
+      }
+    }
+  }
+
+  int64_t st = benchGetMicroTime();
+  for (int t = 0; t < numOfThreads; ++t) pthread_create(threads + t, NULL, benchClient, clients + t);
+
+  sleep((unsigned int)seconds);
+  stop = true;
+
+  int64_t count = 0;
+  int     numOfSamples = 0;
+  for (int t = 0; t < numOfThreads; ++t) {
+    pthread_join(threads[t], NULL);
+    count += clients[t].count;
+    numOfSamples += clients[t].numOfSamples;
+  }
+  int64_t elapsed = benchGetMicroTime() - st;
+
+  int64_t *latency = malloc(sizeof(int64_t) * (numOfSamples + 1));
+  int      n = 0;
+  for (int t = 0; t < numOfThreads; ++t) {
+    memcpy(latency + n, clients[t].latency, sizeof(int64_t) * clients[t].numOfSamples);
+    n += clients[t].numOfSamples;
+  }
+  qsort(latency, (size_t)n, sizeof(int64_t), benchCompare);
+
+  printf("conns:%d clientThreads:%d serverThreads:%d size:%d  msgs/s:%.0f  p50:%ldus p99:%ldus p999:%ldus\n",
+         numOfConns, numOfThreads, numOfServerThreads, size, count * 1e6 / elapsed, latency[n / 2],
+         latency[(int64_t)n * 99 / 100], latency[(int64_t)n * 999 / 1000]);
+
+  for (int t = 0; t < numOfThreads; ++t) {
+    for (int i = 0; i < clients[t].numOfConns; ++i) close(clients[t].fds[i]);
+    free(clients[t].fds);
+    free(clients[t].latency);
+  }
+  free(latency);
+  free(threads);
+  free(clients);
+
+  taosCleanUpTcpServer(pServer);
+  return 0;
+}
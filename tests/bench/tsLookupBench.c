@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// cost of locating one key in a file block by its timestamp column, as vnodeSearchPointInFile does.
+// It compares decompressing the whole column (comp 1 and 2), copying the decompressed column out of the block
+// cache, and the best case of a sampled index every K rows, i.e. decompressing only the K rows around the key.
+// to compile: make, and run: ./tsLookupBench [-rows 4096] [-sample 128] [-blocks 256] [-lookups 200000]
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tscompression.h"
+#include "tsdb.h"
+
+#define BENCH_EXTRA_BYTES 2  // see EXTRA_BYTES in vnodeUtil.h
+
+typedef struct {
+  int64_t *keys;     // the timestamp column
+  char *   comp[3];  // the column compressed by comp 1 and 2, indexed by the comp level
+  int      compLen[3];
+  char *   chunk[3];  // the column compressed in chunks of K rows, what an index into the column would decode
+  int *    chunkLen[3];
+} SBlockData;
+
+static volatile int64_t sink;
+
+static int64_t benchGetNanoTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// the position of the first key not less than the given key
+static int benchSearchKey(const int64_t *keys, int num, int64_t key) {
+  int lo = 0, hi = num - 1;
+  while (lo < hi) {
+    int mid = (lo + hi) >> 1;
+    if (keys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+// one row per second, with a jitter of up to 10ms
+static void genTsJitter(int64_t *keys, int rows, int64_t blockId) {
+  int64_t start = 1500000000000L + blockId * rows * 1000L;
+  for (int i = 0; i < rows; ++i) keys[i] = start + i * 1000L + rand() % 10;
+}
+
+static int benchCompress(const int64_t *keys, int rows, char *output, int level, char *buffer, int bufferSize) {
+  int size = rows * TSDB_KEYSIZE;
+  if (level == ONE_STAGE_COMP) {
+    return tsCompressTimestamp((char *)keys, size, rows, output, size + BENCH_EXTRA_BYTES, ONE_STAGE_COMP, NULL, 0);
+  }
+
+  return tsCompressTimestamp((char *)keys, size, rows, output, size + BENCH_EXTRA_BYTES, TWO_STAGE_COMP, buffer,
+                             bufferSize);
+}
+
+static int benchDecompress(const char *input, int len, int rows, int64_t *keys, int level, char *buffer,
+                           int bufferSize) {
+  int size = rows * TSDB_KEYSIZE + BENCH_EXTRA_BYTES;
+  return tsDecompressTimestamp((char *)input, len, rows, (char *)keys, size, level, buffer, bufferSize);
+}
+
+int main(int argc, char *argv[]) {
+  int rows = 4096;
+  int sample = 128;
+  int blocks = 256;
+  int lookups = 200000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-rows") == 0) {
+      rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-sample") == 0) {
+      sample = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-blocks") == 0) {
+      blocks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-lookups") == 0) {
+      lookups = atoi(argv[++i]);
+    }
+  }
+
+  if (rows % sample != 0) {
+    printf("rows must be a multiple of the sample interval\n");
+    return 1;
+  }
+
+  int     maxSize = rows * TSDB_KEYSIZE + BENCH_EXTRA_BYTES;
+  int     numOfChunks = rows / sample;
+  char *  buffer = malloc(maxSize);
+  int64_t *keys = malloc(maxSize);
+
+  SBlockData *pData = calloc(blocks, sizeof(SBlockData));
+  for (int b = 0; b < blocks; ++b) {
+    SBlockData *p = pData + b;
+    p->keys = malloc(maxSize);
+    genTsJitter(p->keys, rows, b);
+
+    for (int level = ONE_STAGE_COMP; level <= TWO_STAGE_COMP; ++level) {
+      p->comp[level] = malloc(maxSize);
+      p->compLen[level] = benchCompress(p->keys, rows, p->comp[level], level, buffer, maxSize);
+
+      p->chunk[level] = malloc((size_t)numOfChunks * (sample * TSDB_KEYSIZE + BENCH_EXTRA_BYTES));
+      p->chunkLen[level] = malloc(numOfChunks * sizeof(int));
+      for (int c = 0; c < numOfChunks; ++c) {
+        char *out = p->chunk[level] + (size_t)c * (sample * TSDB_KEYSIZE + BENCH_EXTRA_BYTES);
+        p->chunkLen[level][c] = benchCompress(p->keys + c * sample, sample, out, level, buffer, maxSize);
+      }
+
+      benchDecompress(p->comp[level], p->compLen[level], rows, keys, level, buffer, maxSize);
+      if (memcmp(keys, p->keys, rows * TSDB_KEYSIZE) != 0) {
+        printf("comp %d of block %d does not round trip\n", level, b);
+        return 1;
+      }
+    }
+  }
+
+  // the keys to look up, inside the blocks so that the timestamp column has to be searched
+  int *    blockIdx = malloc(lookups * sizeof(int));
+  int64_t *lookupKeys = malloc(lookups * sizeof(int64_t));
+  for (int i = 0; i < lookups; ++i) {
+    blockIdx[i] = rand() % blocks;
+    lookupKeys[i] = pData[blockIdx[i]].keys[rand() % rows] + 1;
+  }
+
+  int chunkSize[3] = {0};
+  for (int level = ONE_STAGE_COMP; level <= TWO_STAGE_COMP; ++level) {
+    for (int c = 0; c < numOfChunks; ++c) chunkSize[level] += pData[0].chunkLen[level][c];
+  }
+
+  printf("rows:%d sample:%d blocks:%d lookups:%d\n", rows, sample, blocks, lookups);
+  printf("compressed Bytes per block: comp 1 %d, comp 2 %d, in chunks: comp 1 %d, comp 2 %d\n",
+         pData[0].compLen[ONE_STAGE_COMP], pData[0].compLen[TWO_STAGE_COMP], chunkSize[ONE_STAGE_COMP],
+         chunkSize[TWO_STAGE_COMP]);
+
+  for (int level = ONE_STAGE_COMP; level <= TWO_STAGE_COMP; ++level) {
+    int64_t st = benchGetNanoTime();
+    for (int i = 0; i < lookups; ++i) {
+      SBlockData *p = pData + blockIdx[i];
+      benchDecompress(p->comp[level], p->compLen[level], rows, keys, level, buffer, maxSize);
+      sink += benchSearchKey(keys, rows, lookupKeys[i]);
+    }
+
+    printf("decompress column, comp %d: %8.0f ns per lookup\n", level,
+           (double)(benchGetNanoTime() - st) / lookups);
+  }
+
+  int64_t st = benchGetNanoTime();
+  for (int i = 0; i < lookups; ++i) {
+    SBlockData *p = pData + blockIdx[i];
+    memcpy(keys, p->keys, rows * TSDB_KEYSIZE);
+    sink += benchSearchKey(keys, rows, lookupKeys[i]);
+  }
+
+  printf("copy from block cache:     %8.0f ns per lookup\n", (double)(benchGetNanoTime() - st) / lookups);
+
+  int64_t *samples = malloc(numOfChunks * sizeof(int64_t));
+  for (int level = ONE_STAGE_COMP; level <= TWO_STAGE_COMP; ++level) {
+    st = benchGetNanoTime();
+    for (int i = 0; i < lookups; ++i) {
+      SBlockData *p = pData + blockIdx[i];
+
+      // the index holds the first key of every chunk
+      for (int c = 0; c < numOfChunks; ++c) samples[c] = p->keys[c * sample];
+      int c = benchSearchKey(samples, numOfChunks, lookupKeys[i]);
+      if (c > 0 && samples[c] >= lookupKeys[i]) c--;
+
+      char *in = p->chunk[level] + (size_t)c * (sample * TSDB_KEYSIZE + BENCH_EXTRA_BYTES);
+      benchDecompress(in, p->chunkLen[level][c], sample, keys, level, buffer, maxSize);
+      sink += c * sample + benchSearchKey(keys, sample, lookupKeys[i]);
+    }
+
+    printf("sampled index, comp %d:     %8.0f ns per lookup\n", level, (double)(benchGetNanoTime() - st) / lookups);
+  }
+
+  return 0;
+}